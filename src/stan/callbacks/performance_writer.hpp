@@ -0,0 +1,40 @@
+#ifndef STAN_CALLBACKS_PERFORMANCE_WRITER_HPP
+#define STAN_CALLBACKS_PERFORMANCE_WRITER_HPP
+
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * <code>performance_writer</code> is a base class defining the
+ * interface for callbacks receiving performance counters (evaluation
+ * counts, integrator steps, time spent in each part of the run and
+ * memory use). The base class can be used as a no-op implementation.
+ */
+class performance_writer {
+ public:
+  /**
+   * Virtual destructor.
+   */
+  virtual ~performance_writer() {}
+
+  /**
+   * Writes a snapshot of the performance counters. The counters are
+   * cumulative from the start of the run.
+   *
+   * @param[in] phase name of the phase the snapshot was taken in,
+   *   either "warmup" or "sampling"
+   * @param[in] iteration number of iterations completed
+   * @param[in] names names of the counters
+   * @param[in] values values of the counters
+   */
+  virtual void operator()(const std::string& phase, int iteration,
+                          const std::vector<std::string>& names,
+                          const std::vector<double>& values) {}
+};
+
+}  // namespace callbacks
+}  // namespace stan
+#endif
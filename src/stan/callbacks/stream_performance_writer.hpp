@@ -0,0 +1,53 @@
+#ifndef STAN_CALLBACKS_STREAM_PERFORMANCE_WRITER_HPP
+#define STAN_CALLBACKS_STREAM_PERFORMANCE_WRITER_HPP
+
+#include <stan/callbacks/performance_writer.hpp>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace callbacks {
+
+/**
+ * <code>stream_performance_writer</code> is an implementation of
+ * <code>performance_writer</code> that writes each snapshot to a
+ * stream as a JSON object on a single line, e.g.
+ *
+ * <code>{"phase": "sampling", "iteration": 2000,
+ * "num_gradient_evals": 15872, ...}</code>
+ */
+class stream_performance_writer : public performance_writer {
+ public:
+  /**
+   * Constructs a stream performance writer with an output stream.
+   *
+   * @param[in, out] output stream to write
+   */
+  explicit stream_performance_writer(std::ostream& output)
+      : output_(output) {}
+
+  void operator()(const std::string& phase, int iteration,
+                  const std::vector<std::string>& names,
+                  const std::vector<double>& values) {
+    std::streamsize precision = output_.precision();
+    output_.precision(std::numeric_limits<double>::digits10);
+    output_ << "{\"phase\": \"" << phase << "\", \"iteration\": "
+            << iteration;
+    for (size_t n = 0; n < names.size() && n < values.size(); ++n)
+      output_ << ", \"" << names[n] << "\": " << values[n];
+    output_ << "}" << std::endl;
+    output_.precision(precision);
+  }
+
+ private:
+  /**
+   * Output stream
+   */
+  std::ostream& output_;
+};
+
+}  // namespace callbacks
+}  // namespace stan
+#endif
@@ -61,6 +61,10 @@ inline void print_stanc_help(std::ostream* out_stream) {
   print_help_option(out_stream, "allow_undefined", "",
                     "Do not fail if a function is declared but not defined");
 
+  print_help_option(out_stream, "profile", "",
+                    "Record the time spent in each statement of the "
+                    "transformed parameters and model blocks");
+
   print_help_option(out_stream, "include_paths", "comma-separated list",
                     "Comma-separated list of directories that may contain a "
                     "file in an #include directive");
@@ -243,6 +247,7 @@ inline int stanc_helper(int argc, const char* argv[], std::ostream* out_stream,
     }
 
     bool allow_undefined = cmd.has_flag("allow_undefined");
+    bool profile = cmd.has_flag("profile");
 
     bool valid_input = false;
 
@@ -281,7 +286,8 @@ inline int stanc_helper(int argc, const char* argv[], std::ostream* out_stream,
 
         valid_input
             = stan::lang::compile(err_stream, in, out, model_name,
-                                  allow_undefined, in_file_name, include_paths);
+                                  allow_undefined, in_file_name, include_paths,
+                                  profile);
         out.close();
         break;
       }
@@ -1,6 +1,7 @@
 #ifndef STAN_IO_ARRAY_VAR_CONTEXT_HPP
 #define STAN_IO_ARRAY_VAR_CONTEXT_HPP
 
+#include <stan/io/name_index.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/io/validate_dims.hpp>
 #include <stan/math.hpp>
@@ -36,6 +37,33 @@ class array_var_context : public var_context {
   const std::vector<double> empty_vec_r_;
   const std::vector<int> empty_vec_i_;
   const std::vector<size_t> empty_vec_ui_;
+  name_index<const data_pair_t<double>*> index_r_;
+  name_index<const data_pair_t<int>*> index_i_;
+
+  /**
+   * Indexes the variables by name. Called whenever variables are
+   * added or removed, since the index points into the maps.
+   */
+  void build_index() {
+    index_r_.clear();
+    index_r_.reserve(vars_r_.size());
+    for (const auto& var : vars_r_)
+      index_r_.insert(var.first, &var.second);
+    index_i_.clear();
+    index_i_.reserve(vars_i_.size());
+    for (const auto& var : vars_i_)
+      index_i_.insert(var.first, &var.second);
+  }
+
+  const data_pair_t<double>* find_r(const std::string& name) const {
+    auto var = index_r_.find(name);
+    return var == nullptr ? nullptr : *var;
+  }
+
+  const data_pair_t<int>* find_i(const std::string& name) const {
+    auto var = index_i_.find(name);
+    return var == nullptr ? nullptr : *var;
+  }
 
   /**
    * Search over the real variables to check if a name is in the map
@@ -43,7 +71,7 @@ class array_var_context : public var_context {
    * @return logical indicating if the variable was found in the map of reals.
    */
   bool contains_r_only(const std::string& name) const {
-    return vars_r_.find(name) != vars_r_.end();
+    return find_r(name) != nullptr;
   }
 
   /**
@@ -146,6 +174,19 @@ class array_var_context : public var_context {
   }
 
  public:
+  /**
+   * Copy the variables of another context. The index is rebuilt,
+   * as it points into the maps of the original.
+   *
+   * @param other context to copy
+   */
+  array_var_context(const array_var_context& other)
+      : var_context(other), vars_r_(other.vars_r_), vars_i_(other.vars_i_) {
+    build_index();
+  }
+
+  array_var_context(array_var_context&& other) = default;
+
   /**
    * Construct an array_var_context from only real value arrays.
    *
@@ -160,6 +201,7 @@ class array_var_context : public var_context {
                     const std::vector<double>& values_r,
                     const std::vector<std::vector<size_t>>& dim_r) {
     add_r(names_r, values_r, dim_r);
+    build_index();
   }
 
   /**
@@ -176,6 +218,7 @@ class array_var_context : public var_context {
                     const Eigen::VectorXd& values_r,
                     const std::vector<std::vector<size_t>>& dim_r) {
     add_r(names_r, values_r, dim_r);
+    build_index();
   }
 
   /**
@@ -192,6 +235,7 @@ class array_var_context : public var_context {
                     const std::vector<int>& values_i,
                     const std::vector<std::vector<size_t>>& dim_i) {
     add_i(names_i, values_i, dim_i);
+    build_index();
   }
 
   /**
@@ -216,6 +260,7 @@ class array_var_context : public var_context {
                     const std::vector<std::vector<size_t>>& dim_i) {
     add_i(names_i, values_i, dim_i);
     add_r(names_r, values_r, dim_r);
+    build_index();
   }
 
   /**
@@ -240,6 +285,7 @@ class array_var_context : public var_context {
                     const std::vector<std::vector<size_t>>& dim_i) {
     add_i(names_i, values_i, dim_i);
     add_r(names_r, values_r, dim_r);
+    build_index();
   }
 
   /**
@@ -263,7 +309,7 @@ class array_var_context : public var_context {
    * array value.
    */
   bool contains_i(const std::string& name) const {
-    return vars_i_.find(name) != vars_i_.end();
+    return find_i(name) != nullptr;
   }
 
   /**
@@ -275,13 +321,13 @@ class array_var_context : public var_context {
    *
    */
   std::vector<double> vals_r(const std::string& name) const {
-    const auto ret_val_r = vars_r_.find(name);
-    if (ret_val_r != vars_r_.end()) {
-      return ret_val_r->second.first;
+    const auto ret_val_r = find_r(name);
+    if (ret_val_r != nullptr) {
+      return ret_val_r->first;
     } else {
-      const auto ret_val_i = vars_i_.find(name);
-      if (ret_val_i != vars_i_.end()) {
-        return {ret_val_i->second.first.begin(), ret_val_i->second.first.end()};
+      const auto ret_val_i = find_i(name);
+      if (ret_val_i != nullptr) {
+        return {ret_val_i->first.begin(), ret_val_i->first.end()};
       }
     }
     return empty_vec_r_;
@@ -295,13 +341,13 @@ class array_var_context : public var_context {
    * @return Dimensions of variable.
    */
   std::vector<size_t> dims_r(const std::string& name) const {
-    const auto ret_val_r = vars_r_.find(name);
-    if (ret_val_r != vars_r_.end()) {
-      return ret_val_r->second.second;
+    const auto ret_val_r = find_r(name);
+    if (ret_val_r != nullptr) {
+      return ret_val_r->second;
     } else {
-      const auto ret_val_i = vars_i_.find(name);
-      if (ret_val_i != vars_i_.end()) {
-        return ret_val_i->second.second;
+      const auto ret_val_i = find_i(name);
+      if (ret_val_i != nullptr) {
+        return ret_val_i->second;
       }
     }
     return empty_vec_ui_;
@@ -315,9 +361,9 @@ class array_var_context : public var_context {
    * @return Values.
    */
   std::vector<int> vals_i(const std::string& name) const {
-    auto ret_val_i = vars_i_.find(name);
-    if (ret_val_i != vars_i_.end()) {
-      return ret_val_i->second.first;
+    auto ret_val_i = find_i(name);
+    if (ret_val_i != nullptr) {
+      return ret_val_i->first;
     }
     return empty_vec_i_;
   }
@@ -330,13 +376,72 @@ class array_var_context : public var_context {
    * @return Dimensions of variable.
    */
   std::vector<size_t> dims_i(const std::string& name) const {
-    auto ret_val_i = vars_i_.find(name);
-    if (ret_val_i != vars_i_.end()) {
-      return ret_val_i->second.second;
+    auto ret_val_i = find_i(name);
+    if (ret_val_i != nullptr) {
+      return ret_val_i->second;
     }
     return empty_vec_ui_;
   }
 
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name. The view of an integer variable owns a converted
+   * copy of its values.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the variable.
+   */
+  array_view<double> vals_r_view(const std::string& name) const {
+    const auto it_r = find_r(name);
+    if (it_r != nullptr)
+      return it_r->first;
+    if (contains_i(name))
+      return var_context::vals_r_view(name);
+    return array_view<double>();
+  }
+
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the variable.
+   */
+  array_view<int> vals_i_view(const std::string& name) const {
+    const auto it_i = find_i(name);
+    if (it_i != nullptr)
+      return it_i->first;
+    return array_view<int>();
+  }
+
+  /**
+   * Return a view of the dimensions for the double variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return View of the dimensions of the variable.
+   */
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    const auto it_r = find_r(name);
+    if (it_r != nullptr)
+      return it_r->second;
+    return dims_i_view(name);
+  }
+
+  /**
+   * Return a view of the dimensions for the integer variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return View of the dimensions of the variable.
+   */
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    const auto it_i = find_i(name);
+    if (it_i != nullptr)
+      return it_i->second;
+    return array_view<size_t>();
+  }
+
   /**
    * Check variable dimensions against variable declaration.
    * Only used for data read in from file.
@@ -390,7 +495,10 @@ class array_var_context : public var_context {
    *   returns <code>false</code>.
    */
   bool remove(const std::string& name) {
-    return (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    bool removed = (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    if (removed)
+      build_index();
+    return removed;
   }
 };
 }  // namespace io
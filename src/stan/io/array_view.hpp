@@ -0,0 +1,84 @@
+#ifndef STAN_IO_ARRAY_VIEW_HPP
+#define STAN_IO_ARRAY_VIEW_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * A read-only view of a contiguous sequence of values owned by
+ * another object, such as the values of a variable held by a
+ * <code>var_context</code>. A view does not copy the values and is
+ * valid only as long as the owner and its storage are.
+ *
+ * <p>A view constructed from a temporary vector owns the values
+ * instead, shared with its copies, for values that have no other
+ * owner, such as integers converted to floating point.
+ *
+ * @tparam T type of values
+ */
+template <typename T>
+class array_view {
+ public:
+  typedef T value_type;
+  typedef const T* const_iterator;
+
+  /**
+   * Construct an empty view.
+   */
+  array_view() : data_(nullptr), size_(0) {}
+
+  /**
+   * Construct a view of <code>size</code> values starting at
+   * <code>data</code>.
+   *
+   * @param[in] data pointer to the first value
+   * @param[in] size number of values
+   */
+  array_view(const T* data, size_t size) : data_(data), size_(size) {}
+
+  /**
+   * Construct a view of the values of a vector.
+   *
+   * @param[in] x vector
+   */
+  array_view(const std::vector<T>& x)  // NOLINT(runtime/explicit)
+      : data_(x.data()), size_(x.size()) {}
+
+  /**
+   * Construct a view owning the values of a temporary vector.
+   *
+   * @param[in] x vector, moved into the view
+   */
+  array_view(std::vector<T>&& x)  // NOLINT(runtime/explicit)
+      : owned_(std::make_shared<const std::vector<T>>(std::move(x))),
+        data_(owned_->data()),
+        size_(owned_->size()) {}
+
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T& operator[](size_t n) const { return data_[n]; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  /**
+   * Return a copy of the values.
+   *
+   * @return vector holding the values
+   */
+  std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+ private:
+  std::shared_ptr<const std::vector<T>> owned_;
+  const T* data_;
+  size_t size_;
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
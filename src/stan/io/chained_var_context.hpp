@@ -46,6 +46,26 @@ class chained_var_context : public var_context {
     return vc1_.contains_r(name) ? vc1_.dims_i(name) : vc2_.dims_i(name);
   }
 
+  array_view<double> vals_r_view(const std::string& name) const {
+    return vc1_.contains_r(name) ? vc1_.vals_r_view(name)
+                                 : vc2_.vals_r_view(name);
+  }
+
+  array_view<int> vals_i_view(const std::string& name) const {
+    return vc1_.contains_i(name) ? vc1_.vals_i_view(name)
+                                 : vc2_.vals_i_view(name);
+  }
+
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    return vc1_.contains_r(name) ? vc1_.dims_r_view(name)
+                                 : vc2_.dims_r_view(name);
+  }
+
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    return vc1_.contains_i(name) ? vc1_.dims_i_view(name)
+                                 : vc2_.dims_i_view(name);
+  }
+
   void names_r(std::vector<std::string>& names) const {
     vc1_.names_r(names);
     std::vector<std::string> names2;
@@ -1,11 +1,16 @@
 #ifndef STAN_IO_DUMP_HPP
 #define STAN_IO_DUMP_HPP
 
+#include <stan/io/parse_double.hpp>
 #include <stan/io/validate_zero_buf.hpp>
 #include <stan/io/validate_dims.hpp>
+#include <stan/io/name_index.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/math/prim.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -36,6 +41,10 @@ namespace io {
  * (i.e., undefined) values, because these cannot be
  * represented as <code>double</code> values.
  *
+ * <p>The reader scans blocks of the input stream held in memory and
+ * reads ahead of the variable it returns, so the stream should not
+ * be read by anything else while the reader is in use.
+ *
  * <p>The dump reader class follows a standard scanner pattern.
  * The method <code>next()</code> is called to scan the next
  * input.  The type, dimensions, and values of the input is then
@@ -116,15 +125,75 @@ class dump_reader {
   std::vector<double> stack_r_;
   std::vector<size_t> dims_;
   std::istream& in_;
+  std::string block_;
+  size_t offset_;
+  size_t pos_;
+  size_t end_;
+  size_t mark_;
+  size_t expected_size_;
+
+  static size_t block_size() { return 1 << 16; }
+  // number of characters read last that stay in the block when it is
+  // refilled, so that they can be scanned again after a failed get
+  static size_t history_size() { return 1 << 12; }
+  static size_t no_mark() { return static_cast<size_t>(-1); }
+
+  /**
+   * Reads the next block of the stream into the block, keeping the
+   * last characters read and everything from the mark set by a
+   * pending match on. Return false if the stream is exhausted.
+   */
+  bool fill() {
+    if (!in_.good())
+      return false;
+    size_t keep = std::min(pos_, history_size());
+    if (mark_ != no_mark())
+      keep = std::max(keep, offset_ + pos_ - mark_);
+    block_.erase(0, pos_ - keep);
+    offset_ += pos_ - keep;
+    end_ -= pos_ - keep;
+    pos_ = keep;
+    block_.resize(end_ + block_size());
+    in_.read(&block_[end_], block_size());
+    end_ += in_.gcount();
+    block_.resize(end_);
+    return pos_ < end_;
+  }
+
+  bool peek(char& c) {
+    if (pos_ == end_ && !fill())
+      return false;
+    c = block_[pos_];
+    return true;
+  }
+
+  bool get(char& c) {
+    if (!peek(c))
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  bool get_nonspace(char& c) {
+    while (get(c))
+      if (!std::isspace(c))
+        return true;
+    return false;
+  }
+
+  void unget(size_t n = 1) {
+    if (n > pos_)
+      throw std::invalid_argument("syntax error");
+    pos_ -= n;
+  }
 
   bool scan_single_char(char c_expected) {
-    int c = in_.peek();
-    if (in_.fail())
+    char c;
+    if (!peek(c))
       return false;
     if (c != c_expected)
       return false;
-    char c_skip;
-    in_.get(c_skip);
+    ++pos_;
     return true;
   }
 
@@ -139,11 +208,10 @@ class dump_reader {
 
   bool scan_char(char c_expected) {
     char c;
-    in_ >> c;
-    if (in_.fail())
+    if (!get_nonspace(c))
       return false;
     if (c != c_expected) {
-      in_.putback(c);
+      unget();
       return false;
     }
     return true;
@@ -151,17 +219,16 @@ class dump_reader {
 
   bool scan_name_unquoted() {
     char c;
-    in_ >> c;
-    if (in_.fail())
+    if (!get_nonspace(c))
       return false;
     if (!std::isalpha(c))
       return false;
     name_.push_back(c);
-    while (in_.get(c)) {  // get turns off auto space skip
+    while (get(c)) {  // get does not skip spaces
       if (std::isalpha(c) || std::isdigit(c) || c == '_' || c == '.') {
         name_.push_back(c);
       } else {
-        in_.putback(c);
+        unget();
         return true;
       }
     }
@@ -187,55 +254,37 @@ class dump_reader {
   }
 
   bool scan_chars(const char* s, bool case_sensitive = true) {
+    mark_ = offset_ + pos_;
     for (size_t i = 0; s[i]; ++i) {
       char c;
-      if (!(in_ >> c)) {
-        for (size_t j = 1; j < i; ++j)
-          in_.putback(s[i - j]);
-        return false;
-      }
+      bool matched = get_nonspace(c);
       // all ASCII, so toupper is OK
-      if ((case_sensitive && c != s[i])
-          || (!case_sensitive && ::toupper(c) != ::toupper(s[i]))) {
-        in_.putback(c);
-        for (size_t j = 1; j < i; ++j)
-          in_.putback(s[i - j]);
+      if (matched)
+        matched = case_sensitive ? c == s[i] : ::toupper(c) == ::toupper(s[i]);
+      if (!matched) {
+        unget(offset_ + pos_ - mark_);
+        mark_ = no_mark();
         return false;
       }
     }
+    mark_ = no_mark();
     return true;
   }
 
   bool scan_chars(std::string s, bool case_sensitive = true) {
-    for (size_t i = 0; i < s.size(); ++i) {
-      char c;
-      if (!(in_ >> c)) {
-        for (size_t j = 1; j < i; ++j)
-          in_.putback(s[i - j]);
-        return false;
-      }
-      // all ASCII, so toupper is OK
-      if ((case_sensitive && c != s[i])
-          || (!case_sensitive && ::toupper(c) != ::toupper(s[i]))) {
-        in_.putback(c);
-        for (size_t j = 1; j < i; ++j)
-          in_.putback(s[i - j]);
-        return false;
-      }
-    }
-    return true;
+    return scan_chars(s.c_str(), case_sensitive);
   }
 
   size_t scan_dim() {
     char c;
     buf_.clear();
-    while (in_.get(c)) {
+    while (get(c)) {
       if (std::isspace(c))
         continue;
       if (std::isdigit(c)) {
         buf_.push_back(c);
       } else {
-        in_.putback(c);
+        unget();
         break;
       }
     }
@@ -253,43 +302,92 @@ class dump_reader {
   int scan_int() {
     char c;
     buf_.clear();
-    while (in_.get(c)) {
+    while (get(c)) {
       if (std::isspace(c))
         continue;
       if (std::isdigit(c)) {
         buf_.push_back(c);
       } else {
-        in_.putback(c);
+        unget();
         break;
       }
     }
     return (get_int());
   }
 
+  // buf_ holds digits only
   int get_int() {
-    int n = 0;
-    try {
-      n = boost::lexical_cast<int>(buf_);
-    } catch (const boost::bad_lexical_cast& exc) {
+    long long n = 0;
+    bool valid = !buf_.empty();
+    for (size_t i = 0; valid && i < buf_.size(); ++i) {
+      n = 10 * n + (buf_[i] - '0');
+      valid = n <= std::numeric_limits<int>::max();
+    }
+    if (!valid) {
       std::string msg = "value " + buf_ + " beyond int range";
       throw std::invalid_argument(msg);
     }
-    return n;
+    return static_cast<int>(n);
   }
 
   double scan_double() {
     double x = 0;
-    try {
-      x = boost::lexical_cast<double>(buf_);
-      if (x == 0)
+    const char* end = buf_.data() + buf_.size();
+    bool valid = parse_double(buf_.data(), end, x) == end && !std::isinf(x);
+    if (valid && x == 0) {
+      try {
         validate_zero_buf(buf_);
-    } catch (const boost::bad_lexical_cast& exc) {
+      } catch (const boost::bad_lexical_cast& exc) {
+        valid = false;
+      }
+    }
+    if (!valid) {
       std::string msg = "value " + buf_ + " beyond numeric range";
       throw std::invalid_argument(msg);
     }
     return x;
   }
 
+  /**
+   * Reads the characters of a number into <code>buf_</code>,
+   * scanning the block directly. Return true if the number has a
+   * decimal point, an exponent or a sign, that is, if it is not an
+   * integer.
+   */
+  bool scan_number_chars() {
+    bool is_double = false;
+    buf_.clear();
+    while (pos_ < end_ || fill()) {
+      size_t start = pos_;
+      for (; pos_ < end_; ++pos_) {
+        char c = block_[pos_];
+        if (c >= '0' && c <= '9')
+          continue;
+        if (c == '.' || c == 'e' || c == 'E' || c == '-' || c == '+')
+          is_double = true;
+        else
+          break;
+      }
+      buf_.append(block_, start, pos_ - start);
+      if (pos_ < end_)
+        break;
+    }
+    return is_double;
+  }
+
+  /**
+   * Returns the number of values of the sequence that starts at the
+   * current position, counting up to the closing parenthesis if it
+   * is in the block. Used to reserve memory for the values.
+   */
+  size_t expected_seq_size() const {
+    const char* p = block_.data() + pos_;
+    const char* end = block_.data() + end_;
+    const char* close
+        = static_cast<const char*>(std::memchr(p, ')', end - p));
+    return std::count(p, close == nullptr ? end : close, ',') + 1;
+  }
+
   // scan number stores number or throws bad lexical cast exception
   void scan_number(bool negate_val) {
     // must take longest first!
@@ -304,27 +402,17 @@ class dump_reader {
       return;
     }
 
-    char c;
-    bool is_double = false;
-    buf_.clear();
-    while (in_.get(c)) {
-      if (std::isdigit(c)) {  // before pre-scan || c == '-' || c == '+') {
-        buf_.push_back(c);
-      } else if (c == '.' || c == 'e' || c == 'E' || c == '-' || c == '+') {
-        is_double = true;
-        buf_.push_back(c);
-      } else {
-        in_.putback(c);
-        break;
-      }
-    }
+    bool is_double = scan_number_chars();
     if (!is_double && stack_r_.size() == 0) {
       int n = get_int();
+      if (stack_i_.empty())
+        stack_i_.reserve(expected_size_);
       stack_i_.push_back(negate_val ? -n : n);
       scan_optional_long();
     } else {
-      for (size_t j = 0; j < stack_i_.size(); ++j)
-        stack_r_.push_back(static_cast<double>(stack_i_[j]));
+      if (stack_r_.empty())
+        stack_r_.reserve(std::max(expected_size_, stack_i_.size() + 1));
+      stack_r_.insert(stack_r_.end(), stack_i_.begin(), stack_i_.end());
       stack_i_.clear();
       double x = scan_double();
       stack_r_.push_back(negate_val ? -x : x);
@@ -333,10 +421,10 @@ class dump_reader {
 
   void scan_number() {
     char c;
-    while (in_.get(c)) {
+    while (get(c)) {
       if (std::isspace(c))
         continue;
-      in_.putback(c);
+      unget();
       break;
     }
     bool negate_val = scan_char('-');
@@ -355,9 +443,7 @@ class dump_reader {
     int s = scan_int();
     if (s < 0)
       return false;
-    for (int i = 0; i < s; ++i) {
-      stack_i_.push_back(0);
-    }
+    stack_i_.assign(s, 0);
     if (!scan_char(')'))
       return false;
     dims_.push_back(s);
@@ -374,9 +460,7 @@ class dump_reader {
     int s = scan_int();
     if (s < 0)
       return false;
-    for (int i = 0; i < s; ++i) {
-      stack_r_.push_back(0);
-    }
+    stack_r_.assign(s, 0);
     if (!scan_char(')'))
       return false;
     dims_.push_back(s);
@@ -390,6 +474,7 @@ class dump_reader {
       dims_.push_back(0U);
       return true;
     }
+    expected_size_ = expected_seq_size();
     scan_number();  // first entry
     while (scan_char(',')) {
       scan_number();
@@ -495,7 +580,12 @@ class dump_reader {
    *
    * @param in Input stream reference from which to read.
    */
-  explicit dump_reader(std::istream& in) : in_(in) {}
+  explicit dump_reader(std::istream& in)
+      : in_(in), offset_(0),
+        pos_(0),
+        end_(0),
+        mark_(no_mark()),
+        expected_size_(0) {}
 
   /**
    * Destroy this reader.
@@ -546,6 +636,23 @@ class dump_reader {
    */
   std::vector<double> double_values() { return stack_r_; }
 
+  /**
+   * Moves the integer values of the last item out of the reader.
+   * The reader holds no values afterwards.
+   *
+   * @return Integer values of last item.
+   */
+  std::vector<int> release_int_values() { return std::move(stack_i_); }
+
+  /**
+   * Moves the floating point values of the last item out of the
+   * reader. The reader holds no values afterwards, so
+   * <code>is_int()</code> is only meaningful before the call.
+   *
+   * @return Floating point values of last item.
+   */
+  std::vector<double> release_double_values() { return std::move(stack_r_); }
+
   /**
    * Read the next value from the input stream, returning
    * <code>true</code> if successful and <code>false</code> if no
@@ -558,6 +665,7 @@ class dump_reader {
     stack_r_.clear();
     stack_i_.clear();
     dims_.clear();
+    expected_size_ = 0;
     name_.erase();
     if (!scan_name())  // set name
       return false;
@@ -603,6 +711,36 @@ class dump : public stan::io::var_context {
   std::vector<double> const empty_vec_r_;
   std::vector<int> const empty_vec_i_;
   std::vector<size_t> const empty_vec_ui_;
+  typedef std::pair<std::vector<double>, std::vector<size_t> > var_r_t;
+  typedef std::pair<std::vector<int>, std::vector<size_t> > var_i_t;
+  name_index<const var_r_t*> index_r_;
+  name_index<const var_i_t*> index_i_;
+
+  /**
+   * Indexes the variables by name. Called whenever variables are
+   * added or removed, since the index points into the maps.
+   */
+  void build_index() {
+    index_r_.clear();
+    index_r_.reserve(vars_r_.size());
+    for (const auto& var : vars_r_)
+      index_r_.insert(var.first, &var.second);
+    index_i_.clear();
+    index_i_.reserve(vars_i_.size());
+    for (const auto& var : vars_i_)
+      index_i_.insert(var.first, &var.second);
+  }
+
+  const var_r_t* find_r(const std::string& name) const {
+    auto var = index_r_.find(name);
+    return var == nullptr ? nullptr : *var;
+  }
+
+  const var_i_t* find_i(const std::string& name) const {
+    auto var = index_i_.find(name);
+    return var == nullptr ? nullptr : *var;
+  }
+
   /**
    * Return <code>true</code> if this dump contains the specified
    * variable name is defined in the real values. This method
@@ -613,7 +751,7 @@ class dump : public stan::io::var_context {
    * real values of the dump.
    */
   bool contains_r_only(const std::string& name) const {
-    return vars_r_.find(name) != vars_r_.end();
+    return find_r(name) != nullptr;
   }
 
  public:
@@ -630,16 +768,30 @@ class dump : public stan::io::var_context {
       if (reader.is_int()) {
         vars_i_[reader.name()]
             = std::pair<std::vector<int>, std::vector<size_t> >(
-                reader.int_values(), reader.dims());
+                reader.release_int_values(), reader.dims());
 
       } else {
         vars_r_[reader.name()]
             = std::pair<std::vector<double>, std::vector<size_t> >(
-                reader.double_values(), reader.dims());
+                reader.release_double_values(), reader.dims());
       }
     }
+    build_index();
+  }
+
+  /**
+   * Copy the variables of another dump. The index is rebuilt, as it
+   * points into the maps of the original.
+   *
+   * @param other dump to copy
+   */
+  dump(const dump& other)
+      : var_context(other), vars_r_(other.vars_r_), vars_i_(other.vars_i_) {
+    build_index();
   }
 
+  dump(dump&& other) = default;
+
   /**
    * Return <code>true</code> if this dump contains the specified
    * variable name is defined. This method returns <code>true</code>
@@ -661,7 +813,7 @@ class dump : public stan::io::var_context {
    * array value.
    */
   bool contains_i(const std::string& name) const {
-    return vars_i_.find(name) != vars_i_.end();
+    return find_i(name) != nullptr;
   }
 
   /**
@@ -673,9 +825,9 @@ class dump : public stan::io::var_context {
    */
   std::vector<double> vals_r(const std::string& name) const {
     if (contains_r_only(name)) {
-      return (vars_r_.find(name)->second).first;
+      return find_r(name)->first;
     } else if (contains_i(name)) {
-      std::vector<int> vec_int = (vars_i_.find(name)->second).first;
+      std::vector<int> vec_int = find_i(name)->first;
       std::vector<double> vec_r(vec_int.size());
       for (size_t ii = 0; ii < vec_int.size(); ii++) {
         vec_r[ii] = vec_int[ii];
@@ -694,9 +846,9 @@ class dump : public stan::io::var_context {
    */
   std::vector<size_t> dims_r(const std::string& name) const {
     if (contains_r_only(name)) {
-      return (vars_r_.find(name)->second).second;
+      return find_r(name)->second;
     } else if (contains_i(name)) {
-      return (vars_i_.find(name)->second).second;
+      return find_i(name)->second;
     }
     return empty_vec_ui_;
   }
@@ -710,7 +862,7 @@ class dump : public stan::io::var_context {
    */
   std::vector<int> vals_i(const std::string& name) const {
     if (contains_i(name)) {
-      return (vars_i_.find(name)->second).first;
+      return find_i(name)->first;
     }
     return empty_vec_i_;
   }
@@ -724,11 +876,70 @@ class dump : public stan::io::var_context {
    */
   std::vector<size_t> dims_i(const std::string& name) const {
     if (contains_i(name)) {
-      return (vars_i_.find(name)->second).second;
+      return find_i(name)->second;
     }
     return empty_vec_ui_;
   }
 
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name. The view of an integer variable owns a converted
+   * copy of its values.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the variable.
+   */
+  array_view<double> vals_r_view(const std::string& name) const {
+    const auto it_r = find_r(name);
+    if (it_r != nullptr)
+      return it_r->first;
+    if (contains_i(name))
+      return var_context::vals_r_view(name);
+    return array_view<double>();
+  }
+
+  /**
+   * Return a view of the integer values for the variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the variable.
+   */
+  array_view<int> vals_i_view(const std::string& name) const {
+    const auto it_i = find_i(name);
+    if (it_i != nullptr)
+      return it_i->first;
+    return array_view<int>();
+  }
+
+  /**
+   * Return a view of the dimensions for the double variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return View of the dimensions of the variable.
+   */
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    const auto it_r = find_r(name);
+    if (it_r != nullptr)
+      return it_r->second;
+    return dims_i_view(name);
+  }
+
+  /**
+   * Return a view of the dimensions for the integer variable with the
+   * specified name.
+   *
+   * @param name Name of variable.
+   * @return View of the dimensions of the variable.
+   */
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    const auto it_i = find_i(name);
+    if (it_i != nullptr)
+      return it_i->second;
+    return array_view<size_t>();
+  }
+
   /**
    * Return a list of the names of the floating point variables in
    * the dump.
@@ -785,7 +996,10 @@ class dump : public stan::io::var_context {
    *   returns <code>false</code>.
    */
   bool remove(const std::string& name) {
-    return (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    bool removed = (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    if (removed)
+      build_index();
+    return removed;
   }
 };
 
@@ -0,0 +1,51 @@
+#ifndef STAN_IO_DUMP_TO_MMAP_VAR_CONTEXT_HPP
+#define STAN_IO_DUMP_TO_MMAP_VAR_CONTEXT_HPP
+
+#include <stan/io/dump.hpp>
+#include <stan/io/mmap_var_context.hpp>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+namespace io {
+
+/**
+ * Converts data in R dump format to the binary format read by
+ * <code>mmap_var_context</code>. Integer variables stay integers.
+ *
+ * @param[in,out] in stream of R dump data
+ * @param[in,out] out stream for the binary data, opened in binary mode
+ * @throw std::runtime_error if the dump data cannot be parsed or
+ *   writing fails
+ */
+inline void dump_to_mmap_var_context(std::istream& in, std::ostream& out) {
+  stan::io::dump context(in);
+  write_mmap_var_context(context, out);
+}
+
+/**
+ * Converts an R dump file to a binary data file that can be read
+ * with <code>mmap_var_context</code>.
+ *
+ * @param[in] dump_path path of the R dump file
+ * @param[in] path path of the binary data file to write
+ * @throw std::runtime_error if a file cannot be opened, the dump data
+ *   cannot be parsed or writing fails
+ */
+inline void dump_to_mmap_var_context(const std::string& dump_path,
+                                     const std::string& path) {
+  std::ifstream in(dump_path);
+  if (!in)
+    throw std::runtime_error("Cannot open dump file " + dump_path);
+  std::ofstream out(path, std::ios::binary);
+  if (!out)
+    throw std::runtime_error("Cannot open binary data file " + path);
+  dump_to_mmap_var_context(in, out);
+}
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -79,6 +79,46 @@ class empty_var_context : public var_context {
     return std::vector<size_t>();
   }
 
+  /**
+   * Always returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  array_view<double> vals_r_view(const std::string& name) const {
+    return array_view<double>();
+  }
+
+  /**
+   * Always returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  array_view<int> vals_i_view(const std::string& name) const {
+    return array_view<int>();
+  }
+
+  /**
+   * Always returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    return array_view<size_t>();
+  }
+
+  /**
+   * Always returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    return array_view<size_t>();
+  }
+
   /**
    * Check variable dimensions against variable declaration.
    * This context has no variables.
@@ -0,0 +1,408 @@
+#ifndef STAN_IO_JSON_PARSER_HPP
+#define STAN_IO_JSON_PARSER_HPP
+
+#include <stan/io/parse_double.hpp>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * A streaming (SAX) parser for JSON text. The parser reads the
+ * stream in blocks and reports each value to a handler as it is
+ * read, so no document tree is built.
+ *
+ * <p>The handler must provide the member functions
+ * <ul>
+ * <li><code>start_object()</code>, <code>key(const std::string&)</code>
+ *   and <code>end_object()</code>,</li>
+ * <li><code>start_array()</code> and <code>end_array()</code>,</li>
+ * <li><code>integer(int64_t)</code> for numbers without a fraction or
+ *   exponent that fit into 64 bits,</li>
+ * <li><code>real(double)</code> for all other numbers,</li>
+ * <li><code>string(const std::string&)</code>,
+ *   <code>boolean(bool)</code> and <code>null()</code>.</li>
+ * </ul>
+ * Handlers signal errors by throwing.
+ *
+ * <p>Besides standard JSON, the literals <code>NaN</code>,
+ * <code>Infinity</code> and <code>-Infinity</code> are accepted as
+ * real values.
+ */
+class json_parser {
+ public:
+  /**
+   * Construct a parser reading from the specified stream.
+   *
+   * <b>Warning:</b> The stream is not closed by the parser.
+   *
+   * @param in input stream
+   */
+  explicit json_parser(std::istream& in)
+      : in_(in), block_(block_size(), '\0'), pos_(0), end_(0), line_(1) {}
+
+  /**
+   * Parses a single JSON value, which must be followed only by
+   * whitespace, and reports it to the handler.
+   *
+   * @tparam Handler type of handler
+   * @param[in,out] handler handler receiving the values
+   * @throw std::invalid_argument if the text is not valid JSON
+   */
+  template <class Handler>
+  void parse(Handler& handler) {
+    skip_space();
+    parse_value(handler, 0);
+    skip_space();
+    if (peek() != eof())
+      error("unexpected characters after JSON value");
+  }
+
+ private:
+  std::istream& in_;
+  std::string block_;
+  size_t pos_;
+  size_t end_;
+  size_t line_;
+  std::string token_;
+
+  static size_t block_size() { return 1 << 16; }
+  static size_t max_depth() { return 512; }
+  static int eof() { return -1; }
+
+  [[noreturn]] void error(const std::string& what) const {
+    std::stringstream msg;
+    msg << "JSON syntax error at line " << line_ << ": " << what;
+    throw std::invalid_argument(msg.str());
+  }
+
+  bool fill() {
+    if (!in_.good())
+      return false;
+    in_.read(&block_[0], block_.size());
+    pos_ = 0;
+    end_ = static_cast<size_t>(in_.gcount());
+    return end_ > 0;
+  }
+
+  int peek() {
+    if (pos_ == end_ && !fill())
+      return eof();
+    return static_cast<unsigned char>(block_[pos_]);
+  }
+
+  int get() {
+    int c = peek();
+    if (c != eof())
+      ++pos_;
+    return c;
+  }
+
+  void skip_space() {
+    for (;;) {
+      for (; pos_ < end_; ++pos_) {
+        char c = block_[pos_];
+        if (c == '\n')
+          ++line_;
+        else if (c != ' ' && c != '\t' && c != '\r')
+          return;
+      }
+      if (!fill())
+        return;
+    }
+  }
+
+  void expect(char c) {
+    if (get() != c)
+      error(std::string("expected '") + c + "'");
+  }
+
+  void expect_word(const char* word) {
+    for (; *word != '\0'; ++word)
+      if (get() != *word)
+        error("invalid literal");
+  }
+
+  template <class Handler>
+  void parse_value(Handler& handler, size_t depth) {
+    if (depth > max_depth())
+      error("values nested too deeply");
+    switch (peek()) {
+      case '{':
+        parse_object(handler, depth);
+        break;
+      case '[':
+        parse_array(handler, depth);
+        break;
+      case '"':
+        parse_string();
+        handler.string(token_);
+        break;
+      case 't':
+        expect_word("true");
+        handler.boolean(true);
+        break;
+      case 'f':
+        expect_word("false");
+        handler.boolean(false);
+        break;
+      case 'n':
+        expect_word("null");
+        handler.null();
+        break;
+      case 'N':
+        expect_word("NaN");
+        handler.real(std::numeric_limits<double>::quiet_NaN());
+        break;
+      case 'I':
+        expect_word("Infinity");
+        handler.real(std::numeric_limits<double>::infinity());
+        break;
+      case -1:
+        error("unexpected end of input");
+      default:
+        parse_number(handler);
+    }
+  }
+
+  template <class Handler>
+  void parse_object(Handler& handler, size_t depth) {
+    expect('{');
+    handler.start_object();
+    skip_space();
+    if (peek() == '}') {
+      get();
+      handler.end_object();
+      return;
+    }
+    for (;;) {
+      skip_space();
+      if (peek() != '"')
+        error("expected string as object key");
+      parse_string();
+      handler.key(token_);
+      skip_space();
+      expect(':');
+      skip_space();
+      parse_value(handler, depth + 1);
+      skip_space();
+      int c = get();
+      if (c == '}')
+        break;
+      if (c != ',')
+        error("expected ',' or '}' in object");
+    }
+    handler.end_object();
+  }
+
+  template <class Handler>
+  void parse_array(Handler& handler, size_t depth) {
+    expect('[');
+    handler.start_array();
+    skip_space();
+    if (peek() == ']') {
+      get();
+      handler.end_array();
+      return;
+    }
+    for (;;) {
+      skip_space();
+      parse_value(handler, depth + 1);
+      skip_space();
+      int c = get();
+      if (c == ']')
+        break;
+      if (c != ',')
+        error("expected ',' or ']' in array");
+    }
+    handler.end_array();
+  }
+
+  /**
+   * Reads the four hexadecimal digits of a <code>\\u</code> escape.
+   */
+  unsigned int parse_hex4() {
+    unsigned int code = 0;
+    for (int n = 0; n < 4; ++n) {
+      int c = get();
+      code <<= 4;
+      if (c >= '0' && c <= '9')
+        code |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        code |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        code |= c - 'A' + 10;
+      else
+        error("invalid unicode escape");
+    }
+    return code;
+  }
+
+  void append_utf8(unsigned int code) {
+    if (code < 0x80) {
+      token_ += static_cast<char>(code);
+    } else if (code < 0x800) {
+      token_ += static_cast<char>(0xC0 | (code >> 6));
+      token_ += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      token_ += static_cast<char>(0xE0 | (code >> 12));
+      token_ += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      token_ += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      token_ += static_cast<char>(0xF0 | (code >> 18));
+      token_ += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      token_ += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      token_ += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  /**
+   * Reads a string into the token, resolving escapes.
+   */
+  void parse_string() {
+    expect('"');
+    token_.clear();
+    for (;;) {
+      if (pos_ == end_ && !fill())
+        error("unterminated string");
+      size_t start = pos_;
+      while (pos_ < end_ && block_[pos_] != '"' && block_[pos_] != '\\'
+             && static_cast<unsigned char>(block_[pos_]) >= 0x20)
+        ++pos_;
+      token_.append(block_, start, pos_ - start);
+      if (pos_ == end_)
+        continue;
+      int c = get();
+      if (c == '"')
+        return;
+      if (c != '\\')
+        error("control character in string");
+      c = get();
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          token_ += static_cast<char>(c);
+          break;
+        case 'b':
+          token_ += '\b';
+          break;
+        case 'f':
+          token_ += '\f';
+          break;
+        case 'n':
+          token_ += '\n';
+          break;
+        case 'r':
+          token_ += '\r';
+          break;
+        case 't':
+          token_ += '\t';
+          break;
+        case 'u': {
+          unsigned int code = parse_hex4();
+          if (code >= 0xD800 && code < 0xDC00) {
+            if (get() != '\\' || get() != 'u')
+              error("invalid unicode surrogate pair");
+            unsigned int low = parse_hex4();
+            if (low < 0xDC00 || low >= 0xE000)
+              error("invalid unicode surrogate pair");
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          append_utf8(code);
+          break;
+        }
+        default:
+          error("invalid escape in string");
+      }
+    }
+  }
+
+  static const char* skip_digits(const char* p, const char* end) {
+    while (p != end && *p >= '0' && *p <= '9')
+      ++p;
+    return p;
+  }
+
+  /**
+   * Return true if the characters after an optional minus sign follow
+   * the JSON grammar for numbers: an integer part without leading
+   * zeros, then optionally a fraction and an exponent, each with at
+   * least one digit. Rejects forms <code>parse_double</code> would
+   * accept, such as <code>1.</code> and <code>1.e5</code>.
+   */
+  static bool is_json_number(const char* p, const char* end) {
+    const char* q = skip_digits(p, end);
+    if (q == p || (*p == '0' && q - p > 1))
+      return false;
+    if (q != end && *q == '.') {
+      p = q + 1;
+      q = skip_digits(p, end);
+      if (q == p)
+        return false;
+    }
+    if (q != end && (*q == 'e' || *q == 'E')) {
+      p = q + 1;
+      if (p != end && (*p == '+' || *p == '-'))
+        ++p;
+      q = skip_digits(p, end);
+      if (q == p)
+        return false;
+    }
+    return q == end;
+  }
+
+  /**
+   * Reads a number and reports it as an integer if it has no
+   * fraction or exponent and fits into 64 bits, as a real otherwise.
+   */
+  template <class Handler>
+  void parse_number(Handler& handler) {
+    token_.clear();
+    bool integral = true;
+    for (;;) {
+      if (pos_ == end_ && !fill())
+        break;
+      char c = block_[pos_];
+      if (c >= '0' && c <= '9') {
+      } else if (c == '.' || c == 'e' || c == 'E') {
+        integral = false;
+      } else if (c != '-' && c != '+') {
+        break;
+      }
+      token_ += c;
+      ++pos_;
+    }
+    if (token_ == "-" && peek() == 'I') {
+      expect_word("Infinity");
+      handler.real(-std::numeric_limits<double>::infinity());
+      return;
+    }
+    const char* begin = token_.data();
+    const char* end = begin + token_.size();
+    const char* digits = begin + (token_[0] == '-');
+    if (!is_json_number(digits, end))
+      error("invalid number");
+    if (integral && end - digits <= 18) {
+      int64_t x = 0;
+      for (const char* p = digits; p != end; ++p)
+        x = 10 * x + (*p - '0');
+      handler.integer(digits == begin ? x : -x);
+      return;
+    }
+    double x;
+    if (parse_double(begin, end, x) != end)
+      error("invalid number");
+    handler.real(x);
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
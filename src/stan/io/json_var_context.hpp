@@ -0,0 +1,481 @@
+#ifndef STAN_IO_JSON_VAR_CONTEXT_HPP
+#define STAN_IO_JSON_VAR_CONTEXT_HPP
+
+#include <stan/io/var_context.hpp>
+#include <stan/io/json_parser.hpp>
+#include <stan/io/name_index.hpp>
+#include <stan/io/validate_dims.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * Handler for <code>json_parser</code> that reads the variables of a
+ * JSON data object.
+ *
+ * <p>The data must be a single object whose members are the
+ * variables. A variable is a number or a rectangular array of nested
+ * arrays of numbers; the strings <code>"NaN"</code>,
+ * <code>"Inf"</code>, <code>"-Inf"</code>, <code>"Infinity"</code>
+ * and <code>"-Infinity"</code> are read as the corresponding reals.
+ * The dimensions are the lengths of the nested arrays, outermost
+ * first, and the values are stored in column-major order like those
+ * of <code>dump</code>.
+ *
+ * <p>Numbers are written straight into a typed buffer as they are
+ * parsed. A variable is integer until its first number that is not an
+ * integer or out of the range of <code>int</code>, at which point the
+ * values read so far are converted to reals once.
+ *
+ * <p>Once the first element of the outermost array of a
+ * multidimensional variable is read, the inner dimensions are known
+ * and each later number is written at its column-major offset. The
+ * length of the outermost array is known only at its end, so the
+ * buffer holds room for a capacity of outer elements per inner
+ * offset, doubled as needed, and is compacted in place at the end.
+ */
+class json_data_handler {
+ public:
+  typedef std::pair<std::vector<double>, std::vector<size_t> > var_r_t;
+  typedef std::pair<std::vector<int>, std::vector<size_t> > var_i_t;
+
+  json_data_handler(std::map<std::string, var_r_t>& vars_r,
+                    std::map<std::string, var_i_t>& vars_i)
+      : vars_r_(vars_r), vars_i_(vars_i), object_depth_(0), in_var_(false) {}
+
+  void start_object() {
+    if (object_depth_ > 0)
+      error("nested objects are not supported");
+    ++object_depth_;
+  }
+
+  void end_object() { --object_depth_; }
+
+  void key(const std::string& name) {
+    if (vars_r_.count(name) > 0 || vars_i_.count(name) > 0)
+      throw std::invalid_argument("JSON data: duplicate variable " + name);
+    name_ = name;
+    is_int_ = true;
+    ints_.clear();
+    reals_.clear();
+    counts_.clear();
+    shape_.clear();
+    leaf_depth_ = unknown();
+    inner_strides_.clear();
+    outer_capacity_ = 0;
+    in_var_ = true;
+  }
+
+  void start_array() {
+    check_value();
+    size_t depth = counts_.size();
+    if (leaf_depth_ != unknown() && depth >= leaf_depth_)
+      error("arrays must be rectangular");
+    if (depth > 0)
+      ++counts_.back();
+    counts_.push_back(0);
+    if (shape_.size() <= depth)
+      shape_.push_back(unknown());
+  }
+
+  void end_array() {
+    size_t depth = counts_.size() - 1;
+    size_t n = counts_.back();
+    counts_.pop_back();
+    if (n == 0) {
+      if (leaf_depth_ == unknown())
+        leaf_depth_ = depth + 1;
+      else if (leaf_depth_ != depth + 1)
+        error("arrays must be rectangular");
+    }
+    if (shape_[depth] == unknown())
+      shape_[depth] = n;
+    else if (shape_[depth] != n)
+      error("arrays must be rectangular");
+    if (depth == 1 && outer_capacity_ == 0) {
+      if (is_int_)
+        start_column_major(ints_);
+      else
+        start_column_major(reals_);
+    }
+    if (depth == 0)
+      finish_var();
+  }
+
+  void integer(int64_t x) {
+    if (is_int_ && x >= std::numeric_limits<int>::min()
+        && x <= std::numeric_limits<int>::max()) {
+      add_leaf();
+      add_value(ints_, static_cast<int>(x));
+      if (counts_.empty())
+        finish_var();
+    } else {
+      real(static_cast<double>(x));
+    }
+  }
+
+  void real(double x) {
+    add_leaf();
+    if (is_int_) {
+      reals_.assign(ints_.begin(), ints_.end());
+      ints_.clear();
+      is_int_ = false;
+    }
+    add_value(reals_, x);
+    if (counts_.empty())
+      finish_var();
+  }
+
+  void string(const std::string& s) {
+    if (s == "NaN")
+      real(std::numeric_limits<double>::quiet_NaN());
+    else if (s == "Inf" || s == "Infinity")
+      real(std::numeric_limits<double>::infinity());
+    else if (s == "-Inf" || s == "-Infinity")
+      real(-std::numeric_limits<double>::infinity());
+    else
+      error("string values are not supported");
+  }
+
+  void boolean(bool) { error("boolean values are not supported"); }
+
+  void null() { error("null values are not supported"); }
+
+ private:
+  std::map<std::string, var_r_t>& vars_r_;
+  std::map<std::string, var_i_t>& vars_i_;
+  size_t object_depth_;
+  bool in_var_;
+  std::string name_;
+  bool is_int_;
+  std::vector<int> ints_;
+  std::vector<double> reals_;
+  // number of elements read so far of each open array
+  std::vector<size_t> counts_;
+  // length of the arrays at each depth
+  std::vector<size_t> shape_;
+  // depth of the numbers inside arrays
+  size_t leaf_depth_;
+  // column-major strides of the inner dimensions, from the second
+  std::vector<size_t> inner_strides_;
+  // outer elements with room in the buffer, 0 before the first ends
+  size_t outer_capacity_;
+
+  static size_t unknown() { return std::numeric_limits<size_t>::max(); }
+
+  [[noreturn]] void error(const std::string& what) const {
+    std::string msg = "JSON data: ";
+    if (in_var_)
+      msg += "variable " + name_ + ": ";
+    throw std::invalid_argument(msg + what);
+  }
+
+  void check_value() {
+    if (object_depth_ == 0)
+      error("data must be an object");
+    if (!in_var_)
+      error("expected variable name");
+  }
+
+  void add_leaf() {
+    check_value();
+    size_t depth = counts_.size();
+    if (leaf_depth_ == unknown())
+      leaf_depth_ = depth;
+    else if (leaf_depth_ != depth)
+      error("arrays must be rectangular");
+    if (depth > 0)
+      ++counts_.back();
+  }
+
+  template <typename T>
+  static std::vector<T> to_column_major(const std::vector<T>& x,
+                                        const std::vector<size_t>& dims) {
+    std::vector<T> y(x.size());
+    std::vector<size_t> idx(dims.size(), 0);
+    std::vector<size_t> stride(dims.size(), 1);
+    for (size_t k = 1; k < dims.size(); ++k)
+      stride[k] = stride[k - 1] * dims[k - 1];
+    size_t offset = 0;
+    for (size_t n = 0; n < x.size(); ++n) {
+      y[offset] = x[n];
+      for (size_t k = dims.size(); k-- > 0;) {
+        offset += stride[k];
+        if (++idx[k] < dims[k])
+          break;
+        offset -= stride[k] * dims[k];
+        idx[k] = 0;
+      }
+    }
+    return y;
+  }
+
+  /**
+   * Called when the first element of the outermost array ends, with
+   * its values in row-major order. Puts them in column-major order of
+   * the inner dimensions, with room for one outer element.
+   */
+  template <typename T>
+  void start_column_major(std::vector<T>& values) {
+    std::vector<size_t> inner_dims(shape_.begin() + 1,
+                                   shape_.begin() + leaf_depth_);
+    inner_strides_.assign(inner_dims.size(), 1);
+    for (size_t k = 1; k < inner_dims.size(); ++k)
+      inner_strides_[k] = inner_strides_[k - 1] * inner_dims[k - 1];
+    if (inner_dims.size() > 1)
+      values = to_column_major(values, inner_dims);
+    outer_capacity_ = 1;
+  }
+
+  /**
+   * Writes a number of a multidimensional variable at its offset in
+   * the buffer, or appends it while the offsets are not known.
+   */
+  template <typename T>
+  void add_value(std::vector<T>& values, T x) {
+    if (outer_capacity_ == 0) {
+      values.push_back(x);
+      return;
+    }
+    size_t inner_offset = 0;
+    for (size_t k = 0; k < inner_strides_.size(); ++k) {
+      size_t idx = counts_[k + 1] - 1;
+      if (idx >= shape_[k + 1])
+        error("arrays must be rectangular");
+      inner_offset += idx * inner_strides_[k];
+    }
+    size_t outer = counts_[0] - 1;
+    if (outer == outer_capacity_) {
+      size_t inner_size = values.size() / outer_capacity_;
+      size_t capacity = 2 * outer_capacity_;
+      values.resize(capacity * inner_size);
+      for (size_t r = inner_size; r-- > 1;)
+        std::copy_backward(values.begin() + r * outer_capacity_,
+                           values.begin() + (r + 1) * outer_capacity_,
+                           values.begin() + r * capacity + outer_capacity_);
+      outer_capacity_ = capacity;
+    }
+    values[inner_offset * outer_capacity_ + outer] = x;
+  }
+
+  /**
+   * Moves the values of each inner offset next to each other, leaving
+   * the values in column-major order.
+   */
+  template <typename T>
+  void finish_column_major(std::vector<T>& values) {
+    size_t outer_size = shape_[0];
+    size_t inner_size = values.size() / outer_capacity_;
+    for (size_t r = 1; r < inner_size; ++r)
+      std::copy(values.begin() + r * outer_capacity_,
+                values.begin() + r * outer_capacity_ + outer_size,
+                values.begin() + r * outer_size);
+    values.resize(outer_size * inner_size);
+  }
+
+  void finish_var() {
+    in_var_ = false;
+    std::vector<size_t> dims(shape_.begin(), shape_.begin() + leaf_depth_);
+    if (is_int_) {
+      if (outer_capacity_ > 0)
+        finish_column_major(ints_);
+      vars_i_[name_] = var_i_t(std::move(ints_), std::move(dims));
+    } else {
+      if (outer_capacity_ > 0)
+        finish_column_major(reals_);
+      vars_r_[name_] = var_r_t(std::move(reals_), std::move(dims));
+    }
+  }
+};
+
+/**
+ * A <code>var_context</code> holding the variables of JSON data.
+ *
+ * <p>The JSON text is read with the streaming <code>json_parser</code>
+ * and the values of each variable are written into their final
+ * buffers as they are parsed, without building a document tree. See
+ * <code>json_data_handler</code> for the accepted format.
+ */
+class json_var_context : public var_context {
+ public:
+  typedef json_data_handler::var_r_t var_r_t;
+  typedef json_data_handler::var_i_t var_i_t;
+
+  /**
+   * Construct a context from JSON data read from the specified
+   * stream.
+   *
+   * <b>Warning:</b> This method does not close the input stream.
+   *
+   * @param in input stream from which to read
+   * @throw std::invalid_argument if the input is not valid JSON data
+   */
+  explicit json_var_context(std::istream& in) {
+    json_data_handler handler(vars_r_, vars_i_);
+    json_parser(in).parse(handler);
+    build_index();
+  }
+
+  /**
+   * Copy the variables of another context. The index is rebuilt, as
+   * it points into the maps of the original.
+   *
+   * @param other context to copy
+   */
+  json_var_context(const json_var_context& other)
+      : var_context(other), vars_r_(other.vars_r_), vars_i_(other.vars_i_) {
+    build_index();
+  }
+
+  json_var_context(json_var_context&& other) = default;
+
+  bool contains_r(const std::string& name) const {
+    return find_r(name) != nullptr || contains_i(name);
+  }
+
+  bool contains_i(const std::string& name) const {
+    return find_i(name) != nullptr;
+  }
+
+  std::vector<double> vals_r(const std::string& name) const {
+    const var_r_t* var_r = find_r(name);
+    if (var_r != nullptr)
+      return var_r->first;
+    const var_i_t* var_i = find_i(name);
+    if (var_i != nullptr)
+      return std::vector<double>(var_i->first.begin(), var_i->first.end());
+    return std::vector<double>();
+  }
+
+  std::vector<size_t> dims_r(const std::string& name) const {
+    const var_r_t* var_r = find_r(name);
+    if (var_r != nullptr)
+      return var_r->second;
+    return dims_i(name);
+  }
+
+  std::vector<int> vals_i(const std::string& name) const {
+    const var_i_t* var_i = find_i(name);
+    return var_i == nullptr ? std::vector<int>() : var_i->first;
+  }
+
+  std::vector<size_t> dims_i(const std::string& name) const {
+    const var_i_t* var_i = find_i(name);
+    return var_i == nullptr ? std::vector<size_t>() : var_i->second;
+  }
+
+  /**
+   * Return a view of the double values for the variable with the
+   * specified name. The view of an integer variable owns a converted
+   * copy of its values.
+   *
+   * @param name name of variable
+   * @return view of the values of the variable
+   */
+  array_view<double> vals_r_view(const std::string& name) const {
+    const var_r_t* var_r = find_r(name);
+    if (var_r != nullptr)
+      return var_r->first;
+    if (contains_i(name))
+      return var_context::vals_r_view(name);
+    return array_view<double>();
+  }
+
+  array_view<int> vals_i_view(const std::string& name) const {
+    const var_i_t* var_i = find_i(name);
+    return var_i == nullptr ? array_view<int>() : var_i->first;
+  }
+
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    const var_r_t* var_r = find_r(name);
+    if (var_r != nullptr)
+      return var_r->second;
+    return dims_i_view(name);
+  }
+
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    const var_i_t* var_i = find_i(name);
+    return var_i == nullptr ? array_view<size_t>() : var_i->second;
+  }
+
+  void names_r(std::vector<std::string>& names) const {
+    names.clear();
+    for (const auto& var : vars_r_)
+      names.push_back(var.first);
+  }
+
+  void names_i(std::vector<std::string>& names) const {
+    names.clear();
+    for (const auto& var : vars_i_)
+      names.push_back(var.first);
+  }
+
+  /**
+   * Check variable dimensions against variable declaration.
+   *
+   * @param stage stan program processing stage
+   * @param name variable name
+   * @param base_type declared stan variable type
+   * @param dims_declared variable dimensions
+   * @throw std::runtime_error if mismatch between declared
+   *        dimensions and dimensions found in context.
+   */
+  void validate_dims(const std::string& stage, const std::string& name,
+                     const std::string& base_type,
+                     const std::vector<size_t>& dims_declared) const {
+    stan::io::validate_dims(*this, stage, name, base_type, dims_declared);
+  }
+
+  /**
+   * Remove variable from the object.
+   *
+   * @param name name of the variable to remove
+   * @return <code>true</code> if the variable was removed
+   */
+  bool remove(const std::string& name) {
+    bool removed = (vars_i_.erase(name) > 0) || (vars_r_.erase(name) > 0);
+    if (removed)
+      build_index();
+    return removed;
+  }
+
+ private:
+  std::map<std::string, var_r_t> vars_r_;
+  std::map<std::string, var_i_t> vars_i_;
+  name_index<const var_r_t*> index_r_;
+  name_index<const var_i_t*> index_i_;
+
+  void build_index() {
+    index_r_.clear();
+    index_r_.reserve(vars_r_.size());
+    for (const auto& var : vars_r_)
+      index_r_.insert(var.first, &var.second);
+    index_i_.clear();
+    index_i_.reserve(vars_i_.size());
+    for (const auto& var : vars_i_)
+      index_i_.insert(var.first, &var.second);
+  }
+
+  const var_r_t* find_r(const std::string& name) const {
+    auto var = index_r_.find(name);
+    return var == nullptr ? nullptr : *var;
+  }
+
+  const var_i_t* find_i(const std::string& name) const {
+    auto var = index_i_.find(name);
+    return var == nullptr ? nullptr : *var;
+  }
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
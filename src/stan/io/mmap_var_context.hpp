@@ -0,0 +1,454 @@
+#ifndef STAN_IO_MMAP_VAR_CONTEXT_HPP
+#define STAN_IO_MMAP_VAR_CONTEXT_HPP
+
+#include <stan/io/validate_dims.hpp>
+#include <stan/io/var_context.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <memory>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace stan {
+namespace io {
+
+/**
+ * Layout of the binary data files read by <code>mmap_var_context</code>
+ * and written by <code>write_mmap_var_context</code>.
+ *
+ * <p>All fields are unsigned 64-bit integers in the byte order of the
+ * machine that wrote the file, which is checked against the byte
+ * order mark when reading. The file consists of
+ *
+ * <ul>
+ * <li>a header: the magic number, the format version, the byte order
+ * mark and the number of variables,</li>
+ * <li>a table with one entry per variable: the length of the name,
+ * the type of the values (<code>type_real</code> for doubles,
+ * <code>type_int</code> for 32-bit integers), the number of
+ * dimensions, the offset of the values from the start of the file,
+ * the number of values, followed by the name padded with zeros to a
+ * multiple of eight bytes and the dimensions,</li>
+ * <li>the values of each variable in last-index-major order (as in
+ * <code>var_context::vals_r</code>), starting at a multiple of
+ * <code>alignment</code> bytes.</li>
+ * </ul>
+ */
+struct mmap_var_context_format {
+  static uint64_t magic() { return 0x535241564E415453ULL; }  // "STANVARS"
+  static uint64_t version() { return 1; }
+  static uint64_t byte_order_mark() { return 0x0102030405060708ULL; }
+  static uint64_t type_real() { return 0; }
+  static uint64_t type_int() { return 1; }
+  static uint64_t alignment() { return 64; }
+
+  /**
+   * Return the size rounded up to a multiple of the alignment.
+   *
+   * @param[in] size size in bytes
+   * @param[in] alignment alignment in bytes
+   * @return aligned size in bytes
+   */
+  static uint64_t align(uint64_t size, uint64_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+};
+
+/**
+ * An <code>mmap_var_context</code> exposes the variables of a binary
+ * data file (see <code>mmap_var_context_format</code>) without
+ * parsing or copying them.
+ *
+ * <p>The file is mapped read-only into memory, so the values are read
+ * from the page cache when first used and processes reading the same
+ * file share one copy. Only the table of names and dimensions is
+ * read when constructing the context. The views returned by
+ * <code>vals_r_view</code> and <code>vals_i_view</code> point into
+ * the mapping; <code>vals_r</code> and <code>vals_i</code> copy as
+ * required by <code>var_context</code>.
+ *
+ * <p>On platforms without <code>mmap</code> the file is read into
+ * memory instead.
+ */
+class mmap_var_context : public var_context {
+ public:
+  /**
+   * Construct a context from the binary data file at the specified
+   * path.
+   *
+   * @param[in] path path of the file
+   * @throw std::runtime_error if the file cannot be opened or mapped,
+   *   or is not a valid binary data file
+   */
+  explicit mmap_var_context(const std::string& path)
+      : data_(nullptr), size_(0) {
+    map(path);
+    try {
+      read_table(path);
+    } catch (...) {
+      unmap();
+      throw;
+    }
+  }
+
+  mmap_var_context(const mmap_var_context&) = delete;
+  mmap_var_context& operator=(const mmap_var_context&) = delete;
+
+  ~mmap_var_context() { unmap(); }
+
+  bool contains_r(const std::string& name) const {
+    return vars_.find(name) != vars_.end();
+  }
+
+  bool contains_i(const std::string& name) const {
+    auto it = vars_.find(name);
+    return it != vars_.end() && it->second.is_int;
+  }
+
+  /**
+   * Return the values of the variable as doubles, converting
+   * integer values.
+   *
+   * @param name Name of variable.
+   * @return Values of variable.
+   */
+  std::vector<double> vals_r(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end())
+      return std::vector<double>();
+    if (it->second.is_int) {
+      array_view<int> vals = int_view(it->second);
+      return std::vector<double>(vals.begin(), vals.end());
+    }
+    return real_view(it->second).to_vector();
+  }
+
+  std::vector<int> vals_i(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end() || !it->second.is_int)
+      return std::vector<int>();
+    return int_view(it->second).to_vector();
+  }
+
+  std::vector<size_t> dims_r(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end())
+      return std::vector<size_t>();
+    return it->second.dims;
+  }
+
+  std::vector<size_t> dims_i(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end() || !it->second.is_int)
+      return std::vector<size_t>();
+    return it->second.dims;
+  }
+
+  /**
+   * Return a view of the values of the variable in the mapped file.
+   * The view of an integer variable owns a converted copy of its
+   * values.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the variable.
+   */
+  array_view<double> vals_r_view(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end())
+      return array_view<double>();
+    if (it->second.is_int)
+      return var_context::vals_r_view(name);
+    return real_view(it->second);
+  }
+
+  array_view<int> vals_i_view(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end() || !it->second.is_int)
+      return array_view<int>();
+    return int_view(it->second);
+  }
+
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end())
+      return array_view<size_t>();
+    return it->second.dims;
+  }
+
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    auto it = vars_.find(name);
+    if (it == vars_.end() || !it->second.is_int)
+      return array_view<size_t>();
+    return it->second.dims;
+  }
+
+  /**
+   * Return the names of the variables with floating point values.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  void names_r(std::vector<std::string>& names) const {
+    names.resize(0);
+    for (const auto& var : vars_)
+      if (!var.second.is_int)
+        names.push_back(var.first);
+  }
+
+  /**
+   * Return the names of the variables with integer values.
+   *
+   * @param names Vector to store the list of names in.
+   */
+  void names_i(std::vector<std::string>& names) const {
+    names.resize(0);
+    for (const auto& var : vars_)
+      if (var.second.is_int)
+        names.push_back(var.first);
+  }
+
+  void validate_dims(const std::string& stage, const std::string& name,
+                     const std::string& base_type,
+                     const std::vector<size_t>& dims_declared) const {
+    stan::io::validate_dims(*this, stage, name, base_type, dims_declared);
+  }
+
+ private:
+  struct var_entry {
+    bool is_int;
+    std::vector<size_t> dims;
+    const char* values;
+    size_t size;
+  };
+
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  std::unique_ptr<uint64_t[]> buffer_;
+#endif
+  std::map<std::string, var_entry> vars_;
+
+  static array_view<double> real_view(const var_entry& var) {
+    return array_view<double>(reinterpret_cast<const double*>(var.values),
+                              var.size);
+  }
+
+  static array_view<int> int_view(const var_entry& var) {
+    return array_view<int>(reinterpret_cast<const int*>(var.values),
+                           var.size);
+  }
+
+  void map(const std::string& path) {
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+      throw std::runtime_error("Cannot open binary data file " + path);
+    size_ = static_cast<size_t>(in.tellg());
+    // uint64_t storage keeps the payload aligned for doubles
+    buffer_.reset(new uint64_t[size_ / sizeof(uint64_t) + 1]);
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer_.get()), size_);
+    if (!in)
+      throw std::runtime_error("Cannot read binary data file " + path);
+    data_ = reinterpret_cast<const char*>(buffer_.get());
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("Cannot open binary data file " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Cannot stat binary data file " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Cannot map binary data file " + path);
+      }
+      data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);
+#endif
+  }
+
+  void unmap() {
+#ifndef _WIN32
+    if (data_ != nullptr)
+      ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+  }
+
+  uint64_t read_uint(size_t& pos, const std::string& path) const {
+    if (size_ < sizeof(uint64_t) || pos > size_ - sizeof(uint64_t))
+      throw std::runtime_error("Truncated binary data file " + path);
+    uint64_t x;
+    std::memcpy(&x, data_ + pos, sizeof(x));
+    pos += sizeof(x);
+    return x;
+  }
+
+  void read_table(const std::string& path) {
+    typedef mmap_var_context_format format;
+    static_assert(sizeof(int) == 4, "int must have 32 bits");
+    static_assert(sizeof(double) == 8, "double must have 64 bits");
+    size_t pos = 0;
+    if (read_uint(pos, path) != format::magic())
+      throw std::runtime_error("Not a binary data file: " + path);
+    if (read_uint(pos, path) != format::version())
+      throw std::runtime_error("Unsupported binary data file version in "
+                               + path);
+    if (read_uint(pos, path) != format::byte_order_mark())
+      throw std::runtime_error(
+          "Binary data file written with different byte order: " + path);
+    uint64_t num_vars = read_uint(pos, path);
+    for (uint64_t n = 0; n < num_vars; ++n) {
+      uint64_t name_size = read_uint(pos, path);
+      uint64_t type = read_uint(pos, path);
+      uint64_t num_dims = read_uint(pos, path);
+      uint64_t offset = read_uint(pos, path);
+      uint64_t num_values = read_uint(pos, path);
+      uint64_t padded_name_size = format::align(name_size, sizeof(uint64_t));
+      if (name_size > size_ || padded_name_size > size_ - pos)
+        throw std::runtime_error("Truncated binary data file " + path);
+      std::string name(data_ + pos, name_size);
+      pos += padded_name_size;
+
+      var_entry var;
+      var.is_int = type == format::type_int();
+      if (!var.is_int && type != format::type_real())
+        throw std::runtime_error("Unknown type of variable " + name
+                                 + " in binary data file " + path);
+      uint64_t dims_size = 1;
+      for (uint64_t d = 0; d < num_dims; ++d) {
+        var.dims.push_back(read_uint(pos, path));
+        if (var.dims.back() != 0 && dims_size > num_values / var.dims.back())
+          dims_size = num_values + 1;
+        else
+          dims_size *= var.dims.back();
+      }
+      if (dims_size != num_values)
+        throw std::runtime_error("Number of values of variable " + name
+                                 + " does not match its dimensions in"
+                                 + " binary data file " + path);
+      size_t value_size = var.is_int ? sizeof(int) : sizeof(double);
+      if (offset % value_size != 0 || offset > size_
+          || num_values > (size_ - offset) / value_size)
+        throw std::runtime_error("Values of variable " + name
+                                 + " outside of binary data file " + path);
+      var.values = data_ + offset;
+      var.size = num_values;
+      vars_[name] = var;
+    }
+  }
+};
+
+/**
+ * Writes the variables of a var_context to a stream in the binary
+ * format read by <code>mmap_var_context</code>. Variables listed by
+ * <code>names_i</code> are written as integers, those listed by
+ * <code>names_r</code> as doubles.
+ *
+ * @param[in] context variables to write
+ * @param[in,out] out stream, opened in binary mode
+ * @throw std::runtime_error if writing fails
+ */
+inline void write_mmap_var_context(const var_context& context,
+                                   std::ostream& out) {
+  typedef mmap_var_context_format format;
+  std::vector<std::string> names_i;
+  context.names_i(names_i);
+  std::vector<std::string> names_r;
+  context.names_r(names_r);
+
+  struct var_header {
+    const std::string* name;
+    bool is_int;
+    std::vector<size_t> dims;
+    uint64_t num_values;
+    uint64_t offset;
+  };
+  std::vector<var_header> vars;
+  for (const std::string& name : names_r)
+    vars.push_back({&name, false, context.dims_r(name),
+                    context.vals_r_view(name).size(), 0});
+  for (const std::string& name : names_i)
+    vars.push_back({&name, true, context.dims_i(name),
+                    context.vals_i_view(name).size(), 0});
+
+  uint64_t table_end = 4 * sizeof(uint64_t);
+  for (const var_header& var : vars)
+    table_end += 5 * sizeof(uint64_t)
+                 + format::align(var.name->size(), sizeof(uint64_t))
+                 + var.dims.size() * sizeof(uint64_t);
+  uint64_t offset = table_end;
+  for (var_header& var : vars) {
+    offset = format::align(offset, format::alignment());
+    var.offset = offset;
+    offset += var.num_values * (var.is_int ? sizeof(int) : sizeof(double));
+  }
+
+  uint64_t pos = 0;
+  auto write_uint = [&](uint64_t x) {
+    out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+    pos += sizeof(x);
+  };
+  auto pad_to = [&](uint64_t target) {
+    static const char zeros[64] = {0};
+    while (pos < target) {
+      uint64_t n = std::min<uint64_t>(target - pos, sizeof(zeros));
+      out.write(zeros, n);
+      pos += n;
+    }
+  };
+  write_uint(format::magic());
+  write_uint(format::version());
+  write_uint(format::byte_order_mark());
+  write_uint(vars.size());
+  for (const var_header& var : vars) {
+    write_uint(var.name->size());
+    write_uint(var.is_int ? format::type_int() : format::type_real());
+    write_uint(var.dims.size());
+    write_uint(var.offset);
+    write_uint(var.num_values);
+    out.write(var.name->data(), var.name->size());
+    pos += var.name->size();
+    pad_to(format::align(pos, sizeof(uint64_t)));
+    for (size_t dim : var.dims)
+      write_uint(dim);
+  }
+  for (const var_header& var : vars) {
+    pad_to(var.offset);
+    if (var.is_int) {
+      array_view<int> vals = context.vals_i_view(*var.name);
+      out.write(reinterpret_cast<const char*>(vals.data()),
+                vals.size() * sizeof(int));
+      pos += vals.size() * sizeof(int);
+    } else {
+      array_view<double> vals = context.vals_r_view(*var.name);
+      out.write(reinterpret_cast<const char*>(vals.data()),
+                vals.size() * sizeof(double));
+      pos += vals.size() * sizeof(double);
+    }
+  }
+  if (!out)
+    throw std::runtime_error("Error writing binary data file");
+}
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -0,0 +1,136 @@
+#ifndef STAN_IO_NAME_INDEX_HPP
+#define STAN_IO_NAME_INDEX_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace io {
+
+/**
+ * A hash table from variable names to values, used by the
+ * <code>var_context</code> implementations to look up variables by
+ * name in constant time.
+ *
+ * <p>The table uses open addressing with linear probing and keeps at
+ * least half of its slots empty. It is meant to be filled once when
+ * the context is constructed; values cannot be removed, so contexts
+ * that remove variables rebuild the index instead.
+ *
+ * @tparam T type of values, typically a pointer or position
+ */
+template <typename T>
+class name_index {
+ public:
+  name_index() : size_(0) {}
+
+  /**
+   * Return the number of names in the index.
+   *
+   * @return number of names
+   */
+  size_t size() const { return size_; }
+
+  /**
+   * Removes all names from the index.
+   */
+  void clear() {
+    slots_.clear();
+    size_ = 0;
+  }
+
+  /**
+   * Reserves slots for the specified number of names.
+   *
+   * @param[in] n number of names
+   */
+  void reserve(size_t n) {
+    if (2 * n > slots_.size())
+      rehash(2 * n);
+  }
+
+  /**
+   * Adds the name with the value unless the name is already in the
+   * index.
+   *
+   * @param[in] name name
+   * @param[in] value value
+   * @return true if the name was added
+   */
+  bool insert(const std::string& name, const T& value) {
+    if (2 * (size_ + 1) > slots_.size())
+      rehash(2 * (size_ + 1));
+    size_t hash = hash_(name);
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      slot& s = slots_[i];
+      if (!s.used) {
+        s.used = true;
+        s.hash = hash;
+        s.name = name;
+        s.value = value;
+        ++size_;
+        return true;
+      }
+      if (s.hash == hash && s.name == name)
+        return false;
+    }
+  }
+
+  /**
+   * Return a pointer to the value of the name, or null if the name is
+   * not in the index.
+   *
+   * @param[in] name name
+   * @return pointer to the value or null
+   */
+  const T* find(const std::string& name) const {
+    if (size_ == 0)
+      return nullptr;
+    size_t hash = hash_(name);
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const slot& s = slots_[i];
+      if (!s.used)
+        return nullptr;
+      if (s.hash == hash && s.name == name)
+        return &s.value;
+    }
+  }
+
+ private:
+  struct slot {
+    bool used = false;
+    size_t hash = 0;
+    std::string name;
+    T value = T();
+  };
+
+  void rehash(size_t min_slots) {
+    size_t n = 8;
+    while (n < min_slots)
+      n *= 2;
+    std::vector<slot> old(n);
+    old.swap(slots_);
+    size_t mask = n - 1;
+    for (slot& s : old) {
+      if (!s.used)
+        continue;
+      size_t i = s.hash & mask;
+      while (slots_[i].used)
+        i = (i + 1) & mask;
+      slots_[i] = std::move(s);
+    }
+  }
+
+  std::vector<slot> slots_;
+  size_t size_;
+  std::hash<std::string> hash_;
+};
+
+}  // namespace io
+}  // namespace stan
+#endif
@@ -0,0 +1,149 @@
+#ifndef STAN_IO_PARSE_DOUBLE_HPP
+#define STAN_IO_PARSE_DOUBLE_HPP
+
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace stan {
+namespace io {
+
+namespace internal {
+
+inline bool match_word(const char*& p, const char* end, const char* word) {
+  const char* q = p;
+  for (; *word != '\0'; ++word, ++q) {
+    if (q == end || (*q | 0x20) != *word)
+      return false;
+  }
+  p = q;
+  return true;
+}
+
+/**
+ * Parses the number in <code>[begin, end)</code> with
+ * <code>std::strtod</code>, replacing the decimal point by the one of
+ * the current C locale.
+ */
+inline double parse_double_strtod(const char* begin, const char* end) {
+  std::string s(begin, end);
+  const char point = *std::localeconv()->decimal_point;
+  if (point != '.') {
+    std::string::size_type pos = s.find('.');
+    if (pos != std::string::npos)
+      s[pos] = point;
+  }
+  return std::strtod(s.c_str(), nullptr);
+}
+
+}  // namespace internal
+
+/**
+ * Parses a floating point number in C syntax at the start of
+ * <code>[begin, end)</code> without using streams or the locale.
+ *
+ * <p>Accepts an optional sign followed by decimal digits with an
+ * optional decimal point and exponent, or <code>nan</code>,
+ * <code>inf</code> or <code>infinity</code> in any case. Numbers with
+ * at most 19 significant digits and a small decimal exponent, which
+ * covers the output of Stan, are converted exactly with a single
+ * multiplication or division; other numbers are passed to
+ * <code>std::strtod</code>. The result is the correctly rounded value
+ * in both cases.
+ *
+ * @param[in] begin start of the characters
+ * @param[in] end end of the characters
+ * @param[out] x parsed value, unchanged if no number was found
+ * @return pointer past the number, or <code>begin</code> if there is
+ *   no number at the start of the range
+ */
+inline const char* parse_double(const char* begin, const char* end,
+                                double& x) {
+  static const double powers_of_ten[]
+      = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+         1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+         1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char* p = begin;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+  if (p != end && !(*p >= '0' && *p <= '9') && *p != '.') {
+    if (internal::match_word(p, end, "nan")) {
+      x = std::numeric_limits<double>::quiet_NaN();
+      return p;
+    }
+    if (internal::match_word(p, end, "inf")) {
+      internal::match_word(p, end, "inity");
+      x = negative ? -std::numeric_limits<double>::infinity()
+                   : std::numeric_limits<double>::infinity();
+      return p;
+    }
+    return begin;
+  }
+
+  uint64_t mantissa = 0;
+  int num_digits = 0;
+  int exponent = 0;
+  bool any_digits = false;
+  bool exact = true;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    any_digits = true;
+    if (num_digits < 19) {
+      mantissa = 10 * mantissa + (*p - '0');
+      num_digits += mantissa > 0;
+    } else {
+      ++exponent;
+      exact = exact && *p == '0';
+    }
+  }
+  if (p != end && *p == '.') {
+    ++p;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+      any_digits = true;
+      if (num_digits < 19) {
+        mantissa = 10 * mantissa + (*p - '0');
+        num_digits += mantissa > 0;
+        --exponent;
+      } else {
+        exact = exact && *p == '0';
+      }
+    }
+  }
+  if (!any_digits)
+    return begin;
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    const char* q = p + 1;
+    bool negative_exponent = false;
+    if (q != end && (*q == '-' || *q == '+')) {
+      negative_exponent = *q == '-';
+      ++q;
+    }
+    if (q != end && *q >= '0' && *q <= '9') {
+      int e = 0;
+      for (; q != end && *q >= '0' && *q <= '9'; ++q)
+        if (e < 100000)
+          e = 10 * e + (*q - '0');
+      exponent += negative_exponent ? -e : e;
+      p = q;
+    }
+  }
+
+  if (exact && mantissa <= (uint64_t(1) << 53) && exponent >= -22
+      && exponent <= 22) {
+    double y = static_cast<double>(mantissa);
+    y = exponent < 0 ? y / powers_of_ten[-exponent]
+                     : y * powers_of_ten[exponent];
+    x = negative ? -y : y;
+  } else {
+    x = internal::parse_double_strtod(begin, p);
+  }
+  return p;
+}
+
+}  // namespace io
+}  // namespace stan
+#endif
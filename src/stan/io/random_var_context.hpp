@@ -2,6 +2,7 @@
 #define STAN_IO_RANDOM_VAR_CONTEXT_HPP
 
 #include <stan/io/var_context.hpp>
+#include <stan/io/name_index.hpp>
 #include <stan/io/validate_dims.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
 #include <algorithm>
@@ -62,6 +63,9 @@ class random_var_context : public var_context {
     }
     dims_.erase(dims_.begin() + i, dims_.end());
     names_.erase(names_.begin() + i, names_.end());
+    index_.reserve(names_.size());
+    for (size_t n = 0; n < names_.size(); ++n)
+      index_.insert(names_[n], n);
 
     if (init_zero) {
       for (size_t n = 0; n < num_unconstrained_; ++n)
@@ -96,7 +100,7 @@ class random_var_context : public var_context {
    * model.
    */
   bool contains_r(const std::string& name) const {
-    return std::find(names_.begin(), names_.end(), name) != names_.end();
+    return index_.find(name) != nullptr;
   }
 
   /**
@@ -108,11 +112,10 @@ class random_var_context : public var_context {
    *   var_context; an empty vector is returned otherwise
    */
   std::vector<double> vals_r(const std::string& name) const {
-    std::vector<std::string>::const_iterator loc
-        = std::find(names_.begin(), names_.end(), name);
-    if (loc == names_.end())
+    const size_t* pos = index_.find(name);
+    if (pos == nullptr)
       return std::vector<double>();
-    return vals_r_[loc - names_.begin()];
+    return vals_r_[*pos];
   }
 
   /**
@@ -123,11 +126,58 @@ class random_var_context : public var_context {
    *   is returned otherwise
    */
   std::vector<size_t> dims_r(const std::string& name) const {
-    std::vector<std::string>::const_iterator loc
-        = std::find(names_.begin(), names_.end(), name);
-    if (loc == names_.end())
+    const size_t* pos = index_.find(name);
+    if (pos == nullptr)
       return std::vector<size_t>();
-    return dims_[loc - names_.begin()];
+    return dims_[*pos];
+  }
+
+  /**
+   * Returns a view of the values of the constrained variables.
+   *
+   * @param name Name of variable.
+   * @return view of the constrained values if the variable is in the
+   *   var_context; an empty view is returned otherwise
+   */
+  array_view<double> vals_r_view(const std::string& name) const {
+    const size_t* pos = index_.find(name);
+    if (pos == nullptr)
+      return array_view<double>();
+    return vals_r_[*pos];
+  }
+
+  /**
+   * Returns a view of the dimensions of the variable.
+   *
+   * @param name Name of variable.
+   * @return view of the dimensions of the variable if it exists; an
+   *   empty view is returned otherwise
+   */
+  array_view<size_t> dims_r_view(const std::string& name) const {
+    const size_t* pos = index_.find(name);
+    if (pos == nullptr)
+      return array_view<size_t>();
+    return dims_[*pos];
+  }
+
+  /**
+   * Returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  array_view<int> vals_i_view(const std::string& name) const {
+    return array_view<int>();
+  }
+
+  /**
+   * Returns an empty view.
+   *
+   * @param name Name of variable.
+   * @return empty view
+   */
+  array_view<size_t> dims_i_view(const std::string& name) const {
+    return array_view<size_t>();
   }
 
   /**
@@ -210,6 +260,10 @@ class random_var_context : public var_context {
    * Parameter names in the model
    */
   std::vector<std::string> names_;
+  /**
+   * Positions of the parameters in <code>names_</code> by name
+   */
+  name_index<size_t> index_;
   /**
    * Dimensions of parameters in the model
    */
@@ -179,6 +179,92 @@ class reader {
     return std::vector<T>(start_pos, end_pos);
   }
 
+  /**
+   * Return a standard vector of the specified size made up of the
+   * next scalars. Here, the constrain operation is a no-op.
+   *
+   * @param m Size of vector.
+   * @return Vector made up of the next scalars.
+   */
+  inline std::vector<T> std_vector_constrain(size_t m) {
+    return std_vector(m);
+  }
+
+  /**
+   * Return a standard vector of the specified size made up of the
+   * next scalars. Here, the constrain operation is a no-op and the
+   * log probability is not incremented.
+   *
+   * @param m Size of vector.
+   * @return Vector made up of the next scalars.
+   */
+  inline std::vector<T> std_vector_constrain(size_t m, T & /*lp*/) {
+    return std_vector(m);
+  }
+
+  /**
+   * Return a standard vector of the specified size made up of the
+   * next scalars transformed to be greater than or equal to the
+   * specified lower bound.
+   *
+   * <p>The values are read and transformed as one contiguous block
+   * with the vectorized transform, which is what the generated code
+   * uses for one-dimensional arrays of bounded reals instead of one
+   * <code>scalar_lb_constrain()</code> call per element.
+   *
+   * @tparam TL Type of lower bound.
+   * @param lb Lower bound.
+   * @param m Size of vector.
+   * @return Vector of constrained values.
+   */
+  template <typename TL>
+  inline std::vector<T> std_vector_lb_constrain(const TL lb, size_t m) {
+    return to_std_vector(vector_lb_constrain(lb, m));
+  }
+
+  template <typename TL>
+  inline std::vector<T> std_vector_lb_constrain(const TL lb, size_t m,
+                                                T &lp) {
+    return to_std_vector(vector_lb_constrain(lb, m, lp));
+  }
+
+  template <typename TU>
+  inline std::vector<T> std_vector_ub_constrain(const TU ub, size_t m) {
+    return to_std_vector(vector_ub_constrain(ub, m));
+  }
+
+  template <typename TU>
+  inline std::vector<T> std_vector_ub_constrain(const TU ub, size_t m,
+                                                T &lp) {
+    return to_std_vector(vector_ub_constrain(ub, m, lp));
+  }
+
+  template <typename TL, typename TU>
+  inline std::vector<T> std_vector_lub_constrain(const TL lb, const TU ub,
+                                                 size_t m) {
+    return to_std_vector(vector_lub_constrain(lb, ub, m));
+  }
+
+  template <typename TL, typename TU>
+  inline std::vector<T> std_vector_lub_constrain(const TL lb, const TU ub,
+                                                 size_t m, T &lp) {
+    return to_std_vector(vector_lub_constrain(lb, ub, m, lp));
+  }
+
+  template <typename TL, typename TS>
+  inline std::vector<T> std_vector_offset_multiplier_constrain(
+      const TL offset, const TS multiplier, size_t m) {
+    return to_std_vector(vector_offset_multiplier_constrain(offset,
+                                                            multiplier, m));
+  }
+
+  template <typename TL, typename TS>
+  inline std::vector<T> std_vector_offset_multiplier_constrain(
+      const TL offset, const TS multiplier, size_t m, T &lp) {
+    return to_std_vector(
+        vector_offset_multiplier_constrain(offset, multiplier, m, lp));
+  }
+
   /**
    * Return a column vector of specified dimensionality made up of
    * the next scalars.
@@ -1541,6 +1627,22 @@ class reader {
     return stan::math::offset_multiplier_constrain(matrix(m, n), offset,
                                                    multiplier, lp);
   }
+
+ private:
+  /**
+   * Evaluate the specified column vector expression into a standard
+   * vector without an intermediate Eigen vector.
+   *
+   * @tparam EigVec Type of column vector expression.
+   * @param x Column vector expression.
+   * @return Standard vector holding the values.
+   */
+  template <typename EigVec>
+  static std::vector<T> to_std_vector(const EigVec &x) {
+    std::vector<T> y(x.size());
+    Eigen::Map<vector_t>(y.data(), y.size()) = x;
+    return y;
+  }
 };
 
 }  // namespace io
@@ -2,12 +2,18 @@
 #define STAN_IO_STAN_CSV_READER_HPP
 
 #include <boost/algorithm/string.hpp>
+#include <stan/io/parse_double.hpp>
 #include <stan/math/prim.hpp>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <functional>
 #include <istream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace stan {
@@ -261,73 +267,185 @@ class stan_csv_reader {
       return true;
   }
 
+  /**
+   * Return the indices of the named columns in the header.
+   *
+   * @param[in] header header
+   * @param[in] names names of the columns
+   * @return indices of the columns, in the order of the names
+   * @throw std::invalid_argument if a name is not in the header or
+   *   appears more than once in the names
+   */
+  static std::vector<int> column_indices(
+      const std::vector<std::string>& header,
+      const std::vector<std::string>& names) {
+    std::vector<int> columns;
+    for (const std::string& name : names) {
+      auto it = std::find(header.begin(), header.end(), name);
+      if (it == header.end())
+        throw std::invalid_argument("Column " + name + " not found in header");
+      int column = it - header.begin();
+      if (std::find(columns.begin(), columns.end(), column) != columns.end())
+        throw std::invalid_argument("Column " + name + " selected twice");
+      columns.push_back(column);
+    }
+    return columns;
+  }
+
+  /**
+   * Reads the samples and the timing comments that follow the
+   * adaptation information.
+   *
+   * <p>The rest of the stream is read in large blocks and each value
+   * is parsed in place with <code>parse_double</code>. If compiled
+   * with <code>STAN_THREADS</code>, the rows are split across threads.
+   *
+   * @param[in,out] in input stream
+   * @param[out] samples samples, one row per draw
+   * @param[in,out] timing timing, incremented by the timing comments
+   * @param[in,out] out stream for error messages, may be null
+   * @return false if the stream holds no samples or if the rows have
+   *   different numbers of columns
+   */
   static bool read_samples(std::istream& in, Eigen::MatrixXd& samples,
                            stan_csv_timing& timing, std::ostream* out) {
-    std::stringstream ss;
-    std::string line;
-
-    int rows = 0;
-    int cols = -1;
+    return read_samples(in, std::vector<int>(), samples, timing, out);
+  }
 
+  /**
+   * Reads the selected columns of the samples and the timing comments
+   * that follow the adaptation information. Cells of other columns
+   * are skipped without being parsed.
+   *
+   * @param[in,out] in input stream
+   * @param[in] columns indices of the columns to read, in the order
+   *   of the columns of <code>samples</code>; all columns if empty
+   * @param[out] samples samples, one row per draw
+   * @param[in,out] timing timing, incremented by the timing comments
+   * @param[in,out] out stream for error messages, may be null
+   * @return false if the stream holds no samples, if the rows have
+   *   different numbers of columns or if a column is out of range
+   */
+  static bool read_samples(std::istream& in, const std::vector<int>& columns,
+                           Eigen::MatrixXd& samples, stan_csv_timing& timing,
+                           std::ostream* out) {
     if (in.peek() == '#' || in.good() == false)
       return false;
 
-    while (in.good()) {
-      bool comment_line = (in.peek() == '#');
-      bool empty_line = (in.peek() == '\n');
+    std::string buffer;
+    read_all(in, buffer);
+    const char* data = buffer.data();
+    const char* data_end = data + buffer.size();
 
-      std::getline(in, line);
+    std::vector<size_t> row_starts;
+    int cols = -1;
+    size_t num_rows = 0;
+    auto on_row = [&](const char* line, const char* line_end) {
+      row_starts.push_back(line - data);
+    };
+    if (!scan_lines(data, data_end, cols, num_rows, timing, out, on_row))
+      return false;
 
-      if (empty_line)
-        continue;
-      if (!line.length())
-        break;
-
-      if (comment_line) {
-        if (line.find("(Warm-up)") != std::string::npos) {
-          int left = 17;
-          int right = line.find(" seconds");
-          double warmup;
-          std::stringstream(line.substr(left, right - left)) >> warmup;
-          timing.warmup += warmup;
-        } else if (line.find("(Sampling)") != std::string::npos) {
-          int left = 17;
-          int right = line.find(" seconds");
-          double sampling;
-          std::stringstream(line.substr(left, right - left)) >> sampling;
-          timing.sampling += sampling;
-        }
+    int rows = row_starts.size();
+    if (rows > 0) {
+      std::vector<int> targets;
+      if (!column_targets(columns, cols, targets, out))
+        return false;
+      samples.resize(rows, columns.empty() ? cols : columns.size());
+      auto parse_rows = [&](int first, int last) {
+        for (int row = first; row < last; ++row)
+          parse_row(data + row_starts[row], data_end, targets, samples, row);
+      };
+      int num_threads = num_parse_threads(rows, targets.size());
+      if (num_threads <= 1) {
+        parse_rows(0, rows);
       } else {
-        ss << line << '\n';
-        int current_cols = std::count(line.begin(), line.end(), ',') + 1;
-        if (cols == -1) {
-          cols = current_cols;
-        } else if (cols != current_cols) {
-          if (out)
-            *out << "Error: expected " << cols << " columns, but found "
-                 << current_cols << " instead for row " << rows + 1
-                 << std::endl;
-          return false;
-        }
-        rows++;
+        std::vector<std::thread> threads;
+        int block = (rows + num_threads - 1) / num_threads;
+        for (int first = block; first < rows; first += block)
+          threads.emplace_back(parse_rows, first,
+                               std::min(rows, first + block));
+        parse_rows(0, std::min(rows, block));
+        for (auto& thread : threads)
+          thread.join();
       }
-
-      in.peek();
     }
+    return true;
+  }
 
-    ss.seekg(std::ios_base::beg);
+  /**
+   * Reads the selected columns of the samples in chunks of at most
+   * <code>chunk_rows</code> rows, passing each chunk to the callback,
+   * and the timing comments that follow the adaptation information.
+   * Memory use is bounded by the chunk size and the block size of
+   * reading, independent of the number of rows.
+   *
+   * @param[in,out] in input stream
+   * @param[in] columns indices of the columns to read, in the order
+   *   of the columns of the chunks; all columns if empty
+   * @param[in] chunk_rows maximum number of rows per chunk
+   * @param[in] callback called with each chunk, one row per draw
+   * @param[in,out] timing timing, incremented by the timing comments
+   * @param[in,out] out stream for error messages, may be null
+   * @return false if the stream holds no samples, if the rows have
+   *   different numbers of columns or if a column is out of range
+   * @throw std::invalid_argument if <code>chunk_rows</code> is zero
+   */
+  static bool read_samples(
+      std::istream& in, const std::vector<int>& columns, size_t chunk_rows,
+      const std::function<void(const Eigen::MatrixXd&)>& callback,
+      stan_csv_timing& timing, std::ostream* out) {
+    if (chunk_rows == 0)
+      throw std::invalid_argument("chunk_rows must be positive");
+    if (in.peek() == '#' || in.good() == false)
+      return false;
 
-    if (rows > 0) {
-      samples.resize(rows, cols);
-      for (int row = 0; row < rows; row++) {
-        std::getline(ss, line);
-        std::stringstream ls(line);
-        for (int col = 0; col < cols; col++) {
-          std::getline(ls, line, ',');
-          boost::trim(line);
-          std::stringstream(line) >> samples(row, col);
-        }
+    const size_t block_size = 1 << 20;
+    std::string buffer;
+    Eigen::MatrixXd chunk;
+    std::vector<int> targets;
+    int cols = -1;
+    size_t num_rows = 0;
+    int chunk_row = 0;
+    bool ok = true;
+    auto on_row = [&](const char* line, const char* line_end) {
+      if (!ok)
+        return;
+      if (targets.empty()) {
+        ok = column_targets(columns, cols, targets, out);
+        if (!ok)
+          return;
+        chunk.resize(chunk_rows, columns.empty() ? cols : columns.size());
       }
+      parse_row(line, line_end, targets, chunk, chunk_row);
+      if (++chunk_row == static_cast<int>(chunk_rows)) {
+        callback(chunk);
+        chunk_row = 0;
+      }
+    };
+    while (ok && in.good()) {
+      size_t size = buffer.size();
+      buffer.resize(size + block_size);
+      in.read(&buffer[size], block_size);
+      buffer.resize(size + in.gcount());
+      // only complete lines are scanned until the end of the stream
+      size_t complete = buffer.size();
+      if (in.good()) {
+        complete = buffer.rfind('\n');
+        if (complete == std::string::npos)
+          continue;
+        ++complete;
+      }
+      if (!scan_lines(buffer.data(), buffer.data() + complete, cols,
+                      num_rows, timing, out, on_row))
+        return false;
+      buffer.erase(0, complete);
+    }
+    if (!ok)
+      return false;
+    if (chunk_row > 0) {
+      chunk.conservativeResize(chunk_row, Eigen::NoChange);
+      callback(chunk);
     }
     return true;
   }
@@ -340,7 +458,83 @@ class stan_csv_reader {
    */
   static stan_csv parse(std::istream& in, std::ostream* out) {
     stan_csv data;
+    parse_preamble(in, data, out);
+    if (!read_samples(in, data.samples, data.timing, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading samples" << std::endl;
+    }
+    return data;
+  }
 
+  /**
+   * Parses the file, reading only the named columns of the samples.
+   * The header of the result holds the names of the selected columns
+   * in the order given, so the result can be passed to
+   * <code>stan::mcmc::chains</code>. As for the streaming overload, an
+   * empty selection reads all columns and keeps the whole header.
+   *
+   * @param[in] in input stream to parse
+   * @param[in] columns names of the columns to read, as in the header;
+   *   all columns if empty
+   * @param[out] out output stream to send messages
+   * @throw std::invalid_argument if the header cannot be read or does
+   *   not contain a selected column
+   */
+  static stan_csv parse(std::istream& in,
+                        const std::vector<std::string>& columns,
+                        std::ostream* out) {
+    stan_csv data;
+    parse_preamble(in, data, out);
+    std::vector<int> indices = column_indices(data.header, columns);
+    if (!columns.empty())
+      data.header = columns;
+    if (!read_samples(in, indices, data.samples, data.timing, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading samples" << std::endl;
+    }
+    return data;
+  }
+
+  /**
+   * Parses the file, passing the named columns of the samples to the
+   * callback in chunks of at most <code>chunk_rows</code> rows instead
+   * of keeping them. The samples of the result are empty; its header
+   * holds the names of the selected columns in the order given.
+   *
+   * @param[in] in input stream to parse
+   * @param[in] columns names of the columns to read, as in the header;
+   *   all columns if empty
+   * @param[in] chunk_rows maximum number of rows per chunk
+   * @param[in] callback called with each chunk, one row per draw
+   * @param[out] out output stream to send messages
+   * @throw std::invalid_argument if the header cannot be read or does
+   *   not contain a selected column
+   */
+  static stan_csv parse(
+      std::istream& in, const std::vector<std::string>& columns,
+      size_t chunk_rows,
+      const std::function<void(const Eigen::MatrixXd&)>& callback,
+      std::ostream* out) {
+    stan_csv data;
+    parse_preamble(in, data, out);
+    std::vector<int> indices = column_indices(data.header, columns);
+    if (!columns.empty())
+      data.header = columns;
+    if (!read_samples(in, indices, chunk_rows, callback, data.timing, out)) {
+      if (out)
+        *out << "Warning: non-fatal error reading samples" << std::endl;
+    }
+    return data;
+  }
+
+ private:
+  /**
+   * Reads the metadata, header and adaptation information.
+   *
+   * @throw std::invalid_argument if the header cannot be read
+   */
+  static void parse_preamble(std::istream& in, stan_csv& data,
+                             std::ostream* out) {
     if (!read_metadata(in, data.metadata, out)) {
       if (out)
         *out << "Warning: non-fatal error reading metadata" << std::endl;
@@ -359,13 +553,166 @@ class stan_csv_reader {
 
     data.timing.warmup = 0;
     data.timing.sampling = 0;
+  }
 
-    if (!read_samples(in, data.samples, data.timing, out)) {
-      if (out)
-        *out << "Warning: non-fatal error reading samples" << std::endl;
+  /**
+   * Scans the lines of the samples, adding timing comments to the
+   * timing and calling <code>on_row</code> with the start and end of
+   * each row of samples. Empty lines are skipped.
+   *
+   * @return false if the rows have different numbers of columns
+   */
+  template <typename F>
+  static bool scan_lines(const char* data, const char* data_end, int& cols,
+                         size_t& num_rows, stan_csv_timing& timing,
+                         std::ostream* out, const F& on_row) {
+    for (const char* line = data; line < data_end;) {
+      const char* line_end = static_cast<const char*>(
+          std::memchr(line, '\n', data_end - line));
+      if (line_end == nullptr)
+        line_end = data_end;
+      const char* next = line_end + (line_end < data_end);
+      if (line_end > line && line_end[-1] == '\r')
+        --line_end;
+
+      if (line_end == line) {
+        line = next;
+        continue;
+      }
+      if (*line == '#') {
+        read_timing(std::string(line, line_end), timing);
+      } else {
+        int current_cols = std::count(line, line_end, ',') + 1;
+        if (cols == -1) {
+          cols = current_cols;
+        } else if (cols != current_cols) {
+          if (out)
+            *out << "Error: expected " << cols << " columns, but found "
+                 << current_cols << " instead for row " << num_rows + 1
+                 << std::endl;
+          return false;
+        }
+        ++num_rows;
+        on_row(line, line_end);
+      }
+      line = next;
     }
+    return true;
+  }
 
-    return data;
+  /**
+   * Maps each column of the file up to the last selected one to its
+   * column in the samples, or to -1 if it is not selected.
+   *
+   * @return false if a selected column is out of range
+   */
+  static bool column_targets(const std::vector<int>& columns, int cols,
+                             std::vector<int>& targets, std::ostream* out) {
+    if (columns.empty()) {
+      targets.resize(cols);
+      for (int col = 0; col < cols; ++col)
+        targets[col] = col;
+      return true;
+    }
+    for (int column : columns) {
+      if (column < 0 || column >= cols) {
+        if (out)
+          *out << "Error: column " << column << " out of range, found "
+               << cols << " columns" << std::endl;
+        return false;
+      }
+    }
+    targets.assign(*std::max_element(columns.begin(), columns.end()) + 1, -1);
+    for (size_t n = 0; n < columns.size(); ++n)
+      targets[columns[n]] = n;
+    return true;
+  }
+
+  /**
+   * Parses the selected cells of the row starting at <code>p</code>
+   * into a row of the samples.
+   */
+  static void parse_row(const char* p, const char* end,
+                        const std::vector<int>& targets,
+                        Eigen::MatrixXd& samples, int row) {
+    for (int target : targets) {
+      if (target >= 0) {
+        p = parse_cell(p, end, samples(row, target));
+      } else {
+        while (p != end && *p != ',' && *p != '\n')
+          ++p;
+        if (p != end)
+          ++p;
+      }
+    }
+  }
+
+  /**
+   * Reads the rest of the stream into the buffer in large blocks.
+   */
+  static void read_all(std::istream& in, std::string& buffer) {
+    const size_t block_size = 1 << 20;
+    size_t size = 0;
+    while (in.good()) {
+      buffer.resize(size + block_size);
+      in.read(&buffer[size], block_size);
+      size += in.gcount();
+    }
+    buffer.resize(size);
+  }
+
+  /**
+   * Adds the elapsed time of a timing comment to the timing.
+   */
+  static void read_timing(const std::string& line, stan_csv_timing& timing) {
+    bool warmup = line.find("(Warm-up)") != std::string::npos;
+    if (!warmup && line.find("(Sampling)") == std::string::npos)
+      return;
+    int left = 17;
+    int right = line.find(" seconds");
+    double seconds;
+    std::stringstream(line.substr(left, right - left)) >> seconds;
+    if (warmup)
+      timing.warmup += seconds;
+    else
+      timing.sampling += seconds;
+  }
+
+  /**
+   * Parses the value of the cell starting at <code>p</code>, ignoring
+   * spaces around it. Like reading from a stream, a cell without a
+   * number is read as zero.
+   *
+   * @param[in] p start of the cell
+   * @param[in] end end of the buffer
+   * @param[out] x value
+   * @return start of the next cell
+   */
+  static const char* parse_cell(const char* p, const char* end, double& x) {
+    while (p != end && (*p == ' ' || *p == '\t'))
+      ++p;
+    if (parse_double(p, end, x) == p)
+      x = 0;
+    while (p != end && *p != ',' && *p != '\n')
+      ++p;
+    return p == end ? p : p + 1;
+  }
+
+  /**
+   * Return the number of threads used to parse the samples, which is
+   * one unless compiled with <code>STAN_THREADS</code>.
+   */
+  static int num_parse_threads(int rows, int cols) {
+#ifdef STAN_THREADS
+    const double min_values_per_thread = 1 << 16;
+    int num_threads = std::thread::hardware_concurrency();
+    return std::max(1, std::min(num_threads,
+                                static_cast<int>(static_cast<double>(rows)
+                                                 * cols
+                                                 / min_values_per_thread)));
+#else
+    return 1;
+#endif
   }
 };
 
@@ -1,6 +1,7 @@
 #ifndef STAN_IO_VAR_CONTEXT_HPP
 #define STAN_IO_VAR_CONTEXT_HPP
 
+#include <stan/io/array_view.hpp>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -111,6 +112,56 @@ class var_context {
    */
   virtual void names_i(std::vector<std::string>& names) const = 0;
 
+  /**
+   * Return a view of the floating point values of the variable of the
+   * specified name, in the order returned by <code>vals_r</code>.
+   *
+   * <p>Implementations that hold the values as doubles return a view
+   * of their storage without copying, valid as long as the context is
+   * not modified or destroyed. The default implementation returns a
+   * view owning the values returned by <code>vals_r</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the named variable.
+   */
+  virtual array_view<double> vals_r_view(const std::string& name) const {
+    return vals_r(name);
+  }
+
+  /**
+   * Return a view of the integer values of the variable of the
+   * specified name, in the order returned by <code>vals_i</code>.
+   * See <code>vals_r_view</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the values of the named variable.
+   */
+  virtual array_view<int> vals_i_view(const std::string& name) const {
+    return vals_i(name);
+  }
+
+  /**
+   * Return a view of the dimensions of the floating point variable of
+   * the specified name. See <code>vals_r_view</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the dimensions of the named variable.
+   */
+  virtual array_view<size_t> dims_r_view(const std::string& name) const {
+    return dims_r(name);
+  }
+
+  /**
+   * Return a view of the dimensions of the integer variable of the
+   * specified name. See <code>vals_r_view</code>.
+   *
+   * @param name Name of variable.
+   * @return View of the dimensions of the named variable.
+   */
+  virtual array_view<size_t> dims_i_view(const std::string& name) const {
+    return dims_i(name);
+  }
+
   /**
    * Check variable dimensions against variable declaration.
    *
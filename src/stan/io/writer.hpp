@@ -58,6 +58,18 @@ class writer {
    */
   ~writer() {}
 
+  /**
+   * Reserve space for the specified numbers of scalar and integer
+   * values, so that writing them does not reallocate.
+   *
+   * @param num_r Number of scalar values.
+   * @param num_i Number of integer values.
+   */
+  void reserve(size_t num_r, size_t num_i = 0) {
+    data_r_.reserve(num_r);
+    data_i_.reserve(num_i);
+  }
+
   /**
    * Return a reference to the underlying vector of real values
    * that have been written.
@@ -28,6 +28,8 @@ namespace lang {
  * @param filename name of file or other source from which input
  *   stream was derived
  * @param include_paths array of paths to search for included files
+ * @param profile true to generate code recording the cost of each
+ *   statement of the model's log density
  * @return <code>false</code> if code could not be generated due
  *   to syntax error in the Stan model; <code>true</code>
  *   otherwise.
@@ -36,7 +38,8 @@ bool compile(std::ostream* msgs, std::istream& in, std::ostream& out,
              const std::string& name, const bool allow_undefined = false,
              const std::string& filename = "unknown file name",
              const std::vector<std::string>& include_paths
-             = std::vector<std::string>()) {
+             = std::vector<std::string>(),
+             const bool profile = false) {
   io::program_reader reader(in, filename, include_paths);
   std::string s = reader.program();
   std::stringstream ss(s);
@@ -44,7 +47,7 @@ bool compile(std::ostream* msgs, std::istream& in, std::ostream& out,
   bool parse_succeeded = parse(msgs, ss, name, reader, prog, allow_undefined);
   if (!parse_succeeded)
     return false;
-  generate_cpp(prog, name, reader.history(), out);
+  generate_cpp(prog, name, reader.history(), out, profile);
   return true;
 }
 
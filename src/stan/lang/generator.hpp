@@ -15,6 +15,7 @@
 #include <stan/lang/generator/write_end_loop.hpp>
 #include <stan/lang/generator/write_nested_resize_loop_begin.hpp>
 #include <stan/lang/generator/write_resize_var_idx.hpp>
+#include <stan/lang/generator/write_std_vector_constraints_fn.hpp>
 #include <stan/lang/generator/write_var_idx_all_dims.hpp>
 #include <stan/lang/generator/write_var_idx_all_dims_msg.hpp>
 #include <stan/lang/generator/write_var_idx_array_dims.hpp>
@@ -42,6 +43,7 @@
 #include <stan/lang/generator/generate_constrained_param_names_method.hpp>
 #include <stan/lang/generator/generate_constructor.hpp>
 #include <stan/lang/generator/generate_cpp.hpp>
+#include <stan/lang/generator/generate_data_struct.hpp>
 #include <stan/lang/generator/generate_data_var_init.hpp>
 #include <stan/lang/generator/generate_destructor.hpp>
 #include <stan/lang/generator/generate_dims_method.hpp>
@@ -69,6 +71,8 @@
 #include <stan/lang/generator/generate_log_prob.hpp>
 #include <stan/lang/generator/generate_member_var_decls.hpp>
 #include <stan/lang/generator/generate_member_var_decls_all.hpp>
+#include <stan/lang/generator/generate_member_var_refs.hpp>
+#include <stan/lang/generator/generate_member_var_refs_all.hpp>
 #include <stan/lang/generator/generate_model_name_method.hpp>
 #include <stan/lang/generator/generate_model_compile_info_method.hpp>
 #include <stan/lang/generator/generate_model_typedef.hpp>
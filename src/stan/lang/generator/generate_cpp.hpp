@@ -7,6 +7,7 @@
 #include <stan/lang/generator/generate_class_decl_end.hpp>
 #include <stan/lang/generator/generate_constrained_param_names_method.hpp>
 #include <stan/lang/generator/generate_constructor.hpp>
+#include <stan/lang/generator/generate_data_struct.hpp>
 #include <stan/lang/generator/generate_destructor.hpp>
 #include <stan/lang/generator/generate_dims_method.hpp>
 #include <stan/lang/generator/generate_functions.hpp>
@@ -14,7 +15,7 @@
 #include <stan/lang/generator/generate_includes.hpp>
 #include <stan/lang/generator/generate_transform_inits_method.hpp>
 #include <stan/lang/generator/generate_log_prob.hpp>
-#include <stan/lang/generator/generate_member_var_decls_all.hpp>
+#include <stan/lang/generator/generate_member_var_refs_all.hpp>
 #include <stan/lang/generator/generate_model_name_method.hpp>
 #include <stan/lang/generator/generate_model_compile_info_method.hpp>
 #include <stan/lang/generator/generate_model_typedef.hpp>
@@ -48,10 +49,12 @@ namespace lang {
  * @param[in] history I/O include history for text underlying
  *   program
  * @param[in,out] o stream for generating
+ * @param[in] profile true to generate profiling of the statements
+ *   in <code>log_prob</code>
  */
 void generate_cpp(const program& prog, const std::string& model_name,
                   const std::vector<io::preproc_event>& history,
-                  std::ostream& o) {
+                  std::ostream& o, bool profile = false) {
   generate_version_comment(o);
   generate_includes(o);
   generate_namespace_start(model_name, o);
@@ -59,14 +62,15 @@ void generate_cpp(const program& prog, const std::string& model_name,
   generate_globals(o);
   generate_program_reader_fun(history, o);
   generate_functions(prog.function_decl_defs_, o);
+  generate_data_struct(prog, model_name, o);
   generate_class_decl(model_name, o);
   generate_private_decl(o);
-  generate_member_var_decls_all(prog, o);
+  generate_member_var_refs_all(prog, model_name, o);
   generate_public_decl(o);
   generate_constructor(prog, model_name, o);
   generate_destructor(model_name, o);
   generate_transform_inits_method(prog.parameter_decl_, o);
-  generate_log_prob(prog, o);
+  generate_log_prob(prog, o, profile);
   generate_param_names_method(prog, o);
   generate_dims_method(prog, o);
   generate_write_array_method(prog, model_name, o);
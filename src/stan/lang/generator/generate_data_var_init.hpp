@@ -41,7 +41,8 @@ void generate_data_var_init(const block_var_decl& var_decl, int indent,
     vals = "vals_i";
 
   generate_indent(indent, o);
-  o << vals << "__ = context__." << vals << "(\"" << var_name << "\");" << EOL;
+  o << vals << "__ = context__." << vals << "_view(\"" << var_name << "\");"
+    << EOL;
   generate_indent(indent, o);
   o << "pos__ = 0;" << EOL;
 
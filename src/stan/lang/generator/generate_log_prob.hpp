@@ -22,10 +22,16 @@ namespace lang {
  * Generate the log_prob method for the model class for the
  * specified program on the specified stream.
  *
+ * <p>If <code>profile</code> is true, each statement of the
+ * transformed parameters and model blocks records its forward and
+ * reverse pass time with <code>stan::model::profile_statement</code>.
+ *
  * @param prog program node of ast
  * @param o stream for generating
+ * @param profile true to generate profiling of statements
  */
-void generate_log_prob(const program& prog, std::ostream& o) {
+void generate_log_prob(const program& prog, std::ostream& o,
+                       bool profile = false) {
   o << EOL;
   o << INDENT << "template <bool propto__, bool jacobian__, typename T__>"
     << EOL;
@@ -72,7 +78,10 @@ void generate_log_prob(const program& prog, std::ostream& o) {
 
   if (prog.derived_decl_.second.size() > 0) {
     generate_comment("transformed parameters block statements", 3, o);
-    generate_statements(prog.derived_decl_.second, 3, o);
+    if (profile)
+      generate_profiled_statements(prog.derived_decl_.second, 3, o);
+    else
+      generate_statements(prog.derived_decl_.second, 3, o);
     o << EOL;
   }
 
@@ -97,7 +106,10 @@ void generate_log_prob(const program& prog, std::ostream& o) {
   }
 
   generate_comment("model body", 3, o);
-  generate_statement(prog.statement_, 3, o);
+  if (profile)
+    generate_profiled_statement(prog.statement_, 3, o);
+  else
+    generate_statement(prog.statement_, 3, o);
   o << EOL;
 
   generate_catch_throw_located(2, o);
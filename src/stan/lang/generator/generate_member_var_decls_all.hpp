@@ -9,9 +9,9 @@ namespace stan {
 namespace lang {
 
 /**
- * Generate member variable declarations for the data and
- * transformed data blocks for the specified program, writing to
- * the specified stream.
+ * Generate member variable declarations of the data struct for the
+ * data and transformed data blocks for the specified program,
+ * writing to the specified stream.
  *
  * @param[in] prog program from which to generate
  * @param[in,out] o stream for generating
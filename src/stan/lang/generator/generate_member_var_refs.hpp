@@ -0,0 +1,37 @@
+#ifndef STAN_LANG_GENERATOR_GENERATE_MEMBER_VAR_REFS_HPP
+#define STAN_LANG_GENERATOR_GENERATE_MEMBER_VAR_REFS_HPP
+
+#include <stan/lang/ast.hpp>
+#include <stan/lang/generator/constants.hpp>
+#include <stan/lang/generator/generate_indent.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace lang {
+
+/**
+ * Generate model class member declarations of constant references
+ * to the variables declared in data and transformed data blocks,
+ * which are held by the data struct with the specified name, at the
+ * specified indentation level to the specified stream.
+ *
+ * @param[in] vs variable declarations
+ * @param[in] data_struct_name name of the struct holding the data
+ * @param[in] indent indentation level
+ * @param[in] o stream for writing
+ */
+void generate_member_var_refs(const std::vector<block_var_decl>& vs,
+                              const std::string& data_struct_name,
+                              int indent, std::ostream& o) {
+  for (size_t i = 0; i < vs.size(); ++i) {
+    generate_indent(2 * indent, o);
+    o << "const decltype(" << data_struct_name << "::" << vs[i].name()
+      << ")& " << vs[i].name() << ";" << EOL;
+  }
+}
+
+}  // namespace lang
+}  // namespace stan
+#endif
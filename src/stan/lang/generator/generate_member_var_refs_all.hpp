@@ -0,0 +1,37 @@
+#ifndef STAN_LANG_GENERATOR_GENERATE_MEMBER_VAR_REFS_ALL_HPP
+#define STAN_LANG_GENERATOR_GENERATE_MEMBER_VAR_REFS_ALL_HPP
+
+#include <stan/lang/ast.hpp>
+#include <stan/lang/generator/constants.hpp>
+#include <stan/lang/generator/generate_member_var_refs.hpp>
+#include <ostream>
+#include <string>
+
+namespace stan {
+namespace lang {
+
+/**
+ * Generate the model class members giving access to the data: a
+ * shared pointer to the data struct of the model and constant
+ * references to each of its data and transformed data variables,
+ * so that the model code reads the variables by name as if they were
+ * members of the model.
+ *
+ * @param[in] prog program from which to generate
+ * @param[in] model_name name of model for class name
+ * @param[in,out] o stream for generating
+ */
+void generate_member_var_refs_all(const program& prog,
+                                  const std::string& model_name,
+                                  std::ostream& o) {
+  std::string data_struct_name = model_name + "_data__";
+  o << INDENT << "std::shared_ptr<const " << data_struct_name << "> data__;"
+    << EOL;
+  generate_member_var_refs(prog.data_decl_, data_struct_name, 1, o);
+  generate_member_var_refs(prog.derived_data_decl_.first, data_struct_name, 1,
+                           o);
+}
+
+}  // namespace lang
+}  // namespace stan
+#endif
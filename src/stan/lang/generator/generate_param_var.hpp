@@ -9,6 +9,7 @@
 #include <stan/lang/generator/write_constraints_fn.hpp>
 #include <stan/lang/generator/write_end_loop.hpp>
 #include <stan/lang/generator/write_nested_resize_loop_begin.hpp>
+#include <stan/lang/generator/write_std_vector_constraints_fn.hpp>
 #include <stan/lang/generator/write_resize_var_idx.hpp>
 #include <iostream>
 #include <ostream>
@@ -48,6 +49,20 @@ void generate_param_var(const block_var_decl &var_decl, bool gen_decl_stmt,
     o << " " << var_name << ";" << EOL;
   }
 
+  // one-dimensional arrays of reals are constrained as one block
+  if (is_std_vector_param(var_decl)) {
+    std::string block_str = write_std_vector_constraints_fn(btype, dims[0]);
+    generate_indent(indent, o);
+    o << "if (jacobian__)" << EOL;
+    generate_indent(indent + 1, o);
+    o << var_name << " = in__." << block_str << ", lp__);" << EOL;
+    generate_indent(indent, o);
+    o << "else" << EOL;
+    generate_indent(indent + 1, o);
+    o << var_name << " = in__." << block_str << ");" << EOL;
+    return;
+  }
+
   // init
   write_nested_resize_loop_begin(var_name, dims, indent, o);
 
@@ -10,6 +10,7 @@
 #include <stan/lang/generator/write_end_loop.hpp>
 #include <stan/lang/generator/write_nested_resize_loop_begin.hpp>
 #include <stan/lang/generator/write_resize_var_idx.hpp>
+#include <stan/lang/generator/write_std_vector_constraints_fn.hpp>
 #include <stan/lang/generator/write_var_idx_all_dims.hpp>
 #include <ostream>
 #include <string>
@@ -42,6 +43,12 @@ void generate_read_transform_params(const std::vector<block_var_decl>& vs,
       o << " = in__." << write_constraints_fn(vtype, "constrain") << ");"
         << EOL;
 
+    } else if (is_std_vector_param(vs[i])) {
+      // read/transform one-dimensional array of reals as one block
+      o << " = in__."
+        << write_std_vector_constraints_fn(el_type, vtype.array_lens()[0])
+        << ");" << EOL;
+
     } else {
       o << ";" << EOL;
 
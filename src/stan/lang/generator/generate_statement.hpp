@@ -5,8 +5,10 @@
 #include <stan/lang/generator/constants.hpp>
 #include <stan/lang/generator/is_numbered_statement_vis.hpp>
 #include <stan/lang/generator/generate_indent.hpp>
+#include <stan/lang/generator/generate_local_var_decl_inits.hpp>
 #include <stan/lang/generator/statement_visgen.hpp>
 #include <boost/variant/apply_visitor.hpp>
+#include <boost/variant/get.hpp>
 #include <ostream>
 
 namespace stan {
@@ -32,6 +34,52 @@ void generate_statement(const statement& s, int indent, std::ostream& o) {
   boost::apply_visitor(vis, s.statement_);
 }
 
+/**
+ * Generate the specified statement as <code>generate_statement</code>
+ * does, enclosed in a scope that records its cost with
+ * <code>stan::model::profile_statement</code> under the line number
+ * where it begins. The local variables of a block are declared
+ * outside the profiled scopes and each statement in the block is
+ * profiled separately.
+ *
+ * @param[in] s statement to generate
+ * @param[in] indent indentation level
+ * @param[in,out] o stream for generating
+ */
+void generate_profiled_statement(const statement& s, int indent,
+                                 std::ostream& o) {
+  const statements* block = boost::get<statements>(&s.statement_);
+  if (block) {
+    bool has_local_vars = block->local_decl_.size() > 0;
+    if (has_local_vars) {
+      generate_indent(indent, o);
+      o << "{" << EOL;
+      generate_local_var_decl_inits(block->local_decl_, indent, o);
+    }
+    o << EOL;
+    for (size_t i = 0; i < block->statements_.size(); ++i)
+      generate_profiled_statement(block->statements_[i], indent, o);
+    if (has_local_vars) {
+      generate_indent(indent, o);
+      o << "}" << EOL;
+    }
+    return;
+  }
+  is_numbered_statement_vis vis_is_numbered;
+  if (!boost::apply_visitor(vis_is_numbered, s.statement_)) {
+    generate_statement(s, indent, o);
+    return;
+  }
+  generate_indent(indent, o);
+  o << "{" << EOL;
+  generate_indent(indent + 1, o);
+  o << "stan::model::profile_statement<local_scalar_t__> profile__("
+    << s.begin_line_ << ");" << EOL;
+  generate_statement(s, indent + 1, o);
+  generate_indent(indent, o);
+  o << "}" << EOL;
+}
+
 }  // namespace lang
 }  // namespace stan
 #endif
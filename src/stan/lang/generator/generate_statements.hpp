@@ -23,6 +23,21 @@ void generate_statements(const std::vector<statement> statements, int indent,
     generate_statement(statements[i], indent, o);
 }
 
+/**
+ * Generate the set of statements in a program block with
+ * the specified indentation level on the specified stream, each
+ * recording its cost as by <code>generate_profiled_statement</code>.
+ *
+ * @param[in] statements vector of statements
+ * @param[in] indent indentation level
+ * @param[in,out] o stream for generating
+ */
+void generate_profiled_statements(const std::vector<statement> statements,
+                                  int indent, std::ostream& o) {
+  for (size_t i = 0; i < statements.size(); ++i)
+    generate_profiled_statement(statements[i], indent, o);
+}
+
 }  // namespace lang
 }  // namespace stan
 #endif
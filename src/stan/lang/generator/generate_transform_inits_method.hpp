@@ -40,11 +40,12 @@ void generate_method_begin(std::ostream& o) {
   o << INDENT2 << "typedef double local_scalar_t__;" << EOL;
   o << INDENT2 << "stan::io::writer<double> "
     << "writer__(params_r__, params_i__);" << EOL;
+  o << INDENT2 << "writer__.reserve(num_params_r__);" << EOL;
 
   o << INDENT2 << "size_t pos__;" << EOL;
   o << INDENT2 << "(void) pos__; // dummy call to suppress warning" << EOL;
-  o << INDENT2 << "std::vector<double> vals_r__;" << EOL;
-  o << INDENT2 << "std::vector<int> vals_i__;" << EOL;
+  o << INDENT2 << "stan::io::array_view<double> vals_r__;" << EOL;
+  o << INDENT2 << "stan::io::array_view<int> vals_i__;" << EOL;
 }
 
 /**
@@ -54,8 +55,8 @@ void generate_method_begin(std::ostream& o) {
  * @param[in,out] o stream for generating
  */
 void generate_method_end(std::ostream& o) {
-  o << INDENT2 << "params_r__ = writer__.data_r();" << EOL;
-  o << INDENT2 << "params_i__ = writer__.data_i();" << EOL;
+  o << INDENT2 << "params_r__ = std::move(writer__.data_r());" << EOL;
+  o << INDENT2 << "params_i__ = std::move(writer__.data_i());" << EOL;
   o << INDENT << "}" << EOL2;
 
   o << INDENT << "void transform_inits(const stan::io::var_context& context,"
@@ -68,9 +69,9 @@ void generate_method_end(std::ostream& o) {
   o << INDENT
     << "  transform_inits(context, params_i_vec, params_r_vec, pstream__);"
     << EOL;
-  o << INDENT << "  params_r.resize(params_r_vec.size());" << EOL;
-  o << INDENT << "  for (int i = 0; i < params_r.size(); ++i)" << EOL;
-  o << INDENT << "    params_r(i) = params_r_vec[i];" << EOL;
+  o << INDENT << "  params_r = Eigen::Map<Eigen::Matrix<double, "
+    << "Eigen::Dynamic, 1> >(" << EOL;
+  o << INDENT << "      params_r_vec.data(), params_r_vec.size());" << EOL;
   o << INDENT << "}" << EOL2;
 }
 
@@ -115,7 +116,7 @@ void generate_transform_inits_method(const std::vector<block_var_decl>& vs,
       << " missing\")), current_statement_begin__, prog_reader__());" << EOL;
     // init context position
     generate_indent(indent, o);
-    o << "vals_r__ = context__.vals_r(\"" << var_name << "\");" << EOL;
+    o << "vals_r__ = context__.vals_r_view(\"" << var_name << "\");" << EOL;
     generate_indent(indent, o);
     o << "pos__ = 0U;" << EOL;
 
@@ -0,0 +1,53 @@
+#ifndef STAN_LANG_GENERATOR_WRITE_STD_VECTOR_CONSTRAINTS_FN_HPP
+#define STAN_LANG_GENERATOR_WRITE_STD_VECTOR_CONSTRAINTS_FN_HPP
+
+#include <stan/lang/ast.hpp>
+#include <stan/lang/generator/constants.hpp>
+#include <stan/lang/generator/generate_expression.hpp>
+#include <stan/lang/generator/write_constraints_fn.hpp>
+#include <sstream>
+#include <string>
+
+namespace stan {
+namespace lang {
+
+/**
+ * Return true if the variable with the specified declaration is a
+ * one-dimensional array of reals, which the generated code reads as
+ * a single block with the <code>std_vector</code> constrain
+ * functions of <code>stan::io::reader</code>.
+ *
+ * @param[in] var_decl block variable declaration
+ * @return true if the variable is a one-dimensional array of reals
+ */
+bool is_std_vector_param(const block_var_decl& var_decl) {
+  return var_decl.type().array_dims() == 1
+         && var_decl.type().innermost_type().bare_type().is_double_type();
+}
+
+/**
+ * Generate the name of the function constraining a one-dimensional
+ * array of reals of the specified element type and size as a single
+ * block, together with the expressions for the bounds parameters,
+ * if any, and the size. The argument list is left open so that the
+ * log density may be appended.
+ *
+ * @param[in] btype block var type of the array elements
+ * @param[in] size size of the array
+ */
+std::string write_std_vector_constraints_fn(const block_var_type& btype,
+                                            const expression& size) {
+  // scalar_<transform>_constrain(<bounds> becomes
+  // std_vector_<transform>_constrain(<bounds>, <size>
+  std::string fn(write_constraints_fn(btype, "constrain"));
+  std::stringstream ss;
+  ss << "std_vector" << fn.substr(std::string("scalar").size());
+  if (fn[fn.size() - 1] != '(')
+    ss << ", ";
+  generate_expression(size, NOT_USER_FACING, ss);
+  return ss.str();
+}
+
+}  // namespace lang
+}  // namespace stan
+#endif
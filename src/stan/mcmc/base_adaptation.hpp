@@ -1,6 +1,9 @@
 #ifndef STAN_MCMC_BASE_ADAPTATION_HPP
 #define STAN_MCMC_BASE_ADAPTATION_HPP
 
+#include <istream>
+#include <ostream>
+
 namespace stan {
 
 namespace mcmc {
@@ -8,6 +11,20 @@ namespace mcmc {
 class base_adaptation {
  public:
   virtual void restart() {}
+
+  /**
+   * Writes the adaptation state to a checkpoint stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  virtual void write_checkpoint(std::ostream& o) {}
+
+  /**
+   * Restores the state written by <code>write_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  virtual void read_checkpoint(std::istream& i) {}
 };
 
 }  // namespace mcmc
@@ -1,6 +1,9 @@
 #ifndef STAN_MCMC_BASE_ADAPTER_HPP
 #define STAN_MCMC_BASE_ADAPTER_HPP
 
+#include <istream>
+#include <ostream>
+
 namespace stan {
 namespace mcmc {
 
@@ -14,6 +17,26 @@ class base_adapter {
 
   bool adapting() { return adapt_flag_; }
 
+  /**
+   * Writes whether adaptation is engaged along with the state of
+   * each adaptation to a checkpoint stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  virtual void write_adaptation_checkpoint(std::ostream& o) {
+    o << adapt_flag_ << ' ';
+  }
+
+  /**
+   * Restores the state written by
+   * <code>write_adaptation_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  virtual void read_adaptation_checkpoint(std::istream& i) {
+    i >> adapt_flag_;
+  }
+
  protected:
   bool adapt_flag_;
 };
@@ -3,7 +3,9 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
+#include <stan/mcmc/performance_counters.hpp>
 #include <stan/mcmc/sample.hpp>
+#include <istream>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -29,6 +31,40 @@ class base_mcmc {
       std::vector<std::string>& model_names, std::vector<std::string>& names) {}
 
   virtual void get_sampler_diagnostics(std::vector<double>& values) {}
+
+  /**
+   * Writes the state needed to continue the chain, excluding the
+   * random number generator and any adaptation, to a checkpoint
+   * stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  virtual void write_checkpoint(std::ostream& o) {}
+
+  /**
+   * Restores the state written by <code>write_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  virtual void read_checkpoint(std::istream& i) {}
+
+  /**
+   * Sets the evaluation and integrator counters accumulated by the
+   * sampler since construction. Counters the sampler does not track
+   * are left unchanged.
+   *
+   * @param[in,out] counters performance counters
+   */
+  virtual void get_performance_counters(performance_counters& counters) {}
+
+  /**
+   * Turns timing of the model evaluations reported by
+   * <code>get_performance_counters</code> on or off. Timing is off
+   * by default.
+   *
+   * @param[in] timing true to time model evaluations
+   */
+  virtual void set_performance_timing(bool timing) {}
 };
 
 }  // namespace mcmc
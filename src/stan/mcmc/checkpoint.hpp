@@ -0,0 +1,107 @@
+#ifndef STAN_MCMC_CHECKPOINT_HPP
+#define STAN_MCMC_CHECKPOINT_HPP
+
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+namespace mcmc {
+
+/**
+ * Writes a scalar to a checkpoint stream followed by a space.
+ *
+ * Values are written in text form; the caller is responsible for
+ * setting the precision of the stream to
+ * <code>std::numeric_limits<double>::max_digits10</code> so that
+ * values round trip exactly.
+ *
+ * @param[in,out] o checkpoint stream
+ * @param[in] x value
+ */
+inline void write_checkpoint_value(std::ostream& o, double x) {
+  o << x << ' ';
+}
+
+/**
+ * Reads a scalar written by <code>write_checkpoint_value</code>.
+ *
+ * Non-finite values are parsed with <code>std::strtod</code>, which
+ * accepts the <code>inf</code> and <code>nan</code> tokens written
+ * by the standard streams.
+ *
+ * @param[in,out] i checkpoint stream
+ * @param[out] x value
+ * @throw std::invalid_argument if the next token is not a number
+ */
+inline void read_checkpoint_value(std::istream& i, double& x) {
+  std::string token;
+  i >> token;
+  char* end = nullptr;
+  x = std::strtod(token.c_str(), &end);
+  if (token.empty() || *end != '\0')
+    throw std::invalid_argument("Malformed checkpoint: expected a number, "
+                                "found \""
+                                + token + "\"");
+}
+
+/**
+ * Reads an integral value written by <code>operator<<</code>.
+ *
+ * @tparam T integral type
+ * @param[in,out] i checkpoint stream
+ * @param[out] x value
+ * @throw std::invalid_argument if the next token is not an integer
+ */
+template <typename T>
+inline void read_checkpoint_integer(std::istream& i, T& x) {
+  if (!(i >> x))
+    throw std::invalid_argument(
+        "Malformed checkpoint: expected an integer.");
+}
+
+/**
+ * Writes the dimensions and then the values, in column major order,
+ * of an Eigen matrix or vector to a checkpoint stream.
+ *
+ * @tparam EigMat type of Eigen matrix
+ * @param[in,out] o checkpoint stream
+ * @param[in] x matrix
+ */
+template <typename EigMat>
+inline void write_checkpoint_values(std::ostream& o, const EigMat& x) {
+  o << x.rows() << ' ' << x.cols() << ' ';
+  for (int n = 0; n < x.size(); ++n)
+    write_checkpoint_value(o, x(n));
+}
+
+/**
+ * Reads an Eigen matrix or vector written by
+ * <code>write_checkpoint_values</code>. The dimensions in the stream
+ * must match the dimensions of the destination.
+ *
+ * @tparam EigMat type of Eigen matrix
+ * @param[in,out] i checkpoint stream
+ * @param[in,out] x matrix
+ * @throw std::invalid_argument if the stored dimensions do not match
+ */
+template <typename EigMat>
+inline void read_checkpoint_values(std::istream& i, EigMat& x) {
+  Eigen::Index rows = 0;
+  Eigen::Index cols = 0;
+  read_checkpoint_integer(i, rows);
+  read_checkpoint_integer(i, cols);
+  if (rows != x.rows() || cols != x.cols())
+    throw std::invalid_argument(
+        "Malformed checkpoint: dimension mismatch "
+        "between checkpoint and sampler.");
+  for (int n = 0; n < x.size(); ++n)
+    read_checkpoint_value(i, x(n));
+}
+
+}  // namespace mcmc
+}  // namespace stan
+#endif
@@ -38,8 +38,39 @@ class covar_adaptation : public windowed_adaptation {
     return false;
   }
 
+  void write_checkpoint(std::ostream& o) {
+    windowed_adaptation::write_checkpoint(o);
+    estimator_.write_checkpoint(o);
+  }
+
+  void read_checkpoint(std::istream& i) {
+    windowed_adaptation::read_checkpoint(i);
+    estimator_.read_checkpoint(i);
+  }
+
  protected:
-  stan::math::welford_covar_estimator estimator_;
+  /**
+   * Welford covariance estimator whose running sums can be written to
+   * and restored from a checkpoint.
+   */
+  class estimator : public stan::math::welford_covar_estimator {
+   public:
+    explicit estimator(int n) : stan::math::welford_covar_estimator(n) {}
+
+    void write_checkpoint(std::ostream& o) {
+      write_checkpoint_value(o, num_samples_);
+      write_checkpoint_values(o, m_);
+      write_checkpoint_values(o, m2_);
+    }
+
+    void read_checkpoint(std::istream& i) {
+      read_checkpoint_value(i, num_samples_);
+      read_checkpoint_values(i, m_);
+      read_checkpoint_values(i, m2_);
+    }
+  };
+
+  estimator estimator_;
 };
 
 }  // namespace mcmc
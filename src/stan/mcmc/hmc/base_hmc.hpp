@@ -4,7 +4,9 @@
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/checkpoint.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <stan/mcmc/performance_counters.hpp>
 #include <boost/random/uniform_01.hpp>
 #include <cmath>
 #include <limits>
@@ -63,6 +65,41 @@ class base_hmc : public base_mcmc {
     write_sampler_metric(writer);
   }
 
+  /**
+   * Writes the step size, step size jitter and current point
+   * (including the metric) to a checkpoint stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  void write_checkpoint(std::ostream& o) {
+    write_checkpoint_value(o, nom_epsilon_);
+    write_checkpoint_value(o, epsilon_);
+    write_checkpoint_value(o, epsilon_jitter_);
+    z_.write_checkpoint(o);
+  }
+
+  /**
+   * Restores the state written by <code>write_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  void read_checkpoint(std::istream& i) {
+    read_checkpoint_value(i, nom_epsilon_);
+    read_checkpoint_value(i, epsilon_);
+    read_checkpoint_value(i, epsilon_jitter_);
+    z_.read_checkpoint(i);
+  }
+
+  void get_performance_counters(performance_counters& counters) {
+    counters.num_log_prob_evals = hamiltonian_.num_log_prob_evals();
+    counters.num_gradient_evals = hamiltonian_.num_gradient_evals();
+    counters.num_leapfrog_steps = integrator_.num_steps();
+    counters.log_prob_seconds = hamiltonian_.log_prob_seconds();
+    counters.ad_arena_bytes = hamiltonian_.ad_arena_bytes();
+  }
+
+  void set_performance_timing(bool timing) { hamiltonian_.set_timing(timing); }
+
   void get_sampler_diagnostic_names(std::vector<std::string>& model_names,
                                     std::vector<std::string>& names) {
     z_.get_param_names(model_names, names);
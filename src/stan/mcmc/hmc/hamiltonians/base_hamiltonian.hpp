@@ -3,8 +3,11 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
-#include <stan/model/gradient.hpp>
+#include <stan/math/rev.hpp>
+#include <stan/model/gradient_evaluator.hpp>
 #include <stan/model/log_prob_propto.hpp>
+#include <chrono>
+#include <cstddef>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
@@ -16,7 +19,13 @@ namespace mcmc {
 template <class Model, class Point, class BaseRNG>
 class base_hamiltonian {
  public:
-  explicit base_hamiltonian(const Model& model) : model_(model) {}
+  explicit base_hamiltonian(const Model& model)
+      : model_(model),
+        gradient_(model, model.num_params_r()),
+        num_log_prob_evals_(0),
+        num_gradient_evals_(0),
+        log_prob_seconds_(0),
+        timing_(false) {}
 
   ~base_hamiltonian() {}
 
@@ -50,23 +59,30 @@ class base_hamiltonian {
   }
 
   void update_potential(Point& z, callbacks::logger& logger) {
+    auto start = start_timer();
     try {
-      z.V = -stan::model::log_prob_propto<true>(model_, z.q);
+      z.V = -stan::model::internal::log_prob_propto_default<true>(model_,
+                                                                  z.q);
     } catch (const std::exception& e) {
       this->write_error_msg_(e, logger);
       z.V = std::numeric_limits<double>::infinity();
     }
+    ++num_log_prob_evals_;
+    add_log_prob_time(start);
   }
 
   void update_potential_gradient(Point& z, callbacks::logger& logger) {
+    auto start = start_timer();
     try {
-      stan::model::gradient(model_, z.q, z.V, z.g, logger);
+      gradient_(z.q, z.V, z.g, logger);
       z.V = -z.V;
     } catch (const std::exception& e) {
       this->write_error_msg_(e, logger);
       z.V = std::numeric_limits<double>::infinity();
     }
     z.g = -z.g;
+    ++num_gradient_evals_;
+    add_log_prob_time(start);
   }
 
   void update_metric(Point& z, callbacks::logger& logger) {}
@@ -77,8 +93,69 @@ class base_hamiltonian {
     update_potential_gradient(z, logger);
   }
 
+  /**
+   * Return the number of log density evaluations without gradient.
+   *
+   * @return number of evaluations
+   */
+  size_t num_log_prob_evals() const { return num_log_prob_evals_; }
+
+  /**
+   * Return the number of log density and gradient evaluations.
+   *
+   * @return number of evaluations
+   */
+  size_t num_gradient_evals() const { return num_gradient_evals_; }
+
+  /**
+   * Return the seconds spent evaluating the log density, with or
+   * without gradient, while timing was on.
+   *
+   * @return seconds
+   */
+  double log_prob_seconds() const { return log_prob_seconds_; }
+
+  /**
+   * Turns timing of the log density evaluations on or off. Timing is
+   * off by default so that evaluations do not read the clock unless
+   * the times are reported.
+   *
+   * @param[in] timing true to time evaluations
+   */
+  void set_timing(bool timing) { timing_ = timing; }
+
+  /**
+   * Return the bytes held by the autodiff arena of the calling
+   * thread. The arena keeps its blocks between gradient evaluations,
+   * so this is the largest amount of autodiff memory a single
+   * evaluation has needed so far, not a count of allocations.
+   *
+   * @return bytes held by the arena
+   */
+  size_t ad_arena_bytes() const {
+    return stan::math::ChainableStack::instance_->memalloc_.bytes_allocated();
+  }
+
  protected:
   const Model& model_;
+  stan::model::gradient_evaluator<Model> gradient_;
+  size_t num_log_prob_evals_;
+  size_t num_gradient_evals_;
+  double log_prob_seconds_;
+  bool timing_;
+
+  std::chrono::steady_clock::time_point start_timer() const {
+    return timing_ ? std::chrono::steady_clock::now()
+                   : std::chrono::steady_clock::time_point();
+  }
+
+  void add_log_prob_time(std::chrono::steady_clock::time_point start) {
+    if (!timing_)
+      return;
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    log_prob_seconds_ += elapsed.count();
+  }
 
   void write_error_msg_(const std::exception& e, callbacks::logger& logger) {
     logger.error(
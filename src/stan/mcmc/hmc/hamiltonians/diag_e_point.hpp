@@ -49,6 +49,27 @@ class diag_e_point : public ps_point {
       inv_e_metric_ss << ", " << inv_e_metric_(i);
     writer(inv_e_metric_ss.str());
   }
+
+  /**
+   * Writes the phase space point followed by the inverse mass matrix
+   * to a checkpoint stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  inline void write_checkpoint(std::ostream& o) {
+    ps_point::write_checkpoint(o);
+    write_checkpoint_values(o, inv_e_metric_);
+  }
+
+  /**
+   * Restores the state written by <code>write_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  inline void read_checkpoint(std::istream& i) {
+    ps_point::read_checkpoint(i);
+    read_checkpoint_values(i, inv_e_metric_);
+  }
 };
 
 }  // namespace mcmc
@@ -2,6 +2,7 @@
 #define STAN_MCMC_HMC_HAMILTONIANS_PS_POINT_HPP
 
 #include <stan/callbacks/writer.hpp>
+#include <stan/mcmc/checkpoint.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <boost/lexical_cast.hpp>
 #include <string>
@@ -50,6 +51,31 @@ class ps_point {
    * @param writer writer callback
    */
   virtual inline void write_metric(stan::callbacks::writer& writer) {}
+
+  /**
+   * Writes the position, momentum, gradient and potential to a
+   * checkpoint stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  virtual inline void write_checkpoint(std::ostream& o) {
+    write_checkpoint_values(o, q);
+    write_checkpoint_values(o, p);
+    write_checkpoint_values(o, g);
+    write_checkpoint_value(o, V);
+  }
+
+  /**
+   * Restores the state written by <code>write_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  virtual inline void read_checkpoint(std::istream& i) {
+    read_checkpoint_values(i, q);
+    read_checkpoint_values(i, p);
+    read_checkpoint_values(i, g);
+    read_checkpoint_value(i, V);
+  }
 };
 
 }  // namespace mcmc
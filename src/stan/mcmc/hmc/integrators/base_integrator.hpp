@@ -2,6 +2,7 @@
 #define STAN_MCMC_HMC_INTEGRATORS_BASE_INTEGRATOR_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <cstddef>
 
 namespace stan {
 namespace mcmc {
@@ -9,12 +10,22 @@ namespace mcmc {
 template <class Hamiltonian>
 class base_integrator {
  public:
-  base_integrator() {}
+  base_integrator() : num_steps_(0) {}
 
   virtual void evolve(typename Hamiltonian::PointType& z,
                       Hamiltonian& hamiltonian, const double epsilon,
                       callbacks::logger& logger)
       = 0;
+
+  /**
+   * Return the number of steps taken since construction.
+   *
+   * @return number of steps
+   */
+  size_t num_steps() const { return num_steps_; }
+
+ protected:
+  size_t num_steps_;
 };
 
 }  // namespace mcmc
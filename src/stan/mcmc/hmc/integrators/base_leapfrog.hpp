@@ -19,6 +19,7 @@ class base_leapfrog : public base_integrator<Hamiltonian> {
     begin_update_p(z, hamiltonian, 0.5 * epsilon, logger);
     update_q(z, hamiltonian, epsilon, logger);
     end_update_p(z, hamiltonian, 0.5 * epsilon, logger);
+    ++this->num_steps_;
   }
 
   void verbose_evolve(typename Hamiltonian::PointType& z,
@@ -95,6 +96,7 @@ class base_leapfrog : public base_integrator<Hamiltonian> {
     msg << "    " << std::setw(nColumn * width) << std::setfill('-') << ""
         << std::setfill(' ');
     logger.info(msg);
+    ++this->num_steps_;
   }
 
   virtual void begin_update_p(typename Hamiltonian::PointType& z,
@@ -112,6 +112,29 @@ class base_static_hmc
 
   double get_T() { return this->T_; }
 
+  /**
+   * Writes the base HMC state and the integration time to a
+   * checkpoint stream.
+   *
+   * @param[in,out] o checkpoint stream
+   */
+  void write_checkpoint(std::ostream& o) {
+    base_hmc<Model, Hamiltonian, Integrator, BaseRNG>::write_checkpoint(o);
+    write_checkpoint_value(o, T_);
+    o << L_ << ' ';
+  }
+
+  /**
+   * Restores the state written by <code>write_checkpoint</code>.
+   *
+   * @param[in,out] i checkpoint stream
+   */
+  void read_checkpoint(std::istream& i) {
+    base_hmc<Model, Hamiltonian, Integrator, BaseRNG>::read_checkpoint(i);
+    read_checkpoint_value(i, T_);
+    read_checkpoint_integer(i, L_);
+  }
+
   int get_L() { return this->L_; }
 
  protected:
@@ -0,0 +1,93 @@
+#ifndef STAN_MCMC_PERFORMANCE_COUNTERS_HPP
+#define STAN_MCMC_PERFORMANCE_COUNTERS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace mcmc {
+
+/**
+ * Counters describing where a sampler run spends its time.
+ *
+ * All counts and times are cumulative from the start of the run. The
+ * sampler fills the evaluation counts, the number of integrator
+ * steps, the time spent evaluating the log density and the autodiff
+ * memory; the services fill the remaining fields. The times are
+ * measured only while timing is on, which the services do only when
+ * a performance writer is attached; otherwise they stay zero.
+ */
+struct performance_counters {
+  /** Number of log density evaluations without gradient. */
+  size_t num_log_prob_evals = 0;
+  /** Number of log density and gradient evaluations. */
+  size_t num_gradient_evals = 0;
+  /** Number of integrator (leapfrog) steps. */
+  size_t num_leapfrog_steps = 0;
+  /** Number of draws written. */
+  size_t num_draws = 0;
+  /**
+   * Bytes held by the autodiff arena of the sampling thread, the
+   * high-water mark of autodiff memory; allocations are not counted.
+   */
+  size_t ad_arena_bytes = 0;
+  /** Seconds spent evaluating the log density and its gradient. */
+  double log_prob_seconds = 0;
+  /** Seconds spent generating transitions. */
+  double transition_seconds = 0;
+  /** Seconds spent in <code>write_array()</code>. */
+  double write_array_seconds = 0;
+  /** Seconds spent passing draws to the sample and diagnostic writers. */
+  double writer_seconds = 0;
+
+  /**
+   * Return the seconds spent in transitions outside the log density,
+   * that is, in the integrator, tree building and adaptation.
+   *
+   * @return integrator time in seconds
+   */
+  double integrator_seconds() const {
+    return transition_seconds - log_prob_seconds;
+  }
+
+  /**
+   * Appends the names of the values returned by <code>get_values</code>.
+   *
+   * @param[in,out] names names
+   */
+  static void get_names(std::vector<std::string>& names) {
+    names.push_back("num_log_prob_evals");
+    names.push_back("num_gradient_evals");
+    names.push_back("num_leapfrog_steps");
+    names.push_back("num_draws");
+    names.push_back("ad_arena_bytes");
+    names.push_back("log_prob_seconds");
+    names.push_back("integrator_seconds");
+    names.push_back("transition_seconds");
+    names.push_back("write_array_seconds");
+    names.push_back("writer_seconds");
+  }
+
+  /**
+   * Appends the counters in the order of <code>get_names</code>.
+   *
+   * @param[in,out] values values
+   */
+  void get_values(std::vector<double>& values) const {
+    values.push_back(num_log_prob_evals);
+    values.push_back(num_gradient_evals);
+    values.push_back(num_leapfrog_steps);
+    values.push_back(num_draws);
+    values.push_back(ad_arena_bytes);
+    values.push_back(log_prob_seconds);
+    values.push_back(integrator_seconds());
+    values.push_back(transition_seconds);
+    values.push_back(write_array_seconds);
+    values.push_back(writer_seconds);
+  }
+};
+
+}  // namespace mcmc
+}  // namespace stan
+#endif
@@ -2,6 +2,7 @@
 #define STAN_MCMC_STEPSIZE_ADAPTATION_HPP
 
 #include <stan/mcmc/base_adaptation.hpp>
+#include <stan/mcmc/checkpoint.hpp>
 #include <cmath>
 
 namespace stan {
@@ -72,6 +73,28 @@ class stepsize_adaptation : public base_adaptation {
 
   void complete_adaptation(double& epsilon) { epsilon = std::exp(x_bar_); }
 
+  void write_checkpoint(std::ostream& o) {
+    write_checkpoint_value(o, counter_);
+    write_checkpoint_value(o, s_bar_);
+    write_checkpoint_value(o, x_bar_);
+    write_checkpoint_value(o, mu_);
+    write_checkpoint_value(o, delta_);
+    write_checkpoint_value(o, gamma_);
+    write_checkpoint_value(o, kappa_);
+    write_checkpoint_value(o, t0_);
+  }
+
+  void read_checkpoint(std::istream& i) {
+    read_checkpoint_value(i, counter_);
+    read_checkpoint_value(i, s_bar_);
+    read_checkpoint_value(i, x_bar_);
+    read_checkpoint_value(i, mu_);
+    read_checkpoint_value(i, delta_);
+    read_checkpoint_value(i, gamma_);
+    read_checkpoint_value(i, kappa_);
+    read_checkpoint_value(i, t0_);
+  }
+
  protected:
   double counter_;  // Adaptation iteration
   double s_bar_;    // Moving average statistic
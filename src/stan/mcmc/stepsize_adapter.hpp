@@ -20,6 +20,16 @@ class stepsize_adapter : public base_adapter {
     return stepsize_adaptation_;
   }
 
+  void write_adaptation_checkpoint(std::ostream& o) {
+    base_adapter::write_adaptation_checkpoint(o);
+    stepsize_adaptation_.write_checkpoint(o);
+  }
+
+  void read_adaptation_checkpoint(std::istream& i) {
+    base_adapter::read_adaptation_checkpoint(i);
+    stepsize_adaptation_.read_checkpoint(i);
+  }
+
  protected:
   stepsize_adaptation stepsize_adaptation_;
 };
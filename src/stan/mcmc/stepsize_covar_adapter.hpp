@@ -31,6 +31,18 @@ class stepsize_covar_adapter : public base_adapter {
                                         base_window, logger);
   }
 
+  void write_adaptation_checkpoint(std::ostream& o) {
+    base_adapter::write_adaptation_checkpoint(o);
+    stepsize_adaptation_.write_checkpoint(o);
+    covar_adaptation_.write_checkpoint(o);
+  }
+
+  void read_adaptation_checkpoint(std::istream& i) {
+    base_adapter::read_adaptation_checkpoint(i);
+    stepsize_adaptation_.read_checkpoint(i);
+    covar_adaptation_.read_checkpoint(i);
+  }
+
  protected:
   stepsize_adaptation stepsize_adaptation_;
   covar_adaptation covar_adaptation_;
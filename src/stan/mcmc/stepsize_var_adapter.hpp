@@ -30,6 +30,18 @@ class stepsize_var_adapter : public base_adapter {
                                       base_window, logger);
   }
 
+  void write_adaptation_checkpoint(std::ostream& o) {
+    base_adapter::write_adaptation_checkpoint(o);
+    stepsize_adaptation_.write_checkpoint(o);
+    var_adaptation_.write_checkpoint(o);
+  }
+
+  void read_adaptation_checkpoint(std::istream& i) {
+    base_adapter::read_adaptation_checkpoint(i);
+    stepsize_adaptation_.read_checkpoint(i);
+    var_adaptation_.read_checkpoint(i);
+  }
+
  protected:
   stepsize_adaptation stepsize_adaptation_;
   var_adaptation var_adaptation_;
@@ -3,6 +3,7 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/mcmc/base_adaptation.hpp>
+#include <stan/mcmc/checkpoint.hpp>
 #include <ostream>
 #include <string>
 
@@ -109,6 +110,22 @@ class windowed_adaptation : public base_adaptation {
     }
   }
 
+  void write_checkpoint(std::ostream& o) {
+    o << num_warmup_ << ' ' << adapt_init_buffer_ << ' ' << adapt_term_buffer_
+      << ' ' << adapt_base_window_ << ' ' << adapt_window_counter_ << ' '
+      << adapt_next_window_ << ' ' << adapt_window_size_ << ' ';
+  }
+
+  void read_checkpoint(std::istream& i) {
+    read_checkpoint_integer(i, num_warmup_);
+    read_checkpoint_integer(i, adapt_init_buffer_);
+    read_checkpoint_integer(i, adapt_term_buffer_);
+    read_checkpoint_integer(i, adapt_base_window_);
+    read_checkpoint_integer(i, adapt_window_counter_);
+    read_checkpoint_integer(i, adapt_next_window_);
+    read_checkpoint_integer(i, adapt_window_size_);
+  }
+
  protected:
   std::string estimator_name_;
 
@@ -1,13 +1,190 @@
 #ifndef STAN_MODEL_GRAD_HESS_LOG_PROB_HPP
 #define STAN_MODEL_GRAD_HESS_LOG_PROB_HPP
 
+#include <stan/math/mix.hpp>
 #include <stan/model/log_prob_grad.hpp>
+#include <algorithm>
+#include <exception>
 #include <iostream>
 #include <vector>
+#ifdef STAN_THREADS
+#include <thread>
+#endif
 
 namespace stan {
 namespace model {
 
+/**
+ * Method used by <code>grad_hess_log_prob</code> to compute the
+ * Hessian.
+ */
+enum class hessian_method {
+  /** Finite differences of reverse-mode gradients. */
+  finite_diff,
+  /** Forward-over-reverse automatic differentiation. */
+  autodiff
+};
+
+namespace internal {
+
+/**
+ * Functor returning the log density of a model with the specified
+ * <code>propto</code> and <code>jacobian_adjust_transform</code>
+ * flags, for automatic differentiation with Stan math functionals.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+struct log_prob_functional {
+  const M& model;
+  std::ostream* o;
+
+  log_prob_functional(const M& m, std::ostream* out) : model(m), o(out) {}
+
+  template <typename T>
+  T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    // log_prob() requires non-const but doesn't modify its argument
+    return model.template log_prob<propto, jacobian_adjust_transform, T>(
+        const_cast<Eigen::Matrix<T, -1, 1>&>(x), o);
+  }
+};
+
+/**
+ * Computes row <code>d</code> of the finite-difference Jacobian of the
+ * gradient, that is the derivatives of the gradient with respect to
+ * parameter <code>d</code>, with a fourth-order central difference.
+ *
+ * @param[in] params_r Real-valued parameter vector.
+ * @param[in] params_i Integer-valued parameter vector.
+ * @param[in] d Index of the parameter to perturb.
+ * @param[in, out] perturbed_params Copy of params_r, restored on
+ * return.
+ * @param[in, out] temp_grad Work space for the gradient.
+ * @param[out] row Pointer to params_r.size() values.
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void finite_diff_grad_row(const M& model, const std::vector<double>& params_r,
+                          std::vector<int>& params_i, size_t d,
+                          std::vector<double>& perturbed_params,
+                          std::vector<double>& temp_grad, double* row) {
+  static const double epsilon = 1e-3;
+  static const int order = 4;
+  static const double perturbations[order]
+      = {-2 * epsilon, -1 * epsilon, epsilon, 2 * epsilon};
+  static const double coefficients[order]
+      = {1.0 / 12.0, -2.0 / 3.0, 2.0 / 3.0, -1.0 / 12.0};
+  std::fill(row, row + params_r.size(), 0.0);
+  for (int i = 0; i < order; ++i) {
+    perturbed_params[d] = params_r[d] + perturbations[i];
+    log_prob_grad<propto, jacobian_adjust_transform>(model, perturbed_params,
+                                                     params_i, temp_grad);
+    for (size_t dd = 0; dd < params_r.size(); ++dd)
+      row[dd] += coefficients[i] / epsilon * temp_grad[dd];
+  }
+  perturbed_params[d] = params_r[d];
+}
+
+}  // namespace internal
+
+/**
+ * Evaluate the log-probability, its gradient, and its Hessian
+ * at params_r with the specified method.
+ *
+ * <p>With <code>hessian_method::finite_diff</code> the Hessian is
+ * computed from 4 * params_r.size() gradients at perturbed
+ * parameters. When compiled with <code>STAN_THREADS</code>, the
+ * perturbed gradients are evaluated by up to <code>num_threads</code>
+ * threads, each with its own autodiff stack; the result does not
+ * depend on the number of threads.
+ *
+ * <p>With <code>hessian_method::autodiff</code> the exact Hessian is
+ * computed with <code>stan::math::hessian</code>, which requires the
+ * model's <code>log_prob</code> to support forward-over-reverse
+ * autodiff types; <code>num_threads</code> is ignored.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameter vector.
+ * @param[in] params_i Integer-valued parameter vector.
+ * @param[out] gradient Vector to write gradient to.
+ * @param[out] hessian Vector to write gradient to. hessian[i*D + j]
+ * gives the element at the ith row and jth column of the Hessian
+ * (where D=params_r.size()).
+ * @param[in] method Method used to compute the Hessian.
+ * @param[in] num_threads Number of threads for finite differences.
+ * @param[in, out] msgs Stream to which print statements in Stan
+ * programs are written, default is 0
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+double grad_hess_log_prob(const M& model, std::vector<double>& params_r,
+                          std::vector<int>& params_i,
+                          std::vector<double>& gradient,
+                          std::vector<double>& hessian, hessian_method method,
+                          int num_threads = 1, std::ostream* msgs = 0) {
+  const size_t D = params_r.size();
+  if (method == hessian_method::autodiff) {
+    Eigen::VectorXd x = Eigen::Map<Eigen::VectorXd>(params_r.data(), D);
+    double lp;
+    Eigen::VectorXd grad;
+    Eigen::MatrixXd hess;
+    stan::math::hessian(
+        internal::log_prob_functional<propto, jacobian_adjust_transform, M>(
+            model, msgs),
+        x, lp, grad, hess);
+    gradient.assign(grad.data(), grad.data() + grad.size());
+    hessian.assign(hess.data(), hess.data() + hess.size());
+    return lp;
+  }
+
+  double result = log_prob_grad<propto, jacobian_adjust_transform>(
+      model, params_r, params_i, gradient, msgs);
+  // rows of the finite-difference Jacobian of the gradient
+  std::vector<double> grad_rows(D * D);
+  auto work = [&](size_t offset, size_t stride) {
+    std::vector<double> temp_grad(D);
+    std::vector<double> perturbed_params(params_r.begin(), params_r.end());
+    for (size_t d = offset; d < D; d += stride)
+      internal::finite_diff_grad_row<propto, jacobian_adjust_transform>(
+          model, params_r, params_i, d, perturbed_params, temp_grad,
+          &grad_rows[d * D]);
+  };
+#ifdef STAN_THREADS
+  const size_t num_workers
+      = std::min(D, static_cast<size_t>(std::max(num_threads, 1)));
+  if (num_workers > 1) {
+    std::vector<std::exception_ptr> errors(num_workers);
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k < num_workers; ++k)
+      threads.emplace_back([&, k]() {
+        stan::math::ChainableStack thread_stack;
+        try {
+          work(k, num_workers);
+        } catch (...) {
+          errors[k] = std::current_exception();
+        }
+      });
+    for (std::thread& thread : threads)
+      thread.join();
+    for (const std::exception_ptr& error : errors)
+      if (error)
+        std::rethrow_exception(error);
+  } else {
+    work(0, 1);
+  }
+#else
+  work(0, 1);
+#endif
+
+  hessian.resize(D * D);
+  for (size_t i = 0; i < D; ++i)
+    for (size_t j = 0; j < D; ++j)
+      hessian[i * D + j] = 0.5 * (grad_rows[i * D + j] + grad_rows[j * D + i]);
+  return result;
+}
+
 /**
  * Evaluate the log-probability, its gradient, and its Hessian
  * at params_r. This default version computes the Hessian
@@ -36,37 +213,9 @@ double grad_hess_log_prob(const M& model, std::vector<double>& params_r,
                           std::vector<double>& gradient,
                           std::vector<double>& hessian,
                           std::ostream* msgs = 0) {
-  static const double epsilon = 1e-3;
-  static const double half_epsilon = 0.5 * epsilon;
-  static const int order = 4;
-  static const double perturbations[order]
-      = {-2 * epsilon, -1 * epsilon, epsilon, 2 * epsilon};
-  static const double coefficients[order]
-      = {1.0 / 12.0, -2.0 / 3.0, 2.0 / 3.0, -1.0 / 12.0};
-  static const double half_epsilon_coeff[order]
-      = {half_epsilon * coefficients[0], half_epsilon * coefficients[1],
-         half_epsilon * coefficients[2], half_epsilon * coefficients[3]};
-  double result = log_prob_grad<propto, jacobian_adjust_transform>(
-      model, params_r, params_i, gradient, msgs);
-  hessian.assign(params_r.size() * params_r.size(), 0);
-  std::vector<double> temp_grad(params_r.size());
-  std::vector<double> perturbed_params(params_r.begin(), params_r.end());
-  for (size_t d = 0; d < params_r.size(); ++d) {
-    const int row_iter = d * params_r.size();
-    for (int i = 0; i < order; ++i) {
-      perturbed_params[d] = params_r[d] + perturbations[i];
-      log_prob_grad<propto, jacobian_adjust_transform>(model, perturbed_params,
-                                                       params_i, temp_grad);
-      for (size_t dd = 0; dd < params_r.size(); ++dd) {
-        const double increment = half_epsilon_coeff[i] * temp_grad[dd];
-        const int col_iter = dd * params_r.size();
-        hessian[dd + row_iter] += increment;
-        hessian[d + col_iter] += increment;
-      }
-    }
-    perturbed_params[d] = params_r[d];
-  }
-  return result;
+  return grad_hess_log_prob<propto, jacobian_adjust_transform>(
+      model, params_r, params_i, gradient, hessian,
+      hessian_method::finite_diff, 1, msgs);
 }
 
 }  // namespace model
@@ -0,0 +1,138 @@
+#ifndef STAN_MODEL_GRADIENT_EVALUATOR_HPP
+#define STAN_MODEL_GRADIENT_EVALUATOR_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/math/rev.hpp>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+namespace model {
+
+/**
+ * Evaluates the log density of a model and its gradient with respect
+ * to the unconstrained parameters, reusing its work space across
+ * calls.
+ *
+ * <p>The vector of autodiff variables holding the parameters is
+ * allocated once and only refilled on each call, and the caller's
+ * gradient buffer is only resized when its size changes. Each
+ * evaluation runs in a nested autodiff scope, so the arena memory it
+ * uses is released for the next call without returning the arena's
+ * blocks to the system, and evaluations may be made while an
+ * enclosing autodiff expression is live. Because the values of
+ * autodiff variables are immutable, a new variable is placed on the
+ * arena for each parameter on every call.
+ *
+ * <p>An evaluator uses the autodiff stack of the calling thread and
+ * must not be shared between threads.
+ *
+ * @tparam M Class of model.
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ */
+template <class M, bool propto = true, bool jacobian_adjust_transform = true>
+class gradient_evaluator {
+ public:
+  /**
+   * Construct an evaluator for the specified model.
+   *
+   * @param[in] model Model.
+   * @param[in] num_params Number of unconstrained parameters; the
+   * work space grows if called with more.
+   */
+  gradient_evaluator(const M& model, size_t num_params)
+      : model_(model), params_r_(num_params) {}
+
+  /**
+   * Return the number of unconstrained parameters of the last
+   * evaluation, or the number given at construction.
+   *
+   * @return number of parameters
+   */
+  size_t num_params() const { return params_r_.size(); }
+
+  /**
+   * Evaluate the log density and its gradient.
+   *
+   * @param[in] x Unconstrained parameters.
+   * @param[out] f Log density.
+   * @param[out] grad_f Gradient of the log density.
+   * @param[in, out] msgs Stream to which print statements in Stan
+   * programs are written, default is 0
+   */
+  void operator()(const Eigen::VectorXd& x, double& f, Eigen::VectorXd& grad_f,
+                  std::ostream* msgs = 0) {
+    f = evaluate(x, grad_f, msgs);
+  }
+
+  /**
+   * Evaluate the log density and its gradient, writing any messages
+   * from the Stan program to the logger at info level.
+   *
+   * @param[in] x Unconstrained parameters.
+   * @param[out] f Log density.
+   * @param[out] grad_f Gradient of the log density.
+   * @param[in, out] logger Logger for messages.
+   */
+  void operator()(const Eigen::VectorXd& x, double& f, Eigen::VectorXd& grad_f,
+                  callbacks::logger& logger) {
+    std::stringstream ss;
+    try {
+      f = evaluate(x, grad_f, &ss);
+    } catch (std::exception& e) {
+      if (ss.str().length() > 0)
+        logger.info(ss);
+      throw;
+    }
+    if (ss.str().length() > 0)
+      logger.info(ss);
+  }
+
+  /**
+   * Evaluate the log density and its gradient.
+   *
+   * @param[in] x Unconstrained parameters.
+   * @param[out] grad_f Gradient of the log density.
+   * @param[in, out] msgs Stream to which print statements in Stan
+   * programs are written, default is 0
+   * @return Log density.
+   */
+  double operator()(const std::vector<double>& x, std::vector<double>& grad_f,
+                    std::ostream* msgs = 0) {
+    return evaluate(x, grad_f, msgs);
+  }
+
+ private:
+  const M& model_;
+  Eigen::Matrix<stan::math::var, Eigen::Dynamic, 1> params_r_;
+
+  template <typename Vec, typename Grad>
+  double evaluate(const Vec& x, Grad& grad_f, std::ostream* msgs) {
+    const size_t N = x.size();
+    if (static_cast<size_t>(params_r_.size()) != N)
+      params_r_.resize(N);
+    stan::math::nested_rev_autodiff nested;
+    for (size_t n = 0; n < N; ++n)
+      params_r_.coeffRef(n) = x[n];
+    stan::math::var lp
+        = model_.template log_prob<propto, jacobian_adjust_transform>(
+            params_r_, msgs);
+    lp.grad();
+    if (static_cast<size_t>(grad_f.size()) != N)
+      grad_f.resize(N);
+    for (size_t n = 0; n < N; ++n)
+      grad_f[n] = params_r_.coeff(n).adj();
+    return lp.val();
+  }
+};
+
+}  // namespace model
+}  // namespace stan
+#endif
@@ -0,0 +1,218 @@
+#ifndef STAN_MODEL_LOG_PROB_BATCH_HPP
+#define STAN_MODEL_LOG_PROB_BATCH_HPP
+
+#include <stan/math/rev/core.hpp>
+#include <stan/model/log_prob_propto.hpp>
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#ifdef STAN_THREADS
+#include <thread>
+#endif
+
+namespace stan {
+namespace model {
+namespace internal {
+
+/**
+ * Calls <code>f(k, num_workers, msgs)</code> for each worker
+ * <code>k</code>, where the workers split <code>num_rows</code> rows.
+ * When compiled with <code>STAN_THREADS</code> and more than one
+ * worker is used, each worker runs on its own thread with its own
+ * autodiff stack and message stream, and the messages are appended to
+ * <code>msgs</code> in worker order after all workers finish.
+ *
+ * @throw the exception thrown by the first failing worker
+ */
+template <typename F>
+void for_each_row_worker(size_t num_rows, int num_threads, std::ostream* msgs,
+                         const F& f) {
+#ifdef STAN_THREADS
+  const size_t num_workers
+      = std::min(num_rows, static_cast<size_t>(std::max(num_threads, 1)));
+  if (num_workers > 1) {
+    std::vector<std::exception_ptr> errors(num_workers);
+    std::vector<std::stringstream> worker_msgs(num_workers);
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k < num_workers; ++k)
+      threads.emplace_back([&, k]() {
+        stan::math::ChainableStack thread_stack;
+        try {
+          f(k, num_workers, msgs == 0 ? 0 : &worker_msgs[k]);
+        } catch (...) {
+          errors[k] = std::current_exception();
+        }
+      });
+    for (std::thread& thread : threads)
+      thread.join();
+    if (msgs != 0)
+      for (const std::stringstream& worker_msg : worker_msgs)
+        *msgs << worker_msg.str();
+    for (const std::exception_ptr& error : errors)
+      if (error)
+        std::rethrow_exception(error);
+    return;
+  }
+#endif
+  f(0, 1, msgs);
+}
+
+}  // namespace internal
+
+/**
+ * Evaluate the log density of the model at each row of a matrix of
+ * unconstrained parameters.
+ *
+ * <p>When compiled with <code>STAN_THREADS</code>, the rows are split
+ * across up to <code>num_threads</code> threads. Values dropping
+ * normalizing constants are computed by <code>log_prob_propto</code>,
+ * or by <code>log_prob_propto_fvar</code> when compiled with
+ * <code>STAN_LOG_PROB_PROPTO_FVAR</code>; other values use
+ * <code>double</code>.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Matrix with one row of unconstrained parameters
+ * per point.
+ * @param[out] log_probs Log densities, one per row.
+ * @param[in] num_threads Number of threads.
+ * @param[in, out] msgs Stream to which print statements in Stan
+ * programs are written, default is 0
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void log_prob_batch(const M& model, const Eigen::MatrixXd& params_r,
+                    Eigen::VectorXd& log_probs, int num_threads = 1,
+                    std::ostream* msgs = 0) {
+  const size_t N = params_r.rows();
+  log_probs.resize(N);
+  internal::for_each_row_worker(
+      N, num_threads, msgs,
+      [&](size_t offset, size_t stride, std::ostream* worker_msgs) {
+        Eigen::VectorXd x;
+        for (size_t n = offset; n < N; n += stride) {
+          x = params_r.row(n).transpose();
+          if (propto)
+            log_probs(n) = internal::log_prob_propto_default<
+                jacobian_adjust_transform>(model, x, worker_msgs);
+          else
+            log_probs(n) = model.template log_prob<false,
+                                                   jacobian_adjust_transform>(
+                x, worker_msgs);
+        }
+      });
+}
+
+/**
+ * Evaluate the log density of the model and its gradient at each row
+ * of a matrix of unconstrained parameters using reverse-mode
+ * automatic differentiation.
+ *
+ * <p>When compiled with <code>STAN_THREADS</code>, the rows are split
+ * across up to <code>num_threads</code> threads, each with its own
+ * autodiff stack.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Matrix with one row of unconstrained parameters
+ * per point.
+ * @param[out] log_probs Log densities, one per row.
+ * @param[out] gradients Matrix with the gradient at each row of
+ * params_r in the same row.
+ * @param[in] num_threads Number of threads.
+ * @param[in, out] msgs Stream to which print statements in Stan
+ * programs are written, default is 0
+ */
+template <bool propto, bool jacobian_adjust_transform, class M>
+void log_prob_grad_batch(const M& model, const Eigen::MatrixXd& params_r,
+                         Eigen::VectorXd& log_probs, Eigen::MatrixXd& gradients,
+                         int num_threads = 1, std::ostream* msgs = 0) {
+  using stan::math::var;
+  const size_t N = params_r.rows();
+  log_probs.resize(N);
+  gradients.resize(N, params_r.cols());
+  internal::for_each_row_worker(
+      N, num_threads, msgs,
+      [&](size_t offset, size_t stride, std::ostream* worker_msgs) {
+        for (size_t n = offset; n < N; n += stride) {
+          try {
+            Eigen::Matrix<var, Eigen::Dynamic, 1> x
+                = params_r.row(n).transpose().cast<var>();
+            var lp = model.template log_prob<propto, jacobian_adjust_transform>(
+                x, worker_msgs);
+            lp.grad();
+            log_probs(n) = lp.val();
+            for (int d = 0; d < x.size(); ++d)
+              gradients(n, d) = x(d).adj();
+            stan::math::recover_memory();
+          } catch (const std::exception& e) {
+            stan::math::recover_memory();
+            throw;
+          }
+        }
+      });
+}
+
+namespace internal {
+
+/**
+ * Calls <code>log_prob_batch</code> with the template parameters
+ * given by the specified flags.
+ */
+template <class M>
+void log_prob_batch(const M& model, const Eigen::MatrixXd& params_r,
+                    Eigen::VectorXd& log_probs, bool propto, bool jacobian,
+                    int num_threads, std::ostream* msgs) {
+  if (propto && jacobian)
+    stan::model::log_prob_batch<true, true>(model, params_r, log_probs,
+                                            num_threads, msgs);
+  else if (propto && !jacobian)
+    stan::model::log_prob_batch<true, false>(model, params_r, log_probs,
+                                             num_threads, msgs);
+  else if (!propto && jacobian)
+    stan::model::log_prob_batch<false, true>(model, params_r, log_probs,
+                                             num_threads, msgs);
+  else
+    stan::model::log_prob_batch<false, false>(model, params_r, log_probs,
+                                              num_threads, msgs);
+}
+
+/**
+ * Calls <code>log_prob_grad_batch</code> with the template
+ * parameters given by the specified flags.
+ */
+template <class M>
+void log_prob_grad_batch(const M& model, const Eigen::MatrixXd& params_r,
+                         Eigen::VectorXd& log_probs, Eigen::MatrixXd& gradients,
+                         bool propto, bool jacobian, int num_threads,
+                         std::ostream* msgs) {
+  if (propto && jacobian)
+    stan::model::log_prob_grad_batch<true, true>(
+        model, params_r, log_probs, gradients, num_threads, msgs);
+  else if (propto && !jacobian)
+    stan::model::log_prob_grad_batch<true, false>(
+        model, params_r, log_probs, gradients, num_threads, msgs);
+  else if (!propto && jacobian)
+    stan::model::log_prob_grad_batch<false, true>(
+        model, params_r, log_probs, gradients, num_threads, msgs);
+  else
+    stan::model::log_prob_grad_batch<false, false>(
+        model, params_r, log_probs, gradients, num_threads, msgs);
+}
+
+}  // namespace internal
+
+}  // namespace model
+}  // namespace stan
+#endif
@@ -1,6 +1,7 @@
 #ifndef STAN_MODEL_LOG_PROB_PROPTO_HPP
 #define STAN_MODEL_LOG_PROB_PROPTO_HPP
 
+#include <stan/math/fwd/core.hpp>
 #include <stan/math/rev.hpp>
 #include <iostream>
 #include <vector>
@@ -94,6 +95,113 @@ double log_prob_propto(const M& model, Eigen::VectorXd& params_r,
   }
 }
 
+/**
+ * Helper function to calculate log probability for
+ * <code>double</code> scalars up to a proportion without an autodiff
+ * tape.
+ *
+ * This implementation wraps the <code>double</code> values in
+ * <code>stan::math::fvar<double></code> with zero tangents and calls
+ * the model's <code>log_prob()</code> function with
+ * <code>propto=true</code>. The parameters are not constants for the
+ * probability functions, so the same terms are dropped as by
+ * <code>log_prob_propto</code>.
+ *
+ * <p>Callers opt in to this function. It requires a model whose
+ * <code>log_prob()</code> can be instantiated with
+ * <code>fvar<double></code>, which is not the case for models calling
+ * <code>map_rect</code>, the algebraic solvers or the ODE solvers.
+ * For models accessed through <code>model_base</code> it calls
+ * <code>model_base::log_prob_propto_value</code> or
+ * <code>model_base::log_prob_propto_jacobian_value</code>.
+ *
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameters.
+ * @param[in] params_i Integer-valued parameters.
+ * @param[in,out] msgs
+ */
+template <bool jacobian_adjust_transform, class M>
+double log_prob_propto_fvar(const M& model, std::vector<double>& params_r,
+                            std::vector<int>& params_i,
+                            std::ostream* msgs = 0) {
+  using stan::math::fvar;
+  std::vector<fvar<double> > fvar_params_r;
+  fvar_params_r.reserve(model.num_params_r());
+  for (size_t i = 0; i < model.num_params_r(); ++i)
+    fvar_params_r.emplace_back(params_r[i]);
+  return model
+      .template log_prob<true, jacobian_adjust_transform>(fvar_params_r,
+                                                           params_i, msgs)
+      .val();
+}
+
+/**
+ * Helper function to calculate log probability for
+ * <code>double</code> scalars up to a proportion without an autodiff
+ * tape. See the <code>std::vector</code> overload.
+ *
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @tparam M Class of model.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameters.
+ * @param[in,out] msgs
+ */
+template <bool jacobian_adjust_transform, class M>
+double log_prob_propto_fvar(const M& model, Eigen::VectorXd& params_r,
+                            std::ostream* msgs = 0) {
+  using stan::math::fvar;
+  std::vector<int> params_i(0);
+  std::vector<fvar<double> > fvar_params_r;
+  fvar_params_r.reserve(model.num_params_r());
+  for (size_t i = 0; i < model.num_params_r(); ++i)
+    fvar_params_r.emplace_back(params_r(i));
+  return model
+      .template log_prob<true, jacobian_adjust_transform>(fvar_params_r,
+                                                           params_i, msgs)
+      .val();
+}
+
+namespace internal {
+
+/**
+ * Return the log density dropping normalizing constants as
+ * evaluated by the samplers and <code>log_prob_batch</code>: by
+ * <code>log_prob_propto_fvar</code> when compiled with
+ * <code>STAN_LOG_PROB_PROPTO_FVAR</code>, otherwise with
+ * <code>stan::math::var</code> through the Eigen overload of the
+ * model's <code>log_prob()</code>.
+ */
+template <bool jacobian_adjust_transform, class M>
+double log_prob_propto_default(const M& model, Eigen::VectorXd& params_r,
+                               std::ostream* msgs = 0) {
+#ifdef STAN_LOG_PROB_PROPTO_FVAR
+  return log_prob_propto_fvar<jacobian_adjust_transform>(model, params_r,
+                                                         msgs);
+#else
+  using stan::math::var;
+  try {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> ad_params_r = params_r.cast<var>();
+    double lp = model
+                    .template log_prob<true, jacobian_adjust_transform>(
+                        ad_params_r, msgs)
+                    .val();
+    stan::math::recover_memory();
+    return lp;
+  } catch (std::exception& ex) {
+    stan::math::recover_memory();
+    throw;
+  }
+#endif
+}
+
+}  // namespace internal
+
 }  // namespace model
 }  // namespace stan
 #endif
@@ -3,8 +3,10 @@
 
 #include <stan/io/var_context.hpp>
 #include <stan/math/rev/core.hpp>
+#include <stan/model/log_prob_batch.hpp>
 #include <stan/model/prob_grad.hpp>
 #include <boost/random/additive_combine.hpp>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -61,6 +63,24 @@ class model_base : public prob_grad {
    */
   virtual std::vector<std::string> model_compile_info() const = 0;
 
+  /**
+   * Return a new instance of this model that refers to the data and
+   * transformed data of this instance instead of copying them, or a
+   * null pointer if the model does not support sharing its data.
+   *
+   * <p>The data are immutable once the model is constructed, so the
+   * instances may be used concurrently, for example one per chain,
+   * while keeping a single copy of the data in memory. Models
+   * generated by stanc support sharing data.
+   *
+   * @param[in,out] msgs stream for messages from the constructor
+   * @return new model instance sharing the data of this instance
+   */
+  virtual std::unique_ptr<model_base> clone_shared_data(
+      std::ostream* msgs = 0) const {
+    return std::unique_ptr<model_base>();
+  }
+
   /**
    * Set the specified argument to sequence of parameters, transformed
    * parameters, and generated quantities in the order in which they
@@ -283,6 +303,48 @@ class model_base : public prob_grad {
   virtual math::var log_prob_propto_jacobian(
       Eigen::Matrix<math::var, -1, 1>& params_r, std::ostream* msgs) const = 0;
 
+  /**
+   * Return the value of the log density for the specified
+   * unconstrained parameters, without Jacobian correction for
+   * constraints and dropping normalizing constants, that is the value
+   * of the `math::var` overload of `log_prob_propto`.
+   *
+   * <p>The default implementation evaluates the `math::var` overload
+   * and recovers the autodiff memory.  When compiled with
+   * `STAN_LOG_PROB_PROPTO_FVAR`, `model_base_crtp` overrides it to
+   * evaluate the log density with `math::fvar<double>`, without an
+   * autodiff tape.
+   *
+   * @param[in] params_r unconstrained parameters
+   * @param[in,out] msgs message stream
+   * @return log density for specified parameters
+   */
+  virtual double log_prob_propto_value(Eigen::VectorXd& params_r,
+                                       std::ostream* msgs) const {
+    return log_prob_propto_value_var<false>(params_r, msgs);
+  }
+
+  /**
+   * Return the value of the log density for the specified
+   * unconstrained parameters, with Jacobian correction for
+   * constraints and dropping normalizing constants, that is the value
+   * of the `math::var` overload of `log_prob_propto_jacobian`.
+   *
+   * <p>The default implementation evaluates the `math::var` overload
+   * and recovers the autodiff memory.  When compiled with
+   * `STAN_LOG_PROB_PROPTO_FVAR`, `model_base_crtp` overrides it to
+   * evaluate the log density with `math::fvar<double>`, without an
+   * autodiff tape.
+   *
+   * @param[in] params_r unconstrained parameters
+   * @param[in,out] msgs message stream
+   * @return log density for specified parameters
+   */
+  virtual double log_prob_propto_jacobian_value(Eigen::VectorXd& params_r,
+                                                std::ostream* msgs) const {
+    return log_prob_propto_value_var<true>(params_r, msgs);
+  }
+
   /**
    * Convenience template function returning the log density for the
    * specified unconstrained parameters, with Jacobian and normalizing
@@ -317,6 +379,62 @@ class model_base : public prob_grad {
       return log_prob(params_r, msgs);
   }
 
+  /**
+   * Set the specified vector to the log densities at the points given
+   * by the rows of the specified matrix of unconstrained parameters,
+   * with Jacobian and normalizing constant inclusion controlled by
+   * the flags.
+   *
+   * <p>The default implementation evaluates the rows on up to
+   * `num_threads` threads when compiled with `STAN_THREADS`; see
+   * `stan::model::log_prob_batch`.  Derived classes may override it
+   * to evaluate the rows together.
+   *
+   * @param[in] params_r unconstrained parameters, one point per row
+   * @param[out] log_probs log densities, one per row
+   * @param[in] propto `true` if normalizing constants should be dropped
+   * @param[in] jacobian `true` if the log Jacobian adjustment is
+   * included
+   * @param[in] num_threads number of threads
+   * @param[in,out] msgs stream to which messages are written
+   */
+  virtual void log_prob_batch(const Eigen::MatrixXd& params_r,
+                              Eigen::VectorXd& log_probs, bool propto,
+                              bool jacobian, int num_threads = 1,
+                              std::ostream* msgs = 0) const {
+    internal::log_prob_batch(*this, params_r, log_probs, propto, jacobian,
+                             num_threads, msgs);
+  }
+
+  /**
+   * Set the specified vector and matrix to the log densities and
+   * their gradients at the points given by the rows of the specified
+   * matrix of unconstrained parameters, with Jacobian and
+   * normalizing constant inclusion controlled by the flags.
+   *
+   * <p>The default implementation evaluates the rows on up to
+   * `num_threads` threads when compiled with `STAN_THREADS`; see
+   * `stan::model::log_prob_grad_batch`.  Derived classes may override
+   * it to evaluate the rows together.
+   *
+   * @param[in] params_r unconstrained parameters, one point per row
+   * @param[out] log_probs log densities, one per row
+   * @param[out] gradients gradients, one per row
+   * @param[in] propto `true` if normalizing constants should be dropped
+   * @param[in] jacobian `true` if the log Jacobian adjustment is
+   * included
+   * @param[in] num_threads number of threads
+   * @param[in,out] msgs stream to which messages are written
+   */
+  virtual void log_prob_grad_batch(const Eigen::MatrixXd& params_r,
+                                   Eigen::VectorXd& log_probs,
+                                   Eigen::MatrixXd& gradients, bool propto,
+                                   bool jacobian, int num_threads = 1,
+                                   std::ostream* msgs = 0) const {
+    internal::log_prob_grad_batch(*this, params_r, log_probs, gradients,
+                                  propto, jacobian, num_threads, msgs);
+  }
+
   /**
    * Read constrained parameter values from the specified context,
    * unconstrain them, then concatenate the unconstrained sequences
@@ -591,8 +709,76 @@ class model_base : public prob_grad {
                            std::vector<double>& params_r_constrained,
                            bool include_tparams = true, bool include_gqs = true,
                            std::ostream* msgs = 0) const = 0;
+
+ private:
+  template <bool jacobian>
+  double log_prob_propto_value_var(Eigen::VectorXd& params_r,
+                                   std::ostream* msgs) const {
+    try {
+      Eigen::Matrix<math::var, -1, 1> ad_params_r
+          = params_r.cast<math::var>();
+      double lp = log_prob<true, jacobian>(ad_params_r, msgs).val();
+      math::recover_memory();
+      return lp;
+    } catch (const std::exception& e) {
+      math::recover_memory();
+      throw;
+    }
+  }
 };
 
+/**
+ * Return the log density of the model dropping normalizing
+ * constants; this overload of `log_prob_propto_fvar` for models
+ * accessed through the base class calls
+ * `model_base::log_prob_propto_value` or
+ * `model_base::log_prob_propto_jacobian_value`, which evaluate the
+ * `math::var` overloads unless the model opts in.
+ *
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameters.
+ * @param[in,out] msgs
+ */
+template <bool jacobian_adjust_transform>
+inline double log_prob_propto_fvar(const model_base& model,
+                                   Eigen::VectorXd& params_r,
+                                   std::ostream* msgs = 0) {
+  if (jacobian_adjust_transform)
+    return model.log_prob_propto_jacobian_value(params_r, msgs);
+  return model.log_prob_propto_value(params_r, msgs);
+}
+
+/**
+ * Return the log density of the model dropping normalizing
+ * constants; this overload of `log_prob_propto_fvar` for models
+ * accessed through the base class calls
+ * `model_base::log_prob_propto_value` or
+ * `model_base::log_prob_propto_jacobian_value`, which evaluate the
+ * `math::var` overloads unless the model opts in.
+ *
+ * \deprecated Use Eigen vector versions
+ *
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to
+ * the log probability.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameters.
+ * @param[in] params_i Integer-valued parameters (ignored).
+ * @param[in,out] msgs
+ */
+template <bool jacobian_adjust_transform>
+inline double log_prob_propto_fvar(const model_base& model,
+                                   std::vector<double>& params_r,
+                                   std::vector<int>& params_i,
+                                   std::ostream* msgs = 0) {
+  Eigen::VectorXd x = Eigen::Map<Eigen::VectorXd>(params_r.data(),
+                                                  params_r.size());
+  return log_prob_propto_fvar<jacobian_adjust_transform>(model, x, msgs);
+}
+
 }  // namespace model
 }  // namespace stan
 #endif
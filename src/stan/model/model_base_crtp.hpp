@@ -192,6 +192,19 @@ class model_base_crtp : public stan::model::model_base {
         theta, theta_i, msgs);
   }
 
+#ifdef STAN_LOG_PROB_PROPTO_FVAR
+  inline double log_prob_propto_value(Eigen::VectorXd& theta,
+                                      std::ostream* msgs) const override {
+    return stan::model::log_prob_propto_fvar<false>(
+        *static_cast<const M*>(this), theta, msgs);
+  }
+  inline double log_prob_propto_jacobian_value(
+      Eigen::VectorXd& theta, std::ostream* msgs) const override {
+    return stan::model::log_prob_propto_fvar<true>(
+        *static_cast<const M*>(this), theta, msgs);
+  }
+#endif
+
   void write_array(boost::ecuyer1988& rng, std::vector<double>& theta,
                    std::vector<int>& theta_i, std::vector<double>& vars,
                    bool include_tparams = true, bool include_gqs = true,
@@ -0,0 +1,163 @@
+#ifndef STAN_MODEL_PROFILE_STATEMENT_HPP
+#define STAN_MODEL_PROFILE_STATEMENT_HPP
+
+#include <stan/math/rev.hpp>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace stan {
+namespace model {
+
+/**
+ * Accumulated cost of the evaluations of one statement.
+ */
+struct statement_profile {
+  /** Number of times the statement was executed. */
+  size_t count = 0;
+  /** Seconds spent executing the statement. */
+  double forward_seconds = 0;
+  /** Seconds spent in the reverse pass of the statement's expressions. */
+  double reverse_seconds = 0;
+};
+
+/**
+ * Process-wide record of the cost of the statements of models whose
+ * <code>log_prob</code> was generated with profiling, keyed by the
+ * line number at which each statement begins. It may be updated
+ * concurrently from several threads.
+ */
+class statement_profiler {
+ public:
+  /**
+   * Return the profiler shared by all models.
+   *
+   * @return profiler
+   */
+  static statement_profiler& instance() {
+    static statement_profiler profiler;
+    return profiler;
+  }
+
+  /**
+   * Add an execution of the statement at the specified line.
+   *
+   * @param[in] line line number of the statement
+   * @param[in] seconds seconds spent executing it
+   */
+  void add_forward(int line, double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statement_profile& profile = profiles_[line];
+    ++profile.count;
+    profile.forward_seconds += seconds;
+  }
+
+  /**
+   * Add a reverse pass through the statement at the specified line.
+   *
+   * @param[in] line line number of the statement
+   * @param[in] seconds seconds spent in the reverse pass
+   */
+  void add_reverse(int line, double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profiles_[line].reverse_seconds += seconds;
+  }
+
+  /**
+   * Return the profiles recorded so far, in order of line number.
+   *
+   * @return profiles by line number
+   */
+  std::map<int, statement_profile> profiles() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profiles_;
+  }
+
+  /**
+   * Discard the profiles recorded so far.
+   */
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profiles_.clear();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<int, statement_profile> profiles_;
+
+  statement_profiler() {}
+};
+
+namespace internal {
+
+inline double profile_seconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace internal
+
+/**
+ * Records the time between its construction and destruction as an
+ * execution of the statement at the specified line. Generated
+ * <code>log_prob</code> methods declare one in a scope around each
+ * top-level statement when profiling is enabled.
+ *
+ * @tparam T scalar type of the log density
+ */
+template <typename T>
+class profile_statement {
+ public:
+  explicit profile_statement(int line)
+      : line_(line), start_(internal::profile_seconds()) {}
+
+  ~profile_statement() {
+    statement_profiler::instance().add_forward(
+        line_, internal::profile_seconds() - start_);
+  }
+
+ private:
+  int line_;
+  double start_;
+};
+
+/**
+ * Records the forward time of the statement at the specified line as
+ * for other scalar types, and also the time of the reverse pass
+ * through the expressions the statement puts on the autodiff stack,
+ * measured by callbacks placed on the stack before and after them.
+ */
+template <>
+class profile_statement<stan::math::var> {
+ public:
+  explicit profile_statement(int line)
+      : line_(line),
+        reverse_start_(stan::math::ChainableStack::instance_->memalloc_
+                           .alloc_array<double>(1)) {
+    double* reverse_start = reverse_start_;
+    stan::math::reverse_pass_callback([line, reverse_start]() {
+      statement_profiler::instance().add_reverse(
+          line, internal::profile_seconds() - *reverse_start);
+    });
+    start_ = internal::profile_seconds();
+  }
+
+  ~profile_statement() {
+    double end = internal::profile_seconds();
+    double* reverse_start = reverse_start_;
+    stan::math::reverse_pass_callback(
+        [reverse_start]() { *reverse_start = internal::profile_seconds(); });
+    statement_profiler::instance().add_forward(line_, end - start_);
+  }
+
+ private:
+  int line_;
+  double* reverse_start_;
+  double start_;
+};
+
+}  // namespace model
+}  // namespace stan
+#endif
@@ -5,7 +5,12 @@
 #include <stan/callbacks/writer.hpp>
 #include <stan/model/finite_diff_grad.hpp>
 #include <stan/model/log_prob_grad.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <algorithm>
 #include <cmath>
+#include <iomanip>
+#include <numeric>
 #include <sstream>
 #include <vector>
 
@@ -94,6 +99,169 @@ int test_gradients(const Model& model, std::vector<double>& params_r,
   return num_failed;
 }
 
+/**
+ * Test the log_prob_grad() function's ability to produce accurate
+ * gradients using Richardson-extrapolated finite differences, which
+ * are accurate to order <code>epsilon^4</code>, optionally checking
+ * only a random sample of the partial derivatives and random
+ * directional derivatives so that models with many parameters can be
+ * checked in a fraction of the time of a full check.
+ *
+ * <p>If <code>num_coordinates</code> is zero or at least the number
+ * of parameters, all partial derivatives are checked; zero means all
+ * of them, not none, so the partial derivatives cannot be skipped.
+ * Otherwise that many parameters are drawn at random without
+ * replacement. In addition, the derivatives in
+ * <code>num_directions</code> random directions, drawn uniformly from
+ * the unit sphere, are compared with the inner product of the
+ * gradient and the direction; each of them tests all partial
+ * derivatives at once. Finite differences are evaluated on up to
+ * <code>num_threads</code> threads when compiled with
+ * <code>STAN_THREADS</code>.
+ *
+ * @tparam propto True if calculation is up to proportion
+ * (double-only terms dropped).
+ * @tparam jacobian_adjust_transform True if the log absolute
+ * Jacobian determinant of inverse parameter transforms is added to the
+ * log probability.
+ * @tparam Model Class of model.
+ * @tparam RNG Class of random number generator.
+ * @param[in] model Model.
+ * @param[in] params_r Real-valued parameter vector.
+ * @param[in] params_i Integer-valued parameter vector.
+ * @param[in] epsilon Real-valued scalar saying how much to perturb.
+ *   Reasonable value is 1e-3 (see <code>finite_diff_grad</code>).
+ * @param[in] error Real-valued scalar saying how much error to allow.
+ *   Reasonable value is 1e-6.
+ * @param[in] num_coordinates Number of partial derivatives to check;
+ *   zero checks all of them.
+ * @param[in] num_directions Number of random directional derivatives
+ *   to check.
+ * @param[in] num_threads Number of threads.
+ * @param[in,out] rng Random number generator.
+ * @param[in,out] interrupt callback to be called at every iteration
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] parameter_writer Writer callback for file output
+ * @return number of failed gradient comparisons versus allowed
+ * error, so 0 if all gradients pass
+ */
+template <bool propto, bool jacobian_adjust_transform, class Model,
+          class RNG>
+int test_gradients(const Model& model, std::vector<double>& params_r,
+                   std::vector<int>& params_i, double epsilon, double error,
+                   size_t num_coordinates, size_t num_directions,
+                   int num_threads, RNG& rng,
+                   stan::callbacks::interrupt& interrupt,
+                   stan::callbacks::logger& logger,
+                   stan::callbacks::writer& parameter_writer) {
+  std::stringstream msg;
+  std::vector<double> grad;
+  double lp = log_prob_grad<propto, jacobian_adjust_transform>(
+      model, params_r, params_i, grad, &msg);
+  if (msg.str().length() > 0) {
+    logger.info(msg);
+    parameter_writer(msg.str());
+  }
+
+  const size_t num_params = params_r.size();
+  std::vector<size_t> indices(num_params);
+  std::iota(indices.begin(), indices.end(), 0);
+  if (num_coordinates > 0 && num_coordinates < num_params) {
+    for (size_t n = 0; n < num_coordinates; ++n) {
+      boost::random::uniform_int_distribution<size_t> pick(n, num_params - 1);
+      std::swap(indices[n], indices[pick(rng)]);
+    }
+    indices.resize(num_coordinates);
+    std::sort(indices.begin(), indices.end());
+  }
+  std::vector<std::vector<double> > directions(num_directions);
+  boost::random::normal_distribution<double> std_normal;
+  for (std::vector<double>& direction : directions) {
+    direction.resize(num_params);
+    double norm = 0;
+    for (double& v : direction) {
+      v = std_normal(rng);
+      norm += v * v;
+    }
+    norm = std::sqrt(norm);
+    for (double& v : direction)
+      v /= norm;
+  }
+
+  std::stringstream fd_msg;
+  std::vector<double> grad_fd;
+  finite_diff_grad<false, jacobian_adjust_transform>(
+      model, interrupt, params_r, params_i, indices, grad_fd, epsilon,
+      num_threads, &fd_msg);
+  std::vector<double> directional_fd;
+  finite_diff_directional_derivatives<false, jacobian_adjust_transform>(
+      model, interrupt, params_r, params_i, directions, directional_fd,
+      epsilon, num_threads, &fd_msg);
+  if (fd_msg.str().length() > 0) {
+    logger.info(fd_msg);
+    parameter_writer(fd_msg.str());
+  }
+
+  int num_failed = 0;
+
+  std::stringstream lp_msg;
+  lp_msg << " Log probability=" << lp;
+
+  parameter_writer();
+  parameter_writer(lp_msg.str());
+  parameter_writer();
+
+  logger.info("");
+  logger.info(lp_msg);
+  logger.info("");
+
+  std::stringstream header;
+  header << std::setw(10) << "param idx" << std::setw(16) << "value"
+         << std::setw(16) << "model" << std::setw(16) << "finite diff"
+         << std::setw(16) << "error";
+
+  parameter_writer(header.str());
+  logger.info(header);
+
+  for (size_t n = 0; n < indices.size(); n++) {
+    size_t k = indices[n];
+    std::stringstream line;
+    line << std::setw(10) << k << std::setw(16) << params_r[k] << std::setw(16)
+         << grad[k] << std::setw(16) << grad_fd[n] << std::setw(16)
+         << (grad[k] - grad_fd[n]);
+    parameter_writer(line.str());
+    logger.info(line);
+    if (std::fabs(grad[k] - grad_fd[n]) > error)
+      num_failed++;
+  }
+
+  if (num_directions == 0)
+    return num_failed;
+
+  parameter_writer();
+  logger.info("");
+  std::stringstream direction_header;
+  direction_header << std::setw(10) << "direction" << std::setw(16) << ""
+                   << std::setw(16) << "model" << std::setw(16)
+                   << "finite diff" << std::setw(16) << "error";
+  parameter_writer(direction_header.str());
+  logger.info(direction_header);
+
+  for (size_t n = 0; n < num_directions; n++) {
+    double derivative = std::inner_product(grad.begin(), grad.end(),
+                                           directions[n].begin(), 0.0);
+    std::stringstream line;
+    line << std::setw(10) << n << std::setw(16) << "" << std::setw(16)
+         << derivative << std::setw(16) << directional_fd[n] << std::setw(16)
+         << (derivative - directional_fd[n]);
+    parameter_writer(line.str());
+    logger.info(line);
+    if (std::fabs(derivative - directional_fd[n]) > error)
+      num_failed++;
+  }
+  return num_failed;
+}
+
 }  // namespace model
 }  // namespace stan
 #endif
@@ -2,8 +2,8 @@
 #define STAN_OPTIMIZATION_BFGS_HPP
 
 #include <stan/math/prim.hpp>
+#include <stan/model/gradient_evaluator.hpp>
 #include <stan/model/log_prob_propto.hpp>
-#include <stan/model/log_prob_grad.hpp>
 #include <stan/optimization/bfgs_linesearch.hpp>
 #include <stan/optimization/bfgs_update.hpp>
 #include <stan/optimization/lbfgs_update.hpp>
@@ -289,18 +289,33 @@ class BFGSMinimizer {
   }
 };
 
-template <class M>
+/**
+ * Adapts a model to the minimizer interface: the objective is the
+ * negative log density on the unconstrained scale.
+ *
+ * @tparam M model class
+ * @tparam Jacobian true to include the Jacobian of the constraining
+ *   transforms, that is, to minimize the negative log posterior of
+ *   the unconstrained parameters rather than find the mode on the
+ *   constrained scale
+ */
+template <class M, bool Jacobian = false>
 class ModelAdaptor {
  private:
   M &_model;
   std::vector<int> _params_i;
   std::ostream *_msgs;
   std::vector<double> _x, _g;
+  stan::model::gradient_evaluator<M, true, Jacobian> _gradient;
   size_t _fevals;
 
  public:
   ModelAdaptor(M &model, const std::vector<int> &params_i, std::ostream *msgs)
-      : _model(model), _params_i(params_i), _msgs(msgs), _fevals(0) {}
+      : _model(model),
+        _params_i(params_i),
+        _msgs(msgs),
+        _gradient(model, model.num_params_r()),
+        _fevals(0) {}
 
   size_t fevals() const { return _fevals; }
   int operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1> &x, double &f) {
@@ -315,7 +330,7 @@ class ModelAdaptor {
       _x[i] = x[i];
 
     try {
-      f = -log_prob_propto<false>(_model, _x, _params_i, _msgs);
+      f = -log_prob_propto<Jacobian>(_model, _x, _params_i, _msgs);
     } catch (const std::exception &e) {
       if (_msgs)
         (*_msgs) << e.what() << std::endl;
@@ -337,7 +352,6 @@ class ModelAdaptor {
     using Eigen::Dynamic;
     using Eigen::Matrix;
     using stan::math::index_type;
-    using stan::model::log_prob_grad;
     typedef typename index_type<Matrix<double, Dynamic, 1> >::type idx_t;
 
     _x.resize(x.size());
@@ -347,7 +361,7 @@ class ModelAdaptor {
     _fevals++;
 
     try {
-      f = -log_prob_grad<true, false>(_model, _x, _params_i, _g, _msgs);
+      f = -_gradient(_x, _g, _msgs);
     } catch (const std::exception &e) {
       if (_msgs)
         (*_msgs) << e.what() << std::endl;
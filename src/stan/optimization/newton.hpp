@@ -26,15 +26,23 @@ inline void make_negative_definite_and_solve(matrix_d& H, vector_d& g) {
   g = eigenvectors * eigenprojections;
 }
 
+/**
+ * Takes a Newton step with a backtracking line search, computing the
+ * Hessian with the specified method and number of threads (see
+ * <code>stan::model::grad_hess_log_prob</code>).
+ *
+ * @return log density at the new parameters
+ */
 template <typename M>
 double newton_step(M& model, std::vector<double>& params_r,
                    std::vector<int>& params_i,
+                   stan::model::hessian_method method, int num_threads,
                    std::ostream* output_stream = 0) {
   std::vector<double> gradient;
   std::vector<double> hessian;
 
   double f0 = stan::model::grad_hess_log_prob<true, false>(
-      model, params_r, params_i, gradient, hessian);
+      model, params_r, params_i, gradient, hessian, method, num_threads);
   matrix_d H(params_r.size(), params_r.size());
   for (size_t i = 0; i < hessian.size(); i++) {
     H(i) = hessian[i];
@@ -71,6 +79,15 @@ double newton_step(M& model, std::vector<double>& params_r,
   return f1;
 }
 
+template <typename M>
+double newton_step(M& model, std::vector<double>& params_r,
+                   std::vector<int>& params_i,
+                   std::ostream* output_stream = 0) {
+  return newton_step(model, params_r, params_i,
+                     stan::model::hessian_method::finite_diff, 1,
+                     output_stream);
+}
+
 }  // namespace optimization
 }  // namespace stan
 #endif
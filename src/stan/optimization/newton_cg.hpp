@@ -0,0 +1,170 @@
+#ifndef STAN_OPTIMIZATION_NEWTON_CG_HPP
+#define STAN_OPTIMIZATION_NEWTON_CG_HPP
+
+#include <stan/math/mix.hpp>
+#include <stan/model/grad_hess_log_prob.hpp>
+#include <stan/model/log_prob_grad.hpp>
+#include <stan/optimization/newton.hpp>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace stan {
+namespace optimization {
+
+/**
+ * Returns the largest <code>tau >= 0</code> such that
+ * <code>|z + tau * d| <= radius</code>, where <code>|z| <=
+ * radius</code>.
+ */
+inline double trust_region_boundary(const vector_d& z, const vector_d& d,
+                                    double radius) {
+  double dd = d.squaredNorm();
+  double zd = z.dot(d);
+  double zz = z.squaredNorm();
+  double discriminant = zd * zd + dd * (radius * radius - zz);
+  return (-zd + std::sqrt(std::max(discriminant, 0.0))) / dd;
+}
+
+/**
+ * Approximately minimizes the quadratic model <code>g' p + p' B p /
+ * 2</code> subject to <code>|p| <= radius</code> with the
+ * Steihaug-Toint truncated conjugate gradient method, which only
+ * needs products of <code>B</code> with vectors.
+ *
+ * <p>The iterations stop when the residual falls below a tolerance
+ * that shrinks with the gradient norm, when a direction of
+ * nonpositive curvature is found, when the step reaches the trust
+ * region boundary, or after <code>max_iterations</code> iterations.
+ *
+ * @tparam F type of functor with signature <code>void(const
+ * vector_d& v, vector_d& Bv)</code>
+ * @param[in] B_times functor multiplying a vector by B
+ * @param[in] g gradient of the objective
+ * @param[in] radius trust region radius
+ * @param[in] max_iterations maximum number of iterations
+ * @param[out] p step
+ * @return decrease of the quadratic model, <code>-(g' p + p' B p /
+ * 2)</code>
+ */
+template <typename F>
+double steihaug_cg(const F& B_times, const vector_d& g, double radius,
+                   int max_iterations, vector_d& p) {
+  p = vector_d::Zero(g.size());
+  vector_d r = g;
+  vector_d d = -r;
+  vector_d Bd(g.size());
+  double rr = r.squaredNorm();
+  double tolerance = std::min(0.5, std::sqrt(std::sqrt(rr))) * std::sqrt(rr);
+  double model_change = 0;
+  for (int j = 0; j < max_iterations && std::sqrt(rr) > tolerance; ++j) {
+    B_times(d, Bd);
+    double dBd = d.dot(Bd);
+    double alpha = rr / dBd;
+    if (!(dBd > 0) || (p + alpha * d).norm() >= radius) {
+      double tau = trust_region_boundary(p, d, radius);
+      p += tau * d;
+      return -(model_change + tau * r.dot(d) + 0.5 * tau * tau * dBd);
+    }
+    model_change += alpha * r.dot(d) + 0.5 * alpha * alpha * dBd;
+    p += alpha * d;
+    r += alpha * Bd;
+    double rr_next = r.squaredNorm();
+    d = -r + (rr_next / rr) * d;
+    rr = rr_next;
+  }
+  return -model_change;
+}
+
+/**
+ * Takes a trust region Newton-CG step, maximizing the log density
+ * without forming its Hessian. The trust region subproblem is solved
+ * by <code>steihaug_cg</code> using Hessian-vector products computed
+ * with forward-over-reverse automatic differentiation, so each
+ * conjugate gradient iteration costs a small multiple of a gradient
+ * evaluation and memory is linear in the number of parameters.
+ *
+ * <p>Steps are proposed until one increases the log density, with
+ * the trust region radius adapted to the agreement between the
+ * quadratic model and the log density. If the gradient vanishes or
+ * the radius falls below <code>1e-12</code>, the parameters are left
+ * unchanged.
+ *
+ * @tparam jacobian true to include the Jacobian adjustment of the
+ * constraining transforms
+ * @tparam M model class
+ * @param[in] model model
+ * @param[in, out] params_r unconstrained parameters
+ * @param[in] params_i integer parameters
+ * @param[in, out] trust_radius trust region radius, updated for the
+ * next step
+ * @param[in] max_cg_iterations maximum number of conjugate gradient
+ * iterations; the number of parameters if not positive
+ * @param[in, out] output_stream stream for messages from the model
+ * @return log density at the new parameters
+ */
+template <bool jacobian = false, typename M>
+double newton_cg_step(M& model, std::vector<double>& params_r,
+                      std::vector<int>& params_i, double& trust_radius,
+                      int max_cg_iterations = 0,
+                      std::ostream* output_stream = 0) {
+  static const double min_trust_radius = 1e-12;
+  static const double max_trust_radius = 1e10;
+  static const double min_ratio = 1e-4;
+  const int D = params_r.size();
+  if (max_cg_iterations <= 0)
+    max_cg_iterations = D;
+
+  std::vector<double> gradient;
+  double f0 = stan::model::log_prob_grad<true, jacobian>(
+      model, params_r, params_i, gradient, output_stream);
+  vector_d x = Eigen::Map<vector_d>(params_r.data(), D);
+  // gradient of the negative log density
+  vector_d g = -Eigen::Map<vector_d>(gradient.data(), D);
+  if (!(g.norm() > 0))
+    return f0;
+
+  stan::model::internal::log_prob_functional<true, jacobian, M> log_prob(
+      model, output_stream);
+  auto B_times = [&](const vector_d& v, vector_d& Bv) {
+    double f;
+    stan::math::hessian_times_vector(log_prob, x, v, f, Bv);
+    Bv = -Bv;
+  };
+
+  vector_d p;
+  std::vector<double> new_params_r(D);
+  while (trust_radius >= min_trust_radius) {
+    double predicted = steihaug_cg(B_times, g, trust_radius,
+                                   max_cg_iterations, p);
+    if (!(predicted > 0))
+      return f0;
+    for (int i = 0; i < D; ++i)
+      new_params_r[i] = params_r[i] + p(i);
+    double f1;
+    try {
+      f1 = stan::model::log_prob_grad<true, jacobian>(
+          model, new_params_r, params_i, gradient, output_stream);
+    } catch (const std::exception& e) {
+      f1 = -std::numeric_limits<double>::infinity();
+    }
+    double ratio = std::isfinite(f1) ? (f1 - f0) / predicted : -1;
+    double step_norm = p.norm();
+    if (ratio < 0.25)
+      trust_radius = 0.25 * step_norm;
+    else if (ratio > 0.75 && step_norm >= 0.99 * trust_radius)
+      trust_radius = std::min(2 * trust_radius, max_trust_radius);
+    if (ratio > min_ratio && f1 > f0) {
+      params_r = new_params_r;
+      return f1;
+    }
+  }
+  return f0;
+}
+
+}  // namespace optimization
+}  // namespace stan
+#endif
@@ -58,6 +58,58 @@ int diagnose(Model& model, const stan::io::var_context& init,
   return num_failed;
 }
 
+/**
+ * Checks the gradients of the model computed using reverse mode
+ * autodiff against Richardson-extrapolated finite differences,
+ * checking a random sample of partial derivatives and random
+ * directional derivatives. See the overload of
+ * <code>stan::model::test_gradients</code> taking the number of
+ * coordinates and directions.
+ *
+ * @tparam Model A model implementation
+ * @param[in] model Input model to test (with data already instantiated)
+ * @param[in] init var context for initialization
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] chain chain id to advance the pseudo random number generator
+ * @param[in] init_radius radius to initialize
+ * @param[in] epsilon epsilon to use for finite differences, about
+ *   1e-3 (see <code>stan::model::finite_diff_grad</code>)
+ * @param[in] error amount of absolute error to allow
+ * @param[in] num_coordinates number of partial derivatives to check;
+ *   zero checks all of them
+ * @param[in] num_directions number of random directional derivatives
+ *   to check
+ * @param[in] num_threads number of threads for finite differences
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] init_writer Writer callback for unconstrained inits
+ * @param[in,out] parameter_writer Writer callback for file output
+ * @return the number of derivatives that are not within error
+ * of the finite difference calculation
+ */
+template <class Model>
+int diagnose(Model& model, const stan::io::var_context& init,
+             unsigned int random_seed, unsigned int chain, double init_radius,
+             double epsilon, double error, size_t num_coordinates,
+             size_t num_directions, int num_threads,
+             callbacks::interrupt& interrupt, callbacks::logger& logger,
+             callbacks::writer& init_writer,
+             callbacks::writer& parameter_writer) {
+  boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
+
+  std::vector<int> disc_vector;
+  std::vector<double> cont_vector = util::initialize(
+      model, init, rng, init_radius, false, logger, init_writer);
+
+  logger.info("TEST GRADIENT MODE");
+
+  int num_failed = stan::model::test_gradients<true, true>(
+      model, cont_vector, disc_vector, epsilon, error, num_coordinates,
+      num_directions, num_threads, rng, interrupt, logger, parameter_writer);
+
+  return num_failed;
+}
+
 }  // namespace diagnose
 }  // namespace services
 }  // namespace stan
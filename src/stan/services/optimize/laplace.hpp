@@ -0,0 +1,217 @@
+#ifndef STAN_SERVICES_OPTIMIZE_LAPLACE_HPP
+#define STAN_SERVICES_OPTIMIZE_LAPLACE_HPP
+
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/array_var_context.hpp>
+#include <stan/math/prim.hpp>
+#include <stan/model/grad_hess_log_prob.hpp>
+#include <stan/model/log_prob_batch.hpp>
+#include <stan/services/error_codes.hpp>
+#include <stan/services/sample/standalone_gqs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace optimize {
+namespace internal {
+
+/**
+ * Result of generating one draw from the Laplace approximation.
+ */
+struct laplace_draw {
+  /** True if the constrained values were generated. */
+  bool generated = false;
+  /** Messages from the model and error message, if any. */
+  std::stringstream msgs;
+  /** log_p__, log_g__ and the constrained values. */
+  std::vector<double> values;
+};
+
+/**
+ * Generates draw <code>draw</code> from the normal approximation with
+ * mean <code>theta_hat</code> and covariance <code>(L L')^-1</code>
+ * on the unconstrained scale. Touches no state shared with other
+ * draws, so it may be called concurrently for different draws.
+ */
+template <bool jacobian, class Model>
+void generate_laplace_draw(const Model& model, const Eigen::VectorXd& theta_hat,
+                           const Eigen::MatrixXd& L, size_t draw,
+                           unsigned int seed, laplace_draw& result) {
+  boost::ecuyer1988 rng = services::internal::create_draw_rng(seed, draw);
+  Eigen::VectorXd z(theta_hat.size());
+  for (int i = 0; i < z.size(); ++i)
+    z(i) = stan::math::normal_rng(0, 1, rng);
+  Eigen::VectorXd theta = theta_hat;
+  theta += L.transpose().triangularView<Eigen::Upper>().solve(z);
+
+  double log_p;
+  try {
+    log_p = model.template log_prob<false, jacobian>(theta, &result.msgs);
+  } catch (const std::exception& e) {
+    result.msgs << e.what() << std::endl;
+    log_p = -std::numeric_limits<double>::infinity();
+  }
+  std::vector<double> theta_r(theta.data(), theta.data() + theta.size());
+  std::vector<int> params_i;
+  try {
+    model.write_array(rng, theta_r, params_i, result.values, true, true,
+                      &result.msgs);
+  } catch (const std::exception& e) {
+    result.msgs << e.what();
+    return;
+  }
+  result.values.insert(result.values.begin(), {log_p, -0.5 * z.squaredNorm()});
+  result.generated = true;
+}
+
+}  // namespace internal
+
+/**
+ * Draws from the Laplace approximation to the posterior at a mode
+ * and writes them to the sample writer.
+ *
+ * <p>The mode is given on the constrained scale, in the order of the
+ * parameter columns of the optimizer output (without
+ * <code>lp__</code>). The Hessian of the log density on the
+ * unconstrained scale is computed at the mode with the specified
+ * method (see <code>stan::model::grad_hess_log_prob</code>), and its
+ * negative is factored as <code>L L'</code>. Each draw is
+ * <code>theta_hat + L'^-1 z</code> for a standard normal
+ * <code>z</code>, so the draws have covariance equal to the inverse
+ * of the negative Hessian.
+ *
+ * <p>The first two columns of the output are <code>log_p__</code>,
+ * the log density of the model at the draw including constants, and
+ * <code>log_g__</code>, the log density of the approximation up to a
+ * constant, <code>-z' z / 2</code>; their difference gives importance
+ * weights. They are followed by the values of
+ * <code>write_array</code> with transformed parameters and generated
+ * quantities. When compiled with <code>STAN_THREADS</code>, the
+ * Hessian and the draws are computed by up to
+ * <code>num_threads</code> threads, each with its own autodiff stack;
+ * each draw uses its own pseudo
+ * random number stream, so the output does not depend on the number
+ * of threads.
+ *
+ * @tparam jacobian true to approximate the posterior of the
+ *   unconstrained parameters, including the Jacobian adjustment of
+ *   the constraining transforms, false to approximate around the
+ *   mode found by the optimizers without it
+ * @tparam Model A model implementation
+ * @param[in] model the Stan model instantiated with data
+ * @param[in] theta_hat mode on the constrained scale
+ * @param[in] draws number of draws
+ * @param[in] random_seed random seed for the random number generator
+ * @param[in] method method used to compute the Hessian
+ * @param[in] num_threads number of threads
+ * @param[in,out] interrupt callback to be called every draw
+ * @param[in,out] logger Logger for messages
+ * @param[in,out] sample_writer output for the draws
+ * @return error_codes::OK if successful
+ */
+template <bool jacobian, class Model>
+int laplace_sample(const Model& model, const Eigen::VectorXd& theta_hat,
+                   int draws, unsigned int random_seed,
+                   stan::model::hessian_method method, int num_threads,
+                   callbacks::interrupt& interrupt, callbacks::logger& logger,
+                   callbacks::writer& sample_writer) {
+  if (draws < 0) {
+    logger.error("Number of draws must be non-negative.");
+    return error_codes::CONFIG;
+  }
+  if (num_threads < 1) {
+    logger.error("Number of threads must be positive.");
+    return error_codes::CONFIG;
+  }
+  std::vector<std::string> p_names;
+  model.constrained_param_names(p_names, false, false);
+  if (p_names.size() != static_cast<size_t>(theta_hat.size())) {
+    std::stringstream msg;
+    msg << "Wrong number of parameter values in mode. Expecting "
+        << p_names.size() << " values, found " << theta_hat.size() << ".";
+    logger.error(msg);
+    return error_codes::DATAERR;
+  }
+
+  std::stringstream msgs;
+  std::vector<int> params_i;
+  std::vector<double> params_r;
+  std::vector<double> gradient;
+  std::vector<double> hessian;
+  try {
+    std::vector<std::string> param_names;
+    std::vector<std::vector<size_t>> param_dimss;
+    get_model_parameters(model, param_names, param_dimss);
+    stan::io::array_var_context context(param_names, theta_hat, param_dimss);
+    model.transform_inits(context, params_i, params_r, &msgs);
+    stan::model::grad_hess_log_prob<true, jacobian>(
+        model, params_r, params_i, gradient, hessian, method, num_threads,
+        &msgs);
+  } catch (const std::exception& e) {
+    if (msgs.str().length() > 0)
+      logger.info(msgs);
+    logger.error(e.what());
+    return error_codes::DATAERR;
+  }
+  if (msgs.str().length() > 0)
+    logger.info(msgs);
+
+  const int D = params_r.size();
+  Eigen::MatrixXd neg_hessian = -Eigen::Map<Eigen::MatrixXd>(
+      hessian.data(), D, D);
+  Eigen::LLT<Eigen::MatrixXd> llt(neg_hessian);
+  const Eigen::MatrixXd L = llt.matrixL();
+  if (llt.info() != Eigen::Success || !L.diagonal().allFinite()) {
+    logger.error(
+        "The Hessian of the log density at the mode is not negative "
+        "definite.");
+    return error_codes::DATAERR;
+  }
+  const Eigen::VectorXd theta_unc
+      = Eigen::Map<Eigen::VectorXd>(params_r.data(), D);
+
+  std::vector<std::string> names;
+  names.push_back("log_p__");
+  names.push_back("log_g__");
+  model.constrained_param_names(names, true, true);
+  sample_writer(names);
+
+  const size_t batch_size = 64 * static_cast<size_t>(num_threads);
+  std::vector<internal::laplace_draw> results;
+  for (size_t begin = 0; begin < static_cast<size_t>(draws);
+       begin += batch_size) {
+    const size_t end = std::min(static_cast<size_t>(draws), begin + batch_size);
+    results.clear();
+    results.resize(end - begin);
+    stan::model::internal::for_each_row_worker(
+        end - begin, num_threads, 0,
+        [&](size_t k, size_t num_workers, std::ostream*) {
+          for (size_t n = begin + k; n < end; n += num_workers)
+            internal::generate_laplace_draw<jacobian>(
+                model, theta_unc, L, n, random_seed, results[n - begin]);
+        });
+    for (internal::laplace_draw& result : results) {
+      interrupt();
+      if (!result.generated) {
+        logger.error(result.msgs);
+        return error_codes::SOFTWARE;
+      }
+      if (result.msgs.str().length() > 0)
+        logger.info(result.msgs);
+      sample_writer(result.values);
+    }
+  }
+  return error_codes::OK;
+}
+
+}  // namespace optimize
+}  // namespace services
+}  // namespace stan
+#endif
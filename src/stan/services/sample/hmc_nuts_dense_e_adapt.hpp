@@ -51,6 +51,11 @@ namespace sample {
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] sample_writer Writer for draws
  * @param[in,out] diagnostic_writer Writer for diagnostic information
+ * @param[in] async_output if true, the transformed parameters and
+ *   generated quantities are computed and the draws written on a
+ *   background thread (see <code>util::async_mcmc_writer</code>); the
+ *   generated quantities then use their own random number generator,
+ *   so random generated quantities differ from a run without it
  * @return error_codes::OK if successful
  */
 template <class Model>
@@ -63,7 +68,8 @@ int hmc_nuts_dense_e_adapt(
     double kappa, double t0, unsigned int init_buffer, unsigned int term_buffer,
     unsigned int window, callbacks::interrupt& interrupt,
     callbacks::logger& logger, callbacks::writer& init_writer,
-    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer) {
+    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer,
+    bool async_output = false) {
   boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
   std::vector<int> disc_vector;
@@ -96,9 +102,18 @@ int hmc_nuts_dense_e_adapt(
   sampler.set_window_params(num_warmup, init_buffer, term_buffer, window,
                             logger);
 
-  util::run_adaptive_sampler(
-      sampler, model, cont_vector, num_warmup, num_samples, num_thin, refresh,
-      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer);
+  if (async_output) {
+    boost::ecuyer1988 output_rng = util::create_output_rng(random_seed, chain);
+    util::run_adaptive_sampler(sampler, model, cont_vector, num_warmup,
+                               num_samples, num_thin, refresh, save_warmup,
+                               rng, interrupt, logger, sample_writer,
+                               diagnostic_writer, output_rng);
+  } else {
+    util::run_adaptive_sampler(sampler, model, cont_vector, num_warmup,
+                               num_samples, num_thin, refresh, save_warmup,
+                               rng, interrupt, logger, sample_writer,
+                               diagnostic_writer);
+  }
 
   return error_codes::OK;
 }
@@ -133,6 +148,11 @@ int hmc_nuts_dense_e_adapt(
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] sample_writer Writer for draws
  * @param[in,out] diagnostic_writer Writer for diagnostic information
+ * @param[in] async_output if true, the transformed parameters and
+ *   generated quantities are computed and the draws written on a
+ *   background thread (see <code>util::async_mcmc_writer</code>); the
+ *   generated quantities then use their own random number generator,
+ *   so random generated quantities differ from a run without it
  * @return error_codes::OK if successful
  */
 template <class Model>
@@ -144,7 +164,8 @@ int hmc_nuts_dense_e_adapt(
     double kappa, double t0, unsigned int init_buffer, unsigned int term_buffer,
     unsigned int window, callbacks::interrupt& interrupt,
     callbacks::logger& logger, callbacks::writer& init_writer,
-    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer) {
+    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer,
+    bool async_output = false) {
   stan::io::dump dmp
       = util::create_unit_e_dense_inv_metric(model.num_params_r());
   stan::io::var_context& unit_e_metric = dmp;
@@ -153,7 +174,8 @@ int hmc_nuts_dense_e_adapt(
       model, init, unit_e_metric, random_seed, chain, init_radius, num_warmup,
       num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
       max_depth, delta, gamma, kappa, t0, init_buffer, term_buffer, window,
-      interrupt, logger, init_writer, sample_writer, diagnostic_writer);
+      interrupt, logger, init_writer, sample_writer, diagnostic_writer,
+      async_output);
 }
 
 }  // namespace sample
@@ -12,6 +12,7 @@
 #include <stan/services/util/run_adaptive_sampler.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
+#include <stan/services/util/initialize_pathfinder.hpp>
 #include <stan/services/util/inv_metric.hpp>
 #include <vector>
 
@@ -51,6 +52,14 @@ namespace sample {
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] sample_writer Writer for draws
  * @param[in,out] diagnostic_writer Writer for diagnostic information
+ * @param[in] num_pathfinder_paths if positive, the initial values
+ *   and the initial inverse metric are found by that many Pathfinder
+ *   paths (see <code>util::initialize_pathfinder</code>), each run for
+ *   at most 1000 L-BFGS iterations with 25 draws to estimate the ELBO
+ *   and 1000 draws for importance resampling; the metric given is
+ *   used if no path finds an approximation
+ * @param[in] num_threads maximum number of threads running Pathfinder
+ *   paths when compiled with <code>STAN_THREADS</code>
  * @return error_codes::OK if successful
  */
 template <class Model>
@@ -63,12 +72,15 @@ int hmc_static_diag_e_adapt(
     double kappa, double t0, unsigned int init_buffer, unsigned int term_buffer,
     unsigned int window, callbacks::interrupt& interrupt,
     callbacks::logger& logger, callbacks::writer& init_writer,
-    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer) {
+    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer,
+    int num_pathfinder_paths = 0, int num_threads = 1) {
   boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
   std::vector<int> disc_vector;
-  std::vector<double> cont_vector = util::initialize(
-      model, init, rng, init_radius, true, logger, init_writer);
+  Eigen::VectorXd pathfinder_inv_metric;
+  std::vector<double> cont_vector = util::initialize_pathfinder(
+      model, init, rng, init_radius, num_pathfinder_paths, 1000, 25, 1000,
+      num_threads, true, logger, init_writer, pathfinder_inv_metric);
 
   Eigen::VectorXd inv_metric;
   try {
@@ -78,6 +90,8 @@ int hmc_static_diag_e_adapt(
   } catch (const std::domain_error& e) {
     return error_codes::CONFIG;
   }
+  if (pathfinder_inv_metric.size() > 0)
+    inv_metric = pathfinder_inv_metric;
 
   stan::mcmc::adapt_diag_e_static_hmc<Model, boost::ecuyer1988> sampler(model,
                                                                         rng);
@@ -132,6 +146,14 @@ int hmc_static_diag_e_adapt(
  * @param[in,out] init_writer Writer callback for unconstrained inits
  * @param[in,out] sample_writer Writer for draws
  * @param[in,out] diagnostic_writer Writer for diagnostic information
+ * @param[in] num_pathfinder_paths if positive, the initial values
+ *   and the initial inverse metric are found by that many Pathfinder
+ *   paths (see <code>util::initialize_pathfinder</code>), each run for
+ *   at most 1000 L-BFGS iterations with 25 draws to estimate the ELBO
+ *   and 1000 draws for importance resampling; the unit metric is
+ *   used if no path finds an approximation
+ * @param[in] num_threads maximum number of threads running Pathfinder
+ *   paths when compiled with <code>STAN_THREADS</code>
  * @return error_codes::OK if successful
  */
 template <class Model>
@@ -143,7 +165,8 @@ int hmc_static_diag_e_adapt(
     double kappa, double t0, unsigned int init_buffer, unsigned int term_buffer,
     unsigned int window, callbacks::interrupt& interrupt,
     callbacks::logger& logger, callbacks::writer& init_writer,
-    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer) {
+    callbacks::writer& sample_writer, callbacks::writer& diagnostic_writer,
+    int num_pathfinder_paths = 0, int num_threads = 1) {
   stan::io::dump dmp
       = util::create_unit_e_diag_inv_metric(model.num_params_r());
   stan::io::var_context& unit_e_metric = dmp;
@@ -152,7 +175,8 @@ int hmc_static_diag_e_adapt(
       model, init, unit_e_metric, random_seed, chain, init_radius, num_warmup,
       num_samples, num_thin, save_warmup, refresh, stepsize, stepsize_jitter,
       int_time, delta, gamma, kappa, t0, init_buffer, term_buffer, window,
-      interrupt, logger, init_writer, sample_writer, diagnostic_writer);
+      interrupt, logger, init_writer, sample_writer, diagnostic_writer,
+      num_pathfinder_paths, num_threads);
 }
 
 }  // namespace sample
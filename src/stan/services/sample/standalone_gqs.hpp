@@ -5,11 +5,16 @@
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/array_var_context.hpp>
+#include <stan/io/stan_csv_reader.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/gq_writer.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/model/log_prob_batch.hpp>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <istream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -50,6 +55,168 @@ void get_model_parameters(const Model &model,
   }
 }
 
+namespace internal {
+
+/**
+ * Generates the quantities of interest for each row of draws of the
+ * constrained parameters.
+ *
+ * @return error code
+ */
+template <class Model, class RNG>
+int generate_gqs(const Model &model, const Eigen::MatrixXd &draws,
+                 const std::vector<std::string> &param_names,
+                 const std::vector<std::vector<size_t>> &param_dimss,
+                 RNG &rng, callbacks::interrupt &interrupt,
+                 callbacks::logger &logger, util::gq_writer &writer) {
+  std::stringstream msg;
+  std::vector<int> dummy_params_i;
+  std::vector<double> unconstrained_params_r;
+  for (size_t i = 0; i < draws.rows(); ++i) {
+    dummy_params_i.clear();
+    unconstrained_params_r.clear();
+    try {
+      stan::io::array_var_context context(param_names, draws.row(i),
+                                          param_dimss);
+      model.transform_inits(context, dummy_params_i, unconstrained_params_r,
+                            &msg);
+    } catch (const std::exception &e) {
+      if (msg.str().length() > 0)
+        logger.error(msg);
+      logger.error(e.what());
+      return error_codes::DATAERR;
+    }
+    interrupt();  // call out to interrupt and fail
+    writer.write_gq_values(model, rng, unconstrained_params_r);
+  }
+  return error_codes::OK;
+}
+
+/**
+ * Creates the pseudo random number generator for the draw with the
+ * specified index. Each draw uses its own segment of the sequence of
+ * the generator returned by <code>create_rng(seed, 1)</code>, so the
+ * quantities generated for a draw do not depend on the order in which
+ * draws are processed or on the number of threads.
+ *
+ * <p>The segments are 2^24 values long. A draw that takes more values
+ * than that runs into the segment of the next draw, so the two share
+ * part of their random numbers. The period of the generator leaves
+ * room for about 2^37 draws.
+ *
+ * @param[in] seed the random seed
+ * @param[in] draw index of the draw, starting from zero
+ * @return a boost::ecuyer1988 instance
+ */
+inline boost::ecuyer1988 create_draw_rng(unsigned int seed, size_t draw) {
+  static const boost::uintmax_t DISCARD_STRIDE
+      = static_cast<boost::uintmax_t>(1) << 24;
+  boost::ecuyer1988 rng = util::create_rng(seed, 1);
+  rng.discard(DISCARD_STRIDE * draw);
+  return rng;
+}
+
+/**
+ * Result of generating the quantities of interest for one draw.
+ */
+struct gq_result {
+  /** Error code of reading the draw. */
+  int return_code = error_codes::OK;
+  /** True if the quantities were generated. */
+  bool generated = false;
+  /** Messages from the model and error message, if any. */
+  std::stringstream msgs;
+  /** Generated quantities. */
+  std::vector<double> gq_values;
+};
+
+/**
+ * Generates the quantities of interest for a single draw into the
+ * specified result. Touches no state shared with other draws, so it
+ * may be called concurrently for different draws.
+ */
+template <class Model>
+void generate_gq_draw(const Model &model, const Eigen::MatrixXd &draws,
+                      size_t row, size_t draw,
+                      const std::vector<std::string> &param_names,
+                      const std::vector<std::vector<size_t>> &param_dimss,
+                      unsigned int seed, const util::gq_writer &writer,
+                      gq_result &result) {
+  std::vector<int> dummy_params_i;
+  std::vector<double> unconstrained_params_r;
+  try {
+    stan::io::array_var_context context(param_names, draws.row(row),
+                                        param_dimss);
+    model.transform_inits(context, dummy_params_i, unconstrained_params_r,
+                          &result.msgs);
+  } catch (const std::exception &e) {
+    result.msgs << e.what();
+    result.return_code = error_codes::DATAERR;
+    return;
+  }
+  boost::ecuyer1988 rng = create_draw_rng(seed, draw);
+  result.generated = writer.compute_gq_values(
+      model, rng, unconstrained_params_r, result.gq_values, result.msgs);
+}
+
+/**
+ * Generates the quantities of interest for each row of draws of the
+ * constrained parameters using the specified number of threads.
+ *
+ * <p>Draws are processed in batches of <code>64 * num_threads</code>
+ * rows. Within a batch, the workers of
+ * <code>stan::model::internal::for_each_row_worker</code>, each with
+ * its own autodiff stack, take rows in turn and store the generated
+ * quantities and model messages in per-draw buffers; the calling
+ * thread then logs the messages and writes the rows in draw order.
+ * The generator of each draw is created by
+ * <code>create_draw_rng</code>, so the output does not depend on the
+ * number of threads. Without <code>STAN_THREADS</code> the rows are
+ * processed by the calling thread.
+ *
+ * @param[in] first_draw index of the first row among all draws
+ * @return error code
+ */
+template <class Model>
+int generate_gqs_parallel(const Model &model, const Eigen::MatrixXd &draws,
+                          size_t first_draw,
+                          const std::vector<std::string> &param_names,
+                          const std::vector<std::vector<size_t>> &param_dimss,
+                          unsigned int seed, int num_threads,
+                          callbacks::interrupt &interrupt,
+                          callbacks::logger &logger,
+                          util::gq_writer &writer) {
+  const size_t num_rows = draws.rows();
+  const size_t batch_size = 64 * static_cast<size_t>(num_threads);
+  std::vector<gq_result> results;
+  for (size_t begin = 0; begin < num_rows; begin += batch_size) {
+    const size_t end = std::min(num_rows, begin + batch_size);
+    results.clear();
+    results.resize(end - begin);
+    stan::model::internal::for_each_row_worker(
+        end - begin, num_threads, 0,
+        [&](size_t k, size_t num_workers, std::ostream *) {
+          for (size_t i = begin + k; i < end; i += num_workers)
+            generate_gq_draw(model, draws, i, first_draw + i, param_names,
+                             param_dimss, seed, writer, results[i - begin]);
+        });
+    for (gq_result &result : results) {
+      if (result.return_code != error_codes::OK) {
+        logger.error(result.msgs);
+        return result.return_code;
+      }
+      interrupt();  // call out to interrupt and fail
+      if (result.msgs.str().length() > 0)
+        logger.info(result.msgs);
+      if (result.generated)
+        writer.write_gq_values(result.gq_values);
+    }
+  }
+  return error_codes::OK;
+}
+
+}  // namespace internal
+
 /**
  * Given a set of draws from a fitted model, generate corresponding
  * quantities of interest which are written to callback writer.
@@ -101,29 +268,239 @@ int standalone_generate(const Model &model, const Eigen::MatrixXd &draws,
   std::vector<std::string> param_names;
   std::vector<std::vector<size_t>> param_dimss;
   get_model_parameters(model, param_names, param_dimss);
+  return internal::generate_gqs(model, draws, param_names, param_dimss, rng,
+                                interrupt, logger, writer);
+}
 
-  std::vector<int> dummy_params_i;
-  std::vector<double> unconstrained_params_r;
-  for (size_t i = 0; i < draws.rows(); ++i) {
-    dummy_params_i.clear();
-    unconstrained_params_r.clear();
-    try {
-      stan::io::array_var_context context(param_names, draws.row(i),
-                                          param_dimss);
-      model.transform_inits(context, dummy_params_i, unconstrained_params_r,
-                            &msg);
-    } catch (const std::exception &e) {
-      if (msg.str().length() > 0)
-        logger.error(msg);
-      logger.error(e.what());
-      return error_codes::DATAERR;
+/**
+ * Given a set of draws from a fitted model, generate corresponding
+ * quantities of interest which are written to callback writer,
+ * processing the draws with the specified number of threads.
+ * Matrix of draws consists of one row per draw, one column per parameter.
+ * Rows are written in the order of the draws. Each draw uses its own
+ * pseudo random number stream, so the output is the same for any
+ * number of threads, but differs from that of the serial
+ * <code>standalone_generate</code>.
+ * Return code indicates success or type of error.
+ *
+ * @tparam Model model class
+ * @param[in] model instantiated model
+ * @param[in] draws sequence of draws of constrained parameters
+ * @param[in] seed seed to use for randomization
+ * @param[in] num_threads number of threads, used only when compiled
+ *   with <code>STAN_THREADS</code>
+ * @param[in, out] interrupt called every iteration
+ * @param[in, out] logger logger to which to write warning and error messages
+ * @param[in, out] sample_writer writer to which draws are written
+ * @return error code
+ */
+template <class Model>
+int standalone_generate(const Model &model, const Eigen::MatrixXd &draws,
+                        unsigned int seed, int num_threads,
+                        callbacks::interrupt &interrupt,
+                        callbacks::logger &logger,
+                        callbacks::writer &sample_writer) {
+  if (num_threads < 1) {
+    logger.error("Number of threads must be positive.");
+    return error_codes::CONFIG;
+  }
+  if (draws.size() == 0) {
+    logger.error("Empty set of draws from fitted model.");
+    return error_codes::DATAERR;
+  }
+
+  std::vector<std::string> p_names;
+  model.constrained_param_names(p_names, false, false);
+  std::vector<std::string> gq_names;
+  model.constrained_param_names(gq_names, false, true);
+  if (!(p_names.size() < gq_names.size())) {
+    logger.error("Model doesn't generate any quantities of interest.");
+    return error_codes::CONFIG;
+  }
+
+  std::stringstream msg;
+  if (p_names.size() != draws.cols()) {
+    msg << "Wrong number of parameter values in draws from fitted model.  ";
+    msg << "Expecting " << p_names.size() << " columns, ";
+    msg << "found " << draws.cols() << " columns.";
+    std::string msgstr = msg.str();
+    logger.error(msgstr);
+    return error_codes::DATAERR;
+  }
+  util::gq_writer writer(sample_writer, logger, p_names.size());
+  writer.write_gq_names(model);
+
+  std::vector<std::string> param_names;
+  std::vector<std::vector<size_t>> param_dimss;
+  get_model_parameters(model, param_names, param_dimss);
+  return internal::generate_gqs_parallel(model, draws, 0, param_names,
+                                         param_dimss, seed, num_threads,
+                                         interrupt, logger, writer);
+}
+
+namespace internal {
+
+/**
+ * Generates the quantities of interest for the draws in a Stan CSV
+ * stream, serially with the generator of <code>create_rng(seed,
+ * 1)</code> if <code>num_threads</code> is zero and with
+ * <code>generate_gqs_parallel</code> otherwise.
+ *
+ * @return error code
+ */
+template <class Model>
+int standalone_generate_csv(const Model &model, std::istream &draws_csv,
+                            size_t chunk_rows, unsigned int seed,
+                            int num_threads, callbacks::interrupt &interrupt,
+                            callbacks::logger &logger,
+                            callbacks::writer &sample_writer) {
+  std::vector<std::string> p_names;
+  model.constrained_param_names(p_names, false, false);
+  std::vector<std::string> gq_names;
+  model.constrained_param_names(gq_names, false, true);
+  if (!(p_names.size() < gq_names.size())) {
+    logger.error("Model doesn't generate any quantities of interest.");
+    return error_codes::CONFIG;
+  }
+
+  // the reader writes "a.1.2" in the header as "a[1,2]"
+  std::vector<std::string> columns(p_names);
+  for (std::string &column : columns) {
+    size_t pos = column.find('.');
+    if (pos != std::string::npos) {
+      column.replace(pos, 1, "[");
+      std::replace(column.begin(), column.end(), '.', ',');
+      column += "]";
     }
-    interrupt();  // call out to interrupt and fail
-    writer.write_gq_values(model, rng, unconstrained_params_r);
+  }
+
+  util::gq_writer writer(sample_writer, logger, p_names.size());
+  boost::ecuyer1988 rng = util::create_rng(seed, 1);
+  std::vector<std::string> param_names;
+  std::vector<std::vector<size_t>> param_dimss;
+  get_model_parameters(model, param_names, param_dimss);
+
+  bool names_written = false;
+  size_t num_draws = 0;
+  int return_code = error_codes::OK;
+  auto generate = [&](const Eigen::MatrixXd &draws) {
+    if (return_code != error_codes::OK)
+      return;
+    if (!names_written) {
+      writer.write_gq_names(model);
+      names_written = true;
+    }
+    if (num_threads == 0)
+      return_code = generate_gqs(model, draws, param_names, param_dimss, rng,
+                                 interrupt, logger, writer);
+    else
+      return_code = generate_gqs_parallel(model, draws, num_draws,
+                                          param_names, param_dimss, seed,
+                                          num_threads, interrupt, logger,
+                                          writer);
+    num_draws += draws.rows();
+  };
+  stan::io::stan_csv csv;
+  std::stringstream msgs;
+  bool read = false;
+  try {
+    stan::io::stan_csv_reader::read_metadata(draws_csv, csv.metadata, nullptr);
+    if (!stan::io::stan_csv_reader::read_header(draws_csv, csv.header,
+                                                nullptr))
+      throw std::invalid_argument("Error with header of input file.");
+    stan::io::stan_csv_reader::read_adaptation(draws_csv, csv.adaptation,
+                                               nullptr);
+    std::vector<int> indices
+        = stan::io::stan_csv_reader::column_indices(csv.header, columns);
+    csv.timing.warmup = 0;
+    csv.timing.sampling = 0;
+    read = stan::io::stan_csv_reader::read_samples(
+        draws_csv, indices, chunk_rows, generate, csv.timing, &msgs);
+  } catch (const std::invalid_argument &e) {
+    logger.error(e.what());
+    return error_codes::DATAERR;
+  }
+  if (return_code != error_codes::OK)
+    return return_code;
+  // read_samples only fails without a message if there are no draws
+  if (!read && msgs.str().length() > 0) {
+    logger.error(msgs);
+    return error_codes::DATAERR;
+  }
+  if (num_draws == 0) {
+    logger.error("Empty set of draws from fitted model.");
+    return error_codes::DATAERR;
   }
   return error_codes::OK;
 }
 
+}  // namespace internal
+
+/**
+ * Given a Stan CSV file of draws from a fitted model, generate
+ * corresponding quantities of interest which are written to callback
+ * writer. Only the columns of the parameters are read, and they are
+ * read in chunks of at most <code>chunk_rows</code> draws, so memory
+ * use does not grow with the number of draws or with the number of
+ * other columns in the file.
+ * Return code indicates success or type of error.
+ *
+ * @tparam Model model class
+ * @param[in] model instantiated model
+ * @param[in,out] draws_csv stream of the Stan CSV file of the fit
+ * @param[in] chunk_rows maximum number of draws held in memory
+ * @param[in] seed seed to use for randomization
+ * @param[in, out] interrupt called every iteration
+ * @param[in, out] logger logger to which to write warning and error messages
+ * @param[in, out] sample_writer writer to which draws are written
+ * @return error code
+ */
+template <class Model>
+int standalone_generate(const Model &model, std::istream &draws_csv,
+                        size_t chunk_rows, unsigned int seed,
+                        callbacks::interrupt &interrupt,
+                        callbacks::logger &logger,
+                        callbacks::writer &sample_writer) {
+  return internal::standalone_generate_csv(model, draws_csv, chunk_rows, seed,
+                                         0, interrupt, logger, sample_writer);
+}
+
+/**
+ * Given a Stan CSV file of draws from a fitted model, generate
+ * corresponding quantities of interest which are written to callback
+ * writer, processing each chunk of draws with the specified number of
+ * threads. Rows are written in the order of the draws and the output
+ * is the same for any number of threads and chunk size; see the
+ * overload taking a matrix of draws.
+ * Return code indicates success or type of error.
+ *
+ * @tparam Model model class
+ * @param[in] model instantiated model
+ * @param[in,out] draws_csv stream of the Stan CSV file of the fit
+ * @param[in] chunk_rows maximum number of draws held in memory
+ * @param[in] seed seed to use for randomization
+ * @param[in] num_threads number of threads, used only when compiled
+ *   with <code>STAN_THREADS</code>
+ * @param[in, out] interrupt called every iteration
+ * @param[in, out] logger logger to which to write warning and error messages
+ * @param[in, out] sample_writer writer to which draws are written
+ * @return error code
+ */
+template <class Model>
+int standalone_generate(const Model &model, std::istream &draws_csv,
+                        size_t chunk_rows, unsigned int seed,
+                        int num_threads, callbacks::interrupt &interrupt,
+                        callbacks::logger &logger,
+                        callbacks::writer &sample_writer) {
+  if (num_threads < 1) {
+    logger.error("Number of threads must be positive.");
+    return error_codes::CONFIG;
+  }
+  return internal::standalone_generate_csv(model, draws_csv, chunk_rows, seed,
+                                           num_threads, interrupt, logger,
+                                           sample_writer);
+}
+
 }  // namespace services
 }  // namespace stan
 #endif
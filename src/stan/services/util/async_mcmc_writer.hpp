@@ -0,0 +1,329 @@
+#ifndef STAN_SERVICES_UTIL_ASYNC_MCMC_WRITER_HPP
+#define STAN_SERVICES_UTIL_ASYNC_MCMC_WRITER_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/math/rev.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/services/util/mcmc_writer.hpp>
+#include <stan/services/util/spsc_queue.hpp>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef STAN_THREADS
+#include <thread>
+#endif
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Creates the pseudo random number generator used by the writer
+ * thread of an <code>async_mcmc_writer</code> for the chain with the
+ * specified id. It starts pow(2, 49) draws into the segment of the
+ * sequence that <code>create_rng(seed, chain)</code> gives the chain,
+ * so it does not overlap the sampler's draws unless a chain takes
+ * more than that many.
+ *
+ * @param[in] seed the random seed
+ * @param[in] chain the chain id
+ * @return a boost::ecuyer1988 instance
+ */
+inline boost::ecuyer1988 create_output_rng(unsigned int seed,
+                                           unsigned int chain) {
+  boost::ecuyer1988 rng = create_rng(seed, chain);
+  rng.discard(static_cast<boost::uintmax_t>(1) << 49);
+  return rng;
+}
+
+/**
+ * <code>async_mcmc_writer</code> writes draws on a background thread
+ * so that the sampling thread only generates transitions.
+ *
+ * The sampling thread copies the sample and sampler parameters and
+ * the unconstrained parameters into a bounded lock-free queue. The
+ * writer thread runs <code>model.write_array()</code> (transformed
+ * parameters and generated quantities) with its own random number
+ * generator and passes the values to the sample and diagnostic
+ * writers in the order the draws were generated.
+ *
+ * The writer thread has its own autodiff stack, so generated
+ * quantities may use nested autodiff. Without <code>STAN_THREADS</code>
+ * the autodiff stack is shared by all threads, so no writer thread is
+ * started and each draw is written on the calling thread when it is
+ * queued, as with <code>mcmc_writer</code>. An exception thrown by
+ * the sample or diagnostic writer on the writer thread is rethrown on
+ * the calling thread by the next <code>flush()</code>.
+ *
+ * Every other output (headers, adaptation info, timing) is written
+ * by the calling thread after the queue has been drained, so the
+ * output is ordered as with <code>mcmc_writer</code>. Model messages
+ * raised on the writer thread are logged from the calling thread on
+ * the next <code>flush()</code>.
+ *
+ * The generated quantities use the random number generator given to
+ * the constructor rather than the sampler's, so the draws differ from
+ * a run with <code>mcmc_writer</code> for models with random
+ * generated quantities, and that generator is not captured by
+ * checkpoints.
+ *
+ * @tparam Model model class
+ * @tparam RNG random number generator class
+ */
+template <class Model, class RNG>
+class async_mcmc_writer : public mcmc_writer {
+ private:
+  /**
+   * Logger used on the writer thread; keeps the messages until the
+   * calling thread logs them.
+   */
+  class buffer_logger : public callbacks::logger {
+   public:
+    void info(const std::string& message) { messages_.push_back(message); }
+
+    void info(const std::stringstream& message) {
+      messages_.push_back(message.str());
+    }
+
+    std::vector<std::string> messages_;
+  };
+
+  /**
+   * Unit of work for the writer thread.
+   */
+  struct job {
+    enum kind { stop, sample, diagnostic };
+    kind type;
+    std::vector<double> values;
+    std::vector<double> cont_params;
+  };
+
+ public:
+  /**
+   * Constructor. Starts the writer thread when compiled with
+   * <code>STAN_THREADS</code>.
+   *
+   * @param[in,out] sample_writer samples are "written" to this stream
+   * @param[in,out] diagnostic_writer diagnostic info is "written" to this
+   *   stream
+   * @param[in,out] logger messages are written through the logger
+   * @param[in] model model used by the writer thread
+   * @param[in,out] rng random number generator used only by the writer
+   *   thread to generate quantities; must not be shared with the
+   *   sampler
+   * @param[in] capacity maximum number of queued draws
+   */
+  async_mcmc_writer(callbacks::writer& sample_writer,
+                    callbacks::writer& diagnostic_writer,
+                    callbacks::logger& logger, Model& model, RNG& rng,
+                    size_t capacity = 1024)
+      : mcmc_writer(sample_writer, diagnostic_writer, logger),
+        model_(model),
+        rng_(rng),
+        queue_(2 * capacity),
+        num_pushed_(0),
+        num_written_(0) {
+#ifdef STAN_THREADS
+    worker_ = std::thread(&async_mcmc_writer::run, this);
+#endif
+  }
+
+  async_mcmc_writer(const async_mcmc_writer&) = delete;
+  async_mcmc_writer& operator=(const async_mcmc_writer&) = delete;
+
+  /**
+   * Destructor. Writes the remaining draws and stops the writer
+   * thread.
+   */
+  ~async_mcmc_writer() {
+#ifdef STAN_THREADS
+    job done;
+    done.type = job::stop;
+    queue_.push(done);
+    worker_.join();
+#endif
+    log_messages();
+    if (error_) {
+      try {
+        std::rethrow_exception(error_);
+      } catch (const std::exception& e) {
+        logger_.error(e.what());
+      } catch (...) {
+        logger_.error("Unknown exception writing draws.");
+      }
+    }
+  }
+
+  /**
+   * Queues a draw. The sample and sampler parameters are copied now;
+   * the model parameters are computed and the draw written on the
+   * writer thread.
+   *
+   * @tparam M model class
+   * @tparam R random number generator class
+   * @param[in] rng unused; the writer thread uses its own generator
+   * @param[in] sample the sample in unconstrained space
+   * @param[in] sampler the sampler
+   * @param[in] model unused; the writer thread uses the model given
+   *   to the constructor
+   */
+  template <class M, class R>
+  void write_sample_params(R& rng, stan::mcmc::sample& sample,
+                           stan::mcmc::base_mcmc& sampler, M& model) {
+    job draw;
+    draw.type = job::sample;
+    sample.get_sample_params(draw.values);
+    sampler.get_sampler_params(draw.values);
+    draw.values.reserve(draw.values.size() + num_model_params_);
+    draw.cont_params.assign(
+        sample.cont_params().data(),
+        sample.cont_params().data() + sample.cont_params().size());
+    push(draw);
+    ++num_draws_;
+  }
+
+  /**
+   * Queues the diagnostic parameters of a draw.
+   *
+   * @param[in] sample unconstrained sample
+   * @param[in] sampler sampler
+   */
+  void write_diagnostic_params(stan::mcmc::sample& sample,
+                               stan::mcmc::base_mcmc& sampler) {
+    job draw;
+    draw.type = job::diagnostic;
+    sample.get_sample_params(draw.values);
+    sampler.get_sampler_params(draw.values);
+    sampler.get_sampler_diagnostics(draw.values);
+    push(draw);
+  }
+
+  /**
+   * Blocks until all queued draws have been written, then logs the
+   * messages raised while writing them.
+   *
+   * @throw the first exception thrown by the sample or diagnostic
+   *   writer on the writer thread since the last flush
+   */
+  void flush() {
+    int n = 0;
+    while (num_written_.load(std::memory_order_acquire) != num_pushed_)
+      spsc_queue<job>::back_off(n++);
+    log_messages();
+    if (error_) {
+      std::exception_ptr error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  void write_sampler_state(stan::mcmc::base_mcmc& sampler) {
+    flush();
+    mcmc_writer::write_sampler_state(sampler);
+  }
+
+  void write_adapt_finish(stan::mcmc::base_mcmc& sampler) {
+    flush();
+    mcmc_writer::write_adapt_finish(sampler);
+  }
+
+  /**
+   * Writes the performance counters once the queued draws have been
+   * written, so that the write times are complete.
+   *
+   * @param[in] phase "warmup" or "sampling"
+   * @param[in] iteration number of iterations completed
+   * @param[in] sampler sampler
+   */
+  void write_performance(const std::string& phase, int iteration,
+                         stan::mcmc::base_mcmc& sampler) {
+    flush();
+    mcmc_writer::write_performance(phase, iteration, sampler);
+  }
+
+  using mcmc_writer::write_timing;
+
+  void write_timing(double warmDeltaT, double sampleDeltaT) {
+    flush();
+    mcmc_writer::write_timing(warmDeltaT, sampleDeltaT);
+  }
+
+ private:
+  void push(job& draw) {
+#ifdef STAN_THREADS
+    ++num_pushed_;
+    queue_.push(draw);
+#else
+    write(draw);
+#endif
+  }
+
+  void log_messages() {
+    for (const std::string& message : worker_logger_.messages_)
+      logger_.info(message);
+    worker_logger_.messages_.clear();
+  }
+
+  /**
+   * Writes a draw.
+   */
+  void write(job& draw) {
+    if (draw.type == job::sample) {
+      append_model_params(rng_, draw.cont_params, model_, draw.values,
+                          worker_logger_);
+      auto start = start_timer();
+      sample_writer_(draw.values);
+      add_seconds(counters_.writer_seconds, start);
+    } else {
+      auto start = start_timer();
+      diagnostic_writer_(draw.values);
+      add_seconds(counters_.writer_seconds, start);
+    }
+  }
+
+#ifdef STAN_THREADS
+  /**
+   * Writer thread loop. After a writer throws, the remaining draws
+   * are discarded until the calling thread has seen the exception.
+   */
+  void run() {
+    stan::math::ChainableStack thread_stack;
+    job draw;
+    while (true) {
+      queue_.pop(draw);
+      if (draw.type == job::stop)
+        return;
+      if (!error_) {
+        try {
+          write(draw);
+        } catch (...) {
+          error_ = std::current_exception();
+        }
+      }
+      num_written_.fetch_add(1, std::memory_order_release);
+    }
+  }
+#endif
+
+  Model& model_;
+  RNG& rng_;
+  buffer_logger worker_logger_;
+  spsc_queue<job> queue_;
+  size_t num_pushed_;
+  std::atomic<size_t> num_written_;
+  std::exception_ptr error_;
+#ifdef STAN_THREADS
+  std::thread worker_;
+#endif
+};
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
@@ -0,0 +1,302 @@
+#ifndef STAN_SERVICES_UTIL_CHECKPOINTER_HPP
+#define STAN_SERVICES_UTIL_CHECKPOINTER_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <stan/mcmc/base_adapter.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/checkpoint.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <stan/services/util/mcmc_writer.hpp>
+#include <chrono>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace stan {
+namespace services {
+namespace util {
+
+namespace internal {
+
+template <class Sampler>
+inline void write_adaptation_checkpoint(std::ostream& o, Sampler& sampler,
+                                        std::true_type) {
+  sampler.write_adaptation_checkpoint(o);
+}
+
+template <class Sampler>
+inline void write_adaptation_checkpoint(std::ostream& o, Sampler& sampler,
+                                        std::false_type) {}
+
+template <class Sampler>
+inline void read_adaptation_checkpoint(std::istream& i, Sampler& sampler,
+                                       std::true_type) {
+  sampler.read_adaptation_checkpoint(i);
+}
+
+template <class Sampler>
+inline void read_adaptation_checkpoint(std::istream& i, Sampler& sampler,
+                                       std::false_type) {}
+
+}  // namespace internal
+
+/**
+ * <code>checkpointer</code> periodically snapshots the state of a
+ * running chain so that it can be continued after the process is
+ * stopped.
+ *
+ * A checkpoint holds the iteration number, whether the chain is in
+ * warmup, the number of draws written to the sample and diagnostic
+ * writers, the state of the random number generator, the current
+ * sample, the sampler state (step size, metric, current point) and,
+ * for adaptive samplers, the adaptation state. Continuing from a
+ * checkpoint reproduces the draws of the uninterrupted run exactly.
+ *
+ * Each checkpoint is written as a single string to the checkpoint
+ * writer and supersedes all previous ones. The number of draws counts
+ * draw rows only, not the header or the comment lines written at the
+ * end of adaptation. To resume, the interface copies its sample and
+ * diagnostic output up to the number of draws recorded in the
+ * checkpoint with <code>restore_output</code> and constructs the
+ * <code>checkpointer</code> with the last checkpoint as input. Times
+ * reported at the end of a resumed run cover only the resumed part.
+ */
+class checkpointer {
+ public:
+  /**
+   * Construct a checkpointer that starts a new run.
+   *
+   * @param[in,out] writer writer receiving checkpoints
+   * @param[in] num_iterations write a checkpoint every
+   *   <code>num_iterations</code> iterations; disabled if not positive
+   * @param[in] num_seconds write a checkpoint when at least
+   *   <code>num_seconds</code> seconds have passed since the last one;
+   *   disabled if not positive
+   */
+  checkpointer(callbacks::writer& writer, int num_iterations,
+               double num_seconds)
+      : writer_(writer),
+        num_iterations_(num_iterations),
+        num_seconds_(num_seconds),
+        resume_(nullptr),
+        last_(std::chrono::steady_clock::now()) {}
+
+  /**
+   * Construct a checkpointer that resumes a run from a checkpoint.
+   *
+   * @param[in,out] writer writer receiving checkpoints
+   * @param[in] num_iterations write a checkpoint every
+   *   <code>num_iterations</code> iterations; disabled if not positive
+   * @param[in] num_seconds write a checkpoint when at least
+   *   <code>num_seconds</code> seconds have passed since the last one;
+   *   disabled if not positive
+   * @param[in,out] resume stream holding the checkpoint to resume from
+   */
+  checkpointer(callbacks::writer& writer, int num_iterations,
+               double num_seconds, std::istream& resume)
+      : writer_(writer),
+        num_iterations_(num_iterations),
+        num_seconds_(num_seconds),
+        resume_(&resume),
+        last_(std::chrono::steady_clock::now()) {}
+
+  /**
+   * Return true if the run continues from a checkpoint.
+   *
+   * @return true if resuming
+   */
+  bool resuming() const { return resume_ != nullptr; }
+
+  /**
+   * Writes a checkpoint if one is due after the given iteration.
+   *
+   * The mcmc writer is flushed first so that the number of draws
+   * in the checkpoint matches the output.
+   *
+   * @tparam Sampler type of sampler
+   * @tparam RNG type of random number generator
+   * @tparam MCMCWriter type of mcmc writer
+   * @param[in] iteration number of iterations completed
+   * @param[in] warmup true if the iteration is a warmup iteration
+   * @param[in] sampler sampler
+   * @param[in] rng random number generator
+   * @param[in] s current sample
+   * @param[in,out] mcmc_writer writer holding the number of draws
+   *   written
+   */
+  template <class Sampler, class RNG, class MCMCWriter>
+  void operator()(int iteration, bool warmup, Sampler& sampler, RNG& rng,
+                  const stan::mcmc::sample& s, MCMCWriter& mcmc_writer) {
+    bool due = num_iterations_ > 0 && iteration % num_iterations_ == 0;
+    if (!due && num_seconds_ > 0) {
+      std::chrono::duration<double> elapsed
+          = std::chrono::steady_clock::now() - last_;
+      due = elapsed.count() >= num_seconds_;
+    }
+    if (!due)
+      return;
+
+    mcmc_writer.flush();
+    std::stringstream checkpoint;
+    write(checkpoint, iteration, warmup, sampler, rng, s, mcmc_writer);
+    writer_(checkpoint.str());
+    last_ = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * Writes a checkpoint to the stream.
+   *
+   * @tparam Sampler type of sampler
+   * @tparam RNG type of random number generator
+   * @param[in,out] o checkpoint stream
+   * @param[in] iteration number of iterations completed
+   * @param[in] warmup true if the iteration is a warmup iteration
+   * @param[in] sampler sampler
+   * @param[in] rng random number generator
+   * @param[in] s current sample
+   * @param[in] mcmc_writer writer holding the number of draws written
+   */
+  template <class Sampler, class RNG>
+  static void write(std::ostream& o, int iteration, bool warmup,
+                    Sampler& sampler, RNG& rng, const stan::mcmc::sample& s,
+                    const util::mcmc_writer& mcmc_writer) {
+    o.precision(std::numeric_limits<double>::max_digits10);
+    o << "stan_checkpoint " << version() << ' ' << iteration << ' ' << warmup
+      << ' ' << mcmc_writer.num_draws_ << ' ' << rng << ' ';
+    stan::mcmc::write_checkpoint_values(o, s.cont_params());
+    stan::mcmc::write_checkpoint_value(o, s.log_prob());
+    stan::mcmc::write_checkpoint_value(o, s.accept_stat());
+    sampler.write_checkpoint(o);
+    internal::write_adaptation_checkpoint(
+        o, sampler, std::is_base_of<stan::mcmc::base_adapter, Sampler>());
+  }
+
+  /**
+   * Restores the state held by the checkpoint this object was
+   * constructed with.
+   *
+   * @tparam Sampler type of sampler
+   * @tparam RNG type of random number generator
+   * @param[in,out] sampler sampler
+   * @param[in,out] rng random number generator
+   * @param[in,out] s current sample
+   * @param[in,out] mcmc_writer writer whose draw count is restored
+   * @param[out] warmup true if the checkpoint was written in warmup
+   * @return number of iterations completed before the checkpoint
+   * @throw std::invalid_argument if the checkpoint is malformed
+   */
+  template <class Sampler, class RNG>
+  int read(Sampler& sampler, RNG& rng, stan::mcmc::sample& s,
+           util::mcmc_writer& mcmc_writer, bool& warmup) {
+    std::string magic;
+    int file_version = 0;
+    int iteration = 0;
+    *resume_ >> magic >> file_version;
+    if (magic != "stan_checkpoint" || file_version != version())
+      throw std::invalid_argument("Unrecognized checkpoint format.");
+    stan::mcmc::read_checkpoint_integer(*resume_, iteration);
+    stan::mcmc::read_checkpoint_integer(*resume_, warmup);
+    stan::mcmc::read_checkpoint_integer(*resume_, mcmc_writer.num_draws_);
+    if (!(*resume_ >> rng))
+      throw std::invalid_argument(
+          "Malformed checkpoint: could not read the random number "
+          "generator state.");
+    Eigen::VectorXd cont_params = s.cont_params();
+    double log_prob = 0;
+    double accept_stat = 0;
+    stan::mcmc::read_checkpoint_values(*resume_, cont_params);
+    stan::mcmc::read_checkpoint_value(*resume_, log_prob);
+    stan::mcmc::read_checkpoint_value(*resume_, accept_stat);
+    s = stan::mcmc::sample(std::move(cont_params), log_prob, accept_stat);
+    sampler.read_checkpoint(*resume_);
+    internal::read_adaptation_checkpoint(
+        *resume_, sampler,
+        std::is_base_of<stan::mcmc::base_adapter, Sampler>());
+    if (!*resume_)
+      throw std::invalid_argument("Malformed checkpoint: truncated input.");
+    return iteration;
+  }
+
+  /**
+   * Return the number of draws recorded in a checkpoint, which is the
+   * number of draw rows of the sample and diagnostic output to keep
+   * when resuming from it.
+   *
+   * @param[in] checkpoint checkpoint written by this class
+   * @return number of draws written before the checkpoint
+   * @throw std::invalid_argument if the checkpoint is malformed
+   */
+  static size_t num_draws(const std::string& checkpoint) {
+    std::stringstream in(checkpoint);
+    std::string magic;
+    int file_version = 0;
+    int iteration = 0;
+    bool warmup = false;
+    size_t draws = 0;
+    in >> magic >> file_version;
+    if (magic != "stan_checkpoint" || file_version != version())
+      throw std::invalid_argument("Unrecognized checkpoint format.");
+    stan::mcmc::read_checkpoint_integer(in, iteration);
+    stan::mcmc::read_checkpoint_integer(in, warmup);
+    stan::mcmc::read_checkpoint_integer(in, draws);
+    return draws;
+  }
+
+  /**
+   * Copies the output of a stopped run that precedes a checkpoint:
+   * the header and the first <code>num_draws</code> draw rows, with
+   * the comment lines between them, such as the step size and metric
+   * written at the end of adaptation. A line is a comment if it starts
+   * with <code>comment_prefix</code>; the first line that is not a
+   * comment is the header. Everything after the last draw row kept is
+   * dropped, so output written after the checkpoint is not repeated.
+   *
+   * @param[in,out] in output of the stopped run
+   * @param[in,out] out output continued by the resumed run
+   * @param[in] num_draws number of draws recorded in the checkpoint
+   * @param[in] comment_prefix prefix of comment lines
+   * @return number of draw rows copied, which is less than
+   *   <code>num_draws</code> if the output was truncated
+   */
+  static size_t restore_output(std::istream& in, std::ostream& out,
+                               size_t num_draws,
+                               const std::string& comment_prefix = "#") {
+    std::string line;
+    bool header = false;
+    size_t draws = 0;
+    while (!(header && draws == num_draws) && std::getline(in, line)) {
+      bool comment = !comment_prefix.empty()
+                     && line.compare(0, comment_prefix.size(), comment_prefix)
+                            == 0;
+      if (!comment) {
+        if (header)
+          ++draws;
+        header = true;
+      }
+      out << line << '\n';
+    }
+    return draws;
+  }
+
+  /**
+   * Return the version of the checkpoint format.
+   *
+   * @return checkpoint format version
+   */
+  static int version() { return 1; }
+
+ private:
+  callbacks::writer& writer_;
+  int num_iterations_;
+  double num_seconds_;
+  std::istream* resume_;
+  std::chrono::steady_clock::time_point last_;
+};
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
@@ -4,13 +4,136 @@
 #include <stan/callbacks/writer.hpp>
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
+#include <stan/services/util/checkpointer.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
+#include <stan/services/util/progress_reporter.hpp>
+#include <chrono>
 #include <string>
 
 namespace stan {
 namespace services {
 namespace util {
 
+/**
+ * Generates MCMC transitions, writing checkpoints through the
+ * checkpointer and progress messages through the progress reporter.
+ *
+ * @tparam Sampler sampler class
+ * @tparam Model model class
+ * @tparam RNG random number generator class
+ * @tparam MCMCWriter mcmc writer class, either <code>mcmc_writer</code>
+ *   or <code>async_mcmc_writer</code>
+ * @param[in,out] sampler MCMC sampler used to generate transitions
+ * @param[in] num_iterations number of MCMC transitions
+ * @param[in] start starting iteration number used for printing messages
+ * @param[in] finish end iteration number used for printing messages
+ * @param[in] num_thin when save is true, a draw will be written to the
+ *   mcmc_writer every num_thin iterations
+ * @param[in] save if save is true, the transitions will be written
+ *   to the mcmc_writer. If false, transitions will not be written
+ * @param[in] warmup indicates whether these transitions are warmup. Used
+ *   for printing iteration number messages
+ * @param[in,out] mcmc_writer writer to handle mcmc output; also
+ *   accumulates the time spent in transitions and, if it has a
+ *   performance writer set to report at refresh, writes the
+ *   performance counters with every progress message
+ * @param[in,out] init_s starts as the initial unconstrained parameter
+ *   values. When the function completes, this will have the final
+ *   iteration's unconstrained parameter values
+ * @param[in] model model
+ * @param[in,out] base_rng random number generator
+ * @param[in,out] callback interrupt callback called once an iteration
+ * @param[in,out] checkpointer checkpointer called once an iteration
+ * @param[in,out] progress progress reporter
+ * @param[in] first number of the <code>num_iterations</code>
+ *   transitions already generated before resuming from a checkpoint
+ */
+template <class Sampler, class Model, class RNG, class MCMCWriter>
+void generate_transitions(Sampler& sampler, int num_iterations, int start,
+                          int finish, int num_thin, bool save, bool warmup,
+                          MCMCWriter& mcmc_writer, stan::mcmc::sample& init_s,
+                          Model& model, RNG& base_rng,
+                          callbacks::interrupt& callback,
+                          callbacks::logger& logger,
+                          util::checkpointer& checkpointer,
+                          util::progress_reporter& progress, int first) {
+  progress.begin(start, finish, first);
+  const bool timing = mcmc_writer.performance_timing();
+  sampler.set_performance_timing(timing);
+  for (int m = first; m < num_iterations; ++m) {
+    callback();
+
+    if (progress.due(m + 1) && progress(m + 1, warmup, sampler)
+        && mcmc_writer.performance_at_refresh())
+      mcmc_writer.write_performance(warmup ? "warmup" : "sampling",
+                                    start + m, sampler);
+
+    if (timing) {
+      auto start_transition = std::chrono::steady_clock::now();
+      init_s = sampler.transition(init_s, logger);
+      std::chrono::duration<double> transition_time
+          = std::chrono::steady_clock::now() - start_transition;
+      mcmc_writer.add_transition_time(transition_time.count());
+    } else {
+      init_s = sampler.transition(init_s, logger);
+    }
+
+    if (save && ((m % num_thin) == 0)) {
+      mcmc_writer.write_sample_params(base_rng, init_s, sampler, model);
+      mcmc_writer.write_diagnostic_params(init_s, sampler);
+    }
+
+    checkpointer(start + m + 1, warmup, sampler, base_rng, init_s, mcmc_writer);
+  }
+}
+
+/**
+ * Generates MCMC transitions, writing checkpoints through the
+ * checkpointer.
+ *
+ * @tparam Sampler sampler class
+ * @tparam Model model class
+ * @tparam RNG random number generator class
+ * @tparam MCMCWriter mcmc writer class, either <code>mcmc_writer</code>
+ *   or <code>async_mcmc_writer</code>
+ * @param[in,out] sampler MCMC sampler used to generate transitions
+ * @param[in] num_iterations number of MCMC transitions
+ * @param[in] start starting iteration number used for printing messages
+ * @param[in] finish end iteration number used for printing messages
+ * @param[in] num_thin when save is true, a draw will be written to the
+ *   mcmc_writer every num_thin iterations
+ * @param[in] refresh number of iterations to print a message. If
+ *   refresh is zero, iteration number messages will not be printed
+ * @param[in] save if save is true, the transitions will be written
+ *   to the mcmc_writer. If false, transitions will not be written
+ * @param[in] warmup indicates whether these transitions are warmup. Used
+ *   for printing iteration number messages
+ * @param[in,out] mcmc_writer writer to handle mcmc output
+ * @param[in,out] init_s starts as the initial unconstrained parameter
+ *   values. When the function completes, this will have the final
+ *   iteration's unconstrained parameter values
+ * @param[in] model model
+ * @param[in,out] base_rng random number generator
+ * @param[in,out] callback interrupt callback called once an iteration
+ * @param[in,out] logger logger for messages
+ * @param[in,out] checkpointer checkpointer called once an iteration
+ * @param[in] first number of the <code>num_iterations</code>
+ *   transitions already generated before resuming from a checkpoint
+ */
+template <class Sampler, class Model, class RNG, class MCMCWriter>
+void generate_transitions(Sampler& sampler, int num_iterations, int start,
+                          int finish, int num_thin, int refresh, bool save,
+                          bool warmup, MCMCWriter& mcmc_writer,
+                          stan::mcmc::sample& init_s, Model& model,
+                          RNG& base_rng, callbacks::interrupt& callback,
+                          callbacks::logger& logger,
+                          util::checkpointer& checkpointer, int first = 0) {
+  util::progress_reporter progress(logger, refresh);
+  generate_transitions(sampler, num_iterations, start, finish, num_thin, save,
+                       warmup, mcmc_writer, init_s, model, base_rng, callback,
+                       logger, checkpointer, progress, first);
+}
+
 /**
  * Generates MCMC transitions.
  *
@@ -45,29 +168,11 @@ void generate_transitions(stan::mcmc::base_mcmc& sampler, int num_iterations,
                           stan::mcmc::sample& init_s, Model& model,
                           RNG& base_rng, callbacks::interrupt& callback,
                           callbacks::logger& logger) {
-  for (int m = 0; m < num_iterations; ++m) {
-    callback();
-
-    if (refresh > 0
-        && (start + m + 1 == finish || m == 0 || (m + 1) % refresh == 0)) {
-      int it_print_width = std::ceil(std::log10(static_cast<double>(finish)));
-      std::stringstream message;
-      message << "Iteration: ";
-      message << std::setw(it_print_width) << m + 1 + start << " / " << finish;
-      message << " [" << std::setw(3)
-              << static_cast<int>((100.0 * (start + m + 1)) / finish) << "%] ";
-      message << (warmup ? " (Warmup)" : " (Sampling)");
-
-      logger.info(message);
-    }
-
-    init_s = sampler.transition(init_s, logger);
-
-    if (save && ((m % num_thin) == 0)) {
-      mcmc_writer.write_sample_params(base_rng, init_s, sampler, model);
-      mcmc_writer.write_diagnostic_params(init_s, sampler);
-    }
-  }
+  callbacks::writer checkpoint_writer;
+  util::checkpointer checkpointer(checkpoint_writer, 0, 0);
+  generate_transitions(sampler, num_iterations, start, finish, num_thin,
+                       refresh, save, warmup, mcmc_writer, init_s, model,
+                       base_rng, callback, logger, checkpointer);
 }
 
 }  // namespace util
@@ -90,6 +90,51 @@ class gq_writer {
                                   values.end());
     sample_writer_(gq_values);
   }
+
+  /**
+   * Calls model's `write_array` method and stores the values of the
+   * variables defined in the generated quantities block, without
+   * writing them. Messages from the model are stored in `msgs`
+   * instead of being logged, so this method may be called
+   * concurrently from several threads.
+   *
+   * @tparam M model class
+   * @tparam RNG pseudo random number generator class
+   * @param[in] model instantiated model
+   * @param[in] rng instantiated RNG
+   * @param[in] draw sequence unconstrained parameters values.
+   * @param[out] gq_values values of the generated quantities
+   * @param[out] msgs messages from the model, followed by the error
+   *   message if `write_array` threw
+   * @return false if `write_array` threw
+   */
+  template <class Model, class RNG>
+  bool compute_gq_values(const Model& model, RNG& rng,
+                         const std::vector<double>& draw,
+                         std::vector<double>& gq_values,
+                         std::stringstream& msgs) const {
+    std::vector<double> values;
+    std::vector<int> params_i;  // unused - no discrete params
+    try {
+      model.write_array(rng, const_cast<std::vector<double>&>(draw), params_i,
+                        values, false, true, &msgs);
+    } catch (const std::exception& e) {
+      msgs << e.what();
+      return false;
+    }
+    gq_values.assign(values.begin() + num_constrained_params_, values.end());
+    return true;
+  }
+
+  /**
+   * Write values of variables defined in the generated quantities
+   * block computed by `compute_gq_values` to stream `sample_writer_`.
+   *
+   * @param[in] gq_values values of the generated quantities
+   */
+  void write_gq_values(const std::vector<double>& gq_values) {
+    sample_writer_(gq_values);
+  }
 };
 
 }  // namespace util
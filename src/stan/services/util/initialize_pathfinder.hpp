@@ -0,0 +1,450 @@
+#ifndef STAN_SERVICES_UTIL_INITIALIZE_PATHFINDER_HPP
+#define STAN_SERVICES_UTIL_INITIALIZE_PATHFINDER_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/math/prim.hpp>
+#include <stan/model/log_prob_batch.hpp>
+#include <stan/optimization/bfgs.hpp>
+#include <stan/optimization/lbfgs_update.hpp>
+#include <stan/services/util/initialize.hpp>
+#include <boost/math/constants/constants.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+namespace internal {
+
+/**
+ * Result of a single Pathfinder path: the best Gaussian
+ * approximation found along the L-BFGS path and draws from it with
+ * their log importance ratios.
+ */
+struct pathfinder_path {
+  /** Mean of the approximation. */
+  Eigen::VectorXd mean;
+  /** Variances of the (diagonal) approximation. */
+  Eigen::VectorXd variance;
+  /** Estimated ELBO of the approximation. */
+  double elbo = -std::numeric_limits<double>::infinity();
+  /** Number of L-BFGS iterations. */
+  int num_iterations = 0;
+  /** Draws from the approximation. */
+  std::vector<Eigen::VectorXd> draws;
+  /** Log density of the model minus log density of the approximation. */
+  std::vector<double> log_weights;
+  /** Model messages. */
+  std::stringstream messages;
+  /** Error other than a <code>std::domain_error</code>, if any. */
+  std::exception_ptr error;
+};
+
+/**
+ * Updates a diagonal estimate of the inverse Hessian with the
+ * diagonal of the BFGS update for the step <code>s</code> and
+ * gradient change <code>y</code>. The result stays positive when
+ * <code>s' y</code> is positive.
+ *
+ * @param[in,out] d diagonal of the inverse Hessian estimate
+ * @param[in] s change in position
+ * @param[in] y change in gradient of the negative log density
+ */
+inline void pathfinder_update_diagonal(Eigen::VectorXd& d,
+                                       const Eigen::VectorXd& s,
+                                       const Eigen::VectorXd& y) {
+  double rho = 1.0 / s.dot(y);
+  double y_d_y = y.dot(d.cwiseProduct(y));
+  d.array() += -2 * rho * s.array() * y.array() * d.array()
+               + (rho * rho * y_d_y + rho) * s.array().square();
+}
+
+/**
+ * Draws from a Gaussian with diagonal covariance.
+ *
+ * @tparam RNG random number generator class
+ * @param[in] mean mean
+ * @param[in] variance variances
+ * @param[in,out] rng random number generator
+ * @param[out] draw draw
+ * @return log density of the draw
+ */
+template <class RNG>
+double pathfinder_draw(const Eigen::VectorXd& mean,
+                       const Eigen::VectorXd& variance, RNG& rng,
+                       Eigen::VectorXd& draw) {
+  static const double log_two_pi
+      = std::log(2 * boost::math::constants::pi<double>());
+  boost::variate_generator<RNG&, boost::normal_distribution<> > rand_gaus(
+      rng, boost::normal_distribution<>());
+  draw.resize(mean.size());
+  double log_q = 0;
+  for (int i = 0; i < mean.size(); ++i) {
+    double z = rand_gaus();
+    draw(i) = mean(i) + std::sqrt(variance(i)) * z;
+    log_q -= 0.5 * (z * z + log_two_pi + std::log(variance(i)));
+  }
+  return log_q;
+}
+
+/**
+ * Return the log density of the model, or negative infinity if it
+ * can not be evaluated.
+ *
+ * @tparam Jacobian true to include the Jacobian term
+ * @tparam Model model class
+ * @param[in] model model
+ * @param[in] x unconstrained parameters
+ * @param[in,out] messages stream for model messages
+ * @return log density
+ */
+template <bool Jacobian, class Model>
+double pathfinder_log_density(const Model& model, const Eigen::VectorXd& x,
+                              std::ostream& messages) {
+  std::vector<double> params_r(x.data(), x.data() + x.size());
+  std::vector<int> params_i;
+  double log_prob = -std::numeric_limits<double>::infinity();
+  try {
+    log_prob
+        = model.template log_prob<false, Jacobian>(params_r, params_i,
+                                                   &messages);
+  } catch (const std::domain_error& e) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  return std::isnan(log_prob) ? -std::numeric_limits<double>::infinity()
+                              : log_prob;
+}
+
+/**
+ * Runs one Pathfinder path: L-BFGS from the initial point, a
+ * diagonal Gaussian approximation at every iterate (centered at the
+ * Newton step from the iterate), the approximation with the highest
+ * estimated ELBO and draws from it.
+ *
+ * @tparam Jacobian true to include the Jacobian term
+ * @tparam Model model class
+ * @tparam RNG random number generator class
+ * @param[in] model model
+ * @param[in] init initial unconstrained parameters
+ * @param[in,out] rng random number generator used only by this path
+ * @param[in] max_iterations maximum number of L-BFGS iterations
+ * @param[in] history_size number of updates kept by L-BFGS
+ * @param[in] num_elbo_draws number of draws used to estimate the ELBO
+ * @param[in] num_draws number of draws from the best approximation
+ * @param[out] path result
+ */
+template <bool Jacobian, class Model, class RNG>
+void run_pathfinder_path(Model& model, const std::vector<double>& init,
+                         RNG& rng, int max_iterations, int history_size,
+                         int num_elbo_draws, int num_draws,
+                         pathfinder_path& path) {
+  typedef stan::optimization::ModelAdaptor<Model, Jacobian> adaptor_t;
+  std::vector<int> params_i;
+  adaptor_t adaptor(model, params_i, &path.messages);
+  stan::optimization::BFGSMinimizer<adaptor_t,
+                                    stan::optimization::LBFGSUpdate<> >
+      lbfgs(adaptor);
+  lbfgs.get_qnupdate().set_history_size(history_size);
+  lbfgs._conv_opts.maxIts = max_iterations;
+
+  Eigen::VectorXd x = Eigen::Map<const Eigen::VectorXd>(init.data(),
+                                                        init.size());
+  lbfgs.initialize(x);
+  Eigen::VectorXd x_prev = lbfgs.curr_x();
+  Eigen::VectorXd g_prev = lbfgs.curr_g();
+  Eigen::VectorXd d;
+  Eigen::VectorXd draw;
+
+  int ret = stan::optimization::TERM_SUCCESS;
+  while (ret == stan::optimization::TERM_SUCCESS) {
+    ret = lbfgs.step();
+    if (ret < 0)
+      break;
+    Eigen::VectorXd s = lbfgs.curr_x() - x_prev;
+    Eigen::VectorXd y = lbfgs.curr_g() - g_prev;
+    x_prev = lbfgs.curr_x();
+    g_prev = lbfgs.curr_g();
+
+    // skip steps that do not satisfy the curvature condition
+    double s_y = s.dot(y);
+    if (!(s_y > 1e-12 * y.squaredNorm()))
+      continue;
+    if (d.size() == 0)
+      d = Eigen::VectorXd::Constant(s.size(), s_y / y.squaredNorm());
+    pathfinder_update_diagonal(d, s, y);
+
+    // curr_g() is the gradient of the negative log density
+    Eigen::VectorXd mean = x_prev - d.cwiseProduct(g_prev);
+    double elbo = 0;
+    for (int n = 0; n < num_elbo_draws; ++n) {
+      double log_q = pathfinder_draw(mean, d, rng, draw);
+      elbo += pathfinder_log_density<Jacobian>(model, draw, path.messages)
+              - log_q;
+    }
+    elbo /= num_elbo_draws;
+    if (elbo > path.elbo) {
+      path.elbo = elbo;
+      path.mean = mean;
+      path.variance = d;
+    }
+  }
+  path.num_iterations = lbfgs.iter_num();
+
+  if (path.mean.size() == 0)
+    return;
+  for (int n = 0; n < num_draws; ++n) {
+    double log_q = pathfinder_draw(path.mean, path.variance, rng, draw);
+    double log_p
+        = pathfinder_log_density<Jacobian>(model, draw, path.messages);
+    if (std::isfinite(log_p)) {
+      path.draws.push_back(draw);
+      path.log_weights.push_back(log_p - log_q);
+    }
+  }
+}
+
+/**
+ * Runs a path, catching its errors so that they can be rethrown on
+ * the calling thread.
+ */
+template <bool Jacobian, class Model, class RNG>
+void run_pathfinder_path_safely(Model& model, const std::vector<double>& init,
+                                RNG& rng, int max_iterations,
+                                int history_size, int num_elbo_draws,
+                                int num_draws, pathfinder_path& path) {
+  try {
+    run_pathfinder_path<Jacobian>(model, init, rng, max_iterations,
+                                  history_size, num_elbo_draws, num_draws,
+                                  path);
+  } catch (const std::domain_error& e) {
+    path.messages << e.what() << std::endl;
+  } catch (...) {
+    path.error = std::current_exception();
+  }
+}
+
+}  // namespace internal
+
+/**
+ * Returns initial values of the parameters of the model on the
+ * unconstrained scale found by multi-path Pathfinder, and sets an
+ * initial diagonal inverse metric.
+ *
+ * Each path starts from a point generated by <code>initialize</code>
+ * (so the values in <code>init</code> are used and missing ones are
+ * drawn uniformly from (-init_radius, init_radius)) and runs L-BFGS
+ * towards the mode of the log density on the unconstrained scale. At
+ * every iterate, the L-BFGS updates give a diagonal estimate of the
+ * inverse Hessian and a Gaussian approximation centered at the Newton
+ * step; the approximation with the highest estimated ELBO is kept.
+ * The draws from the kept approximations of all paths are weighted
+ * by their importance ratios, the initial value is drawn from them by
+ * importance resampling and the inverse metric is the regularized
+ * importance weighted variance of the draws.
+ *
+ * When compiled with <code>STAN_THREADS</code> the paths run on up
+ * to <code>num_threads</code> threads. Each path uses its own random
+ * number generator derived from <code>rng</code>, so the result does
+ * not depend on the number of threads.
+ *
+ * If no path finds an approximation, if the model has no parameters
+ * or if <code>num_paths</code> is not positive, this falls back to
+ * <code>initialize</code> and leaves the inverse metric unchanged.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator
+ *
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in,out] rng random number generator
+ * @param[in] init_radius the radius for generating random starting
+ *   points
+ * @param[in] num_paths number of paths
+ * @param[in] max_iterations maximum number of L-BFGS iterations per path
+ * @param[in] num_elbo_draws number of draws used to estimate the ELBO
+ *   of each approximation
+ * @param[in] num_draws number of draws per path used for importance
+ *   resampling
+ * @param[in] num_threads maximum number of threads running paths
+ * @param[in] print_timing indicates whether a timing message should
+ *   be printed to the logger
+ * @param[in,out] logger logger for messages
+ * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @param[in,out] inv_metric set to the estimated diagonal inverse
+ *   metric; unchanged if no path finds an approximation
+ * @throws exception passed through from the model if the model has a
+ *   fatal error (not a std::domain_error)
+ * @throws std::domain_error if the model can not be initialized
+ * @return valid unconstrained parameters for the model
+ */
+template <bool Jacobian = true, class Model, class RNG>
+std::vector<double> initialize_pathfinder(
+    Model& model, const stan::io::var_context& init, RNG& rng,
+    double init_radius, int num_paths, int max_iterations, int num_elbo_draws,
+    int num_draws, int num_threads, bool print_timing,
+    stan::callbacks::logger& logger,
+    stan::callbacks::writer& init_writer, Eigen::VectorXd& inv_metric) {
+  static const int history_size = 6;
+  static const uintmax_t DISCARD_STRIDE = static_cast<uintmax_t>(1) << 40;
+  if (num_paths <= 0 || model.num_params_r() == 0)
+    return initialize<Jacobian>(model, init, rng, init_radius, print_timing,
+                                logger, init_writer);
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<RNG> rngs(num_paths, rng);
+  std::vector<std::vector<double> > inits(num_paths);
+  callbacks::writer no_writer;
+  for (int k = 0; k < num_paths; ++k) {
+    rngs[k].discard(DISCARD_STRIDE * (k + 1));
+    inits[k] = initialize<Jacobian>(model, init, rngs[k], init_radius, false,
+                                    logger, no_writer);
+  }
+
+  std::vector<internal::pathfinder_path> paths(num_paths);
+  stan::model::internal::for_each_row_worker(
+      num_paths, num_threads, 0,
+      [&](size_t worker, size_t num_workers, std::ostream*) {
+        for (size_t k = worker; k < paths.size(); k += num_workers)
+          internal::run_pathfinder_path_safely<Jacobian>(
+              model, inits[k], rngs[k], max_iterations, history_size,
+              num_elbo_draws, num_draws, paths[k]);
+      });
+
+  std::vector<const Eigen::VectorXd*> draws;
+  std::vector<double> log_weights;
+  for (int k = 0; k < num_paths; ++k) {
+    if (paths[k].messages.str().length() > 0)
+      logger.info(paths[k].messages);
+    if (paths[k].error)
+      std::rethrow_exception(paths[k].error);
+    std::stringstream msg;
+    msg << "Pathfinder path " << k + 1 << ": " << paths[k].num_iterations
+        << " L-BFGS iterations, ELBO = " << paths[k].elbo;
+    logger.info(msg);
+    for (size_t n = 0; n < paths[k].draws.size(); ++n) {
+      draws.push_back(&paths[k].draws[n]);
+      log_weights.push_back(paths[k].log_weights[n]);
+    }
+  }
+  if (draws.empty()) {
+    logger.info(
+        "Pathfinder initialization failed to find an approximation;"
+        " using random initialization.");
+    return initialize<Jacobian>(model, init, rng, init_radius, print_timing,
+                                logger, init_writer);
+  }
+
+  double log_sum_weights = stan::math::log_sum_exp(log_weights);
+  std::vector<double> weights(draws.size());
+  double sum_squared_weights = 0;
+  for (size_t n = 0; n < draws.size(); ++n) {
+    weights[n] = std::exp(log_weights[n] - log_sum_weights);
+    sum_squared_weights += weights[n] * weights[n];
+  }
+
+  boost::uniform_01<RNG&> rand_uniform(rng);
+  double u = rand_uniform();
+  size_t selected = draws.size() - 1;
+  for (size_t n = 0; n < draws.size(); ++n) {
+    u -= weights[n];
+    if (u <= 0) {
+      selected = n;
+      break;
+    }
+  }
+
+  Eigen::VectorXd mean = Eigen::VectorXd::Zero(draws[0]->size());
+  for (size_t n = 0; n < draws.size(); ++n)
+    mean += weights[n] * *draws[n];
+  Eigen::VectorXd variance = Eigen::VectorXd::Zero(mean.size());
+  for (size_t n = 0; n < draws.size(); ++n)
+    variance += weights[n] * (*draws[n] - mean).cwiseAbs2();
+  // regularize towards the unit metric as in windowed adaptation
+  double ess = 1.0 / sum_squared_weights;
+  inv_metric = (ess / (ess + 5.0)) * variance
+               + 1e-3 * (5.0 / (ess + 5.0))
+                     * Eigen::VectorXd::Ones(variance.size());
+
+  std::stringstream msg;
+  msg << "Pathfinder initialization: effective sample size " << ess
+      << " of " << draws.size() << " draws";
+  logger.info(msg);
+  if (print_timing) {
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    std::stringstream timing;
+    timing << "Pathfinder initialization took " << elapsed.count()
+           << " seconds";
+    logger.info(timing);
+  }
+
+  std::vector<double> unconstrained(draws[selected]->data(),
+                                    draws[selected]->data()
+                                        + draws[selected]->size());
+  init_writer(unconstrained);
+  return unconstrained;
+}
+
+/**
+ * Returns initial values of the parameters of the model on the
+ * unconstrained scale found by multi-path Pathfinder. See the
+ * overload taking an inverse metric.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator
+ *
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in,out] rng random number generator
+ * @param[in] init_radius the radius for generating random starting
+ *   points
+ * @param[in] num_paths number of paths
+ * @param[in] max_iterations maximum number of L-BFGS iterations per path
+ * @param[in] num_elbo_draws number of draws used to estimate the ELBO
+ *   of each approximation
+ * @param[in] num_draws number of draws per path used for importance
+ *   resampling
+ * @param[in] num_threads maximum number of threads running paths
+ * @param[in] print_timing indicates whether a timing message should
+ *   be printed to the logger
+ * @param[in,out] logger logger for messages
+ * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @throws exception passed through from the model if the model has a
+ *   fatal error (not a std::domain_error)
+ * @throws std::domain_error if the model can not be initialized
+ * @return valid unconstrained parameters for the model
+ */
+template <bool Jacobian = true, class Model, class RNG>
+std::vector<double> initialize_pathfinder(
+    Model& model, const stan::io::var_context& init, RNG& rng,
+    double init_radius, int num_paths, int max_iterations, int num_elbo_draws,
+    int num_draws, int num_threads, bool print_timing,
+    stan::callbacks::logger& logger,
+    stan::callbacks::writer& init_writer) {
+  Eigen::VectorXd inv_metric;
+  return initialize_pathfinder<Jacobian>(
+      model, init, rng, init_radius, num_paths, max_iterations,
+      num_elbo_draws, num_draws, num_threads, print_timing, logger,
+      init_writer, inv_metric);
+}
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
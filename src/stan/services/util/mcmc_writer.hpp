@@ -2,10 +2,13 @@
 #define STAN_SERVICES_UTIL_MCMC_WRITER_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/performance_writer.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/performance_counters.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <stan/model/prob_grad.hpp>
+#include <chrono>
 #include <iomanip>
 #include <limits>
 #include <sstream>
@@ -22,15 +25,47 @@ namespace util {
  * @tparam Model Model class
  */
 class mcmc_writer {
- private:
+ protected:
   callbacks::writer& sample_writer_;
   callbacks::writer& diagnostic_writer_;
   callbacks::logger& logger_;
+  callbacks::performance_writer* performance_writer_;
+  bool performance_at_refresh_;
+  stan::mcmc::performance_counters counters_;
+
+  /**
+   * Return the current time if a performance writer is set, or the
+   * epoch otherwise, so that the clock is read only when the times
+   * are reported.
+   *
+   * @return start time for <code>add_seconds</code>
+   */
+  std::chrono::steady_clock::time_point start_timer() const {
+    return performance_timing() ? std::chrono::steady_clock::now()
+                                : std::chrono::steady_clock::time_point();
+  }
+
+  /**
+   * Adds the seconds elapsed since the start time to the counter if a
+   * performance writer is set.
+   *
+   * @param[in,out] seconds counter
+   * @param[in] start start time from <code>start_timer</code>
+   */
+  void add_seconds(double& seconds,
+                   std::chrono::steady_clock::time_point start) const {
+    if (!performance_timing())
+      return;
+    std::chrono::duration<double> elapsed
+        = std::chrono::steady_clock::now() - start;
+    seconds += elapsed.count();
+  }
 
  public:
   size_t num_sample_params_;
   size_t num_sampler_params_;
   size_t num_model_params_;
+  size_t num_draws_;
   /**
    * Constructor.
    *
@@ -44,9 +79,12 @@ class mcmc_writer {
       : sample_writer_(sample_writer),
         diagnostic_writer_(diagnostic_writer),
         logger_(logger),
+        performance_writer_(nullptr),
+        performance_at_refresh_(false),
         num_sample_params_(0),
         num_sampler_params_(0),
-        num_model_params_(0) {}
+        num_model_params_(0),
+        num_draws_(0) {}
 
   /**
    * Outputs parameter string names. First outputs the names stored in
@@ -65,7 +103,26 @@ class mcmc_writer {
   void write_sample_names(stan::mcmc::sample& sample,
                           stan::mcmc::base_mcmc& sampler, Model& model) {
     std::vector<std::string> names;
+    get_sample_names(sample, sampler, model, names);
+    sample_writer_(names);
+  }
 
+  /**
+   * Collects the parameter names written by
+   * <code>write_sample_names</code> and records the number of sample,
+   * sampler and model parameters without writing anything. Used when
+   * resuming from a checkpoint, where the header has already been
+   * written.
+   *
+   * @param[in] sample a sample (unconstrained) that works with the model
+   * @param[in] sampler a stan::mcmc::base_mcmc object
+   * @param[in] model the model
+   * @param[out] names parameter names
+   */
+  template <class Model>
+  void get_sample_names(stan::mcmc::sample& sample,
+                        stan::mcmc::base_mcmc& sampler, Model& model,
+                        std::vector<std::string>& names) {
     sample.get_sample_param_names(names);
     num_sample_params_ = names.size();
 
@@ -74,8 +131,6 @@ class mcmc_writer {
 
     model.constrained_param_names(names, true, true);
     num_model_params_ = names.size() - num_sample_params_ - num_sampler_params_;
-
-    sample_writer_(names);
   }
 
   /**
@@ -101,31 +156,74 @@ class mcmc_writer {
     sample.get_sample_params(values);
     sampler.get_sampler_params(values);
 
+    std::vector<double> cont_params(
+        sample.cont_params().data(),
+        sample.cont_params().data() + sample.cont_params().size());
+    append_model_params(rng, cont_params, model, values, logger_);
+
+    auto start = start_timer();
+    sample_writer_(values);
+    add_seconds(counters_.writer_seconds, start);
+    ++num_draws_;
+  }
+
+  /**
+   * Blocks until all draws passed to the writer have been written.
+   * Draws are written immediately, so this is a no-op.
+   */
+  void flush() {}
+
+  /**
+   * Writes the sampler state (step size and metric) to the sample
+   * stream.
+   *
+   * @param[in] sampler sampler
+   */
+  void write_sampler_state(stan::mcmc::base_mcmc& sampler) {
+    sampler.write_sampler_state(sample_writer_);
+  }
+
+  /**
+   * Appends the constrained model parameters, transformed parameters
+   * and generated quantities for the unconstrained parameters to the
+   * values. If <code>write_array</code> fails the model values are
+   * filled with NaN.
+   *
+   * @tparam Model model class
+   * @tparam RNG random number generator class
+   * @param[in,out] rng random number generator (used by
+   *   model.write_array())
+   * @param[in] cont_params unconstrained parameters
+   * @param[in] model the model
+   * @param[in,out] values values to append to
+   * @param[in,out] logger logger for model messages and errors
+   */
+  template <class Model, class RNG>
+  void append_model_params(RNG& rng, std::vector<double>& cont_params,
+                           Model& model, std::vector<double>& values,
+                           callbacks::logger& logger) {
     std::vector<double> model_values;
     std::vector<int> params_i;
     std::stringstream ss;
+    auto start = start_timer();
     try {
-      std::vector<double> cont_params(
-          sample.cont_params().data(),
-          sample.cont_params().data() + sample.cont_params().size());
       model.write_array(rng, cont_params, params_i, model_values, true, true,
                         &ss);
     } catch (const std::exception& e) {
       if (ss.str().length() > 0)
-        logger_.info(ss);
+        logger.info(ss);
       ss.str("");
-      logger_.info(e.what());
+      logger.info(e.what());
     }
+    add_seconds(counters_.write_array_seconds, start);
     if (ss.str().length() > 0)
-      logger_.info(ss);
+      logger.info(ss);
 
     if (model_values.size() > 0)
       values.insert(values.end(), model_values.begin(), model_values.end());
     if (model_values.size() < num_model_params_)
       values.insert(values.end(), num_model_params_ - model_values.size(),
                     std::numeric_limits<double>::quiet_NaN());
-
-    sample_writer_(values);
   }
 
   /**
@@ -176,7 +274,85 @@ class mcmc_writer {
     sampler.get_sampler_params(values);
     sampler.get_sampler_diagnostics(values);
 
+    auto start = start_timer();
     diagnostic_writer_(values);
+    add_seconds(counters_.writer_seconds, start);
+  }
+
+  /**
+   * Sets the writer receiving performance counters. Counters are
+   * written at the end of warmup and at the end of sampling and, if
+   * requested, with every progress message.
+   *
+   * @param[in,out] writer performance writer
+   * @param[in] at_refresh if true, counters are also written with
+   *   every progress message
+   */
+  void set_performance_writer(callbacks::performance_writer& writer,
+                              bool at_refresh) {
+    performance_writer_ = &writer;
+    performance_at_refresh_ = at_refresh;
+  }
+
+  /**
+   * Return true if a performance writer is set, in which case the
+   * sampler, transitions and writes are timed.
+   *
+   * @return true if timing is on
+   */
+  bool performance_timing() const { return performance_writer_ != nullptr; }
+
+  /**
+   * Return true if performance counters are written with every
+   * progress message.
+   *
+   * @return true if counters are written at refresh
+   */
+  bool performance_at_refresh() const {
+    return performance_writer_ != nullptr && performance_at_refresh_;
+  }
+
+  /**
+   * Adds time spent generating transitions.
+   *
+   * @param[in] seconds seconds spent in transitions
+   */
+  void add_transition_time(double seconds) {
+    counters_.transition_seconds += seconds;
+  }
+
+  /**
+   * Return the performance counters of the run so far, combining the
+   * counters of the sampler with those of the writer.
+   *
+   * @param[in] sampler sampler
+   * @return performance counters
+   */
+  stan::mcmc::performance_counters get_performance_counters(
+      stan::mcmc::base_mcmc& sampler) {
+    stan::mcmc::performance_counters counters = counters_;
+    counters.num_draws = num_draws_;
+    sampler.get_performance_counters(counters);
+    return counters;
+  }
+
+  /**
+   * Writes the performance counters to the performance writer, if
+   * one has been set.
+   *
+   * @param[in] phase "warmup" or "sampling"
+   * @param[in] iteration number of iterations completed
+   * @param[in] sampler sampler
+   */
+  void write_performance(const std::string& phase, int iteration,
+                         stan::mcmc::base_mcmc& sampler) {
+    if (performance_writer_ == nullptr)
+      return;
+    std::vector<std::string> names;
+    std::vector<double> values;
+    stan::mcmc::performance_counters::get_names(names);
+    get_performance_counters(sampler).get_values(values);
+    (*performance_writer_)(phase, iteration, names, values);
   }
 
   /**
@@ -0,0 +1,194 @@
+#ifndef STAN_SERVICES_UTIL_PROGRESS_REPORTER_HPP
+#define STAN_SERVICES_UTIL_PROGRESS_REPORTER_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/performance_counters.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * <code>progress_reporter</code> logs the iteration messages of a
+ * sampler run.
+ *
+ * Messages are logged at the first iteration of each phase, at the
+ * last iteration of the run and every <code>refresh</code> iterations
+ * and/or every <code>refresh_seconds</code> seconds of wall-clock
+ * time. The last iteration of warmup is only logged if it falls on
+ * one of those, as the sampling phase follows it. After the
+ * first message of a phase, each message also gives the iterations
+ * and gradient evaluations per second over the phase so far and the
+ * estimated time to the end of the run.
+ *
+ * The loop only compares the iteration number against the next
+ * iteration at which the reporter needs to run, so iterations without
+ * a message do not read the clock or format anything. For reporting
+ * by time, the reporter estimates how many iterations fit in a tenth
+ * of the interval and reads the clock only that often.
+ */
+class progress_reporter {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param[in,out] logger logger for messages
+   * @param[in] refresh log a message every <code>refresh</code>
+   *   iterations; disabled if not positive
+   * @param[in] refresh_seconds log a message when at least
+   *   <code>refresh_seconds</code> seconds have passed since the last
+   *   one; disabled if not positive
+   */
+  progress_reporter(callbacks::logger& logger, int refresh,
+                    double refresh_seconds = 0)
+      : logger_(logger),
+        refresh_(refresh),
+        refresh_seconds_(refresh_seconds),
+        start_(0),
+        finish_(0),
+        width_(0),
+        next_(std::numeric_limits<int>::max()),
+        stride_(1),
+        phase_m_(0),
+        phase_gradient_evals_(0),
+        last_m_(0) {}
+
+  /**
+   * Return true if the reporter logs any messages.
+   *
+   * @return true if enabled
+   */
+  bool enabled() const { return refresh_ > 0 || refresh_seconds_ > 0; }
+
+  /**
+   * Starts a phase (warmup or sampling).
+   *
+   * @param[in] start number of iterations before the phase
+   * @param[in] finish total number of iterations of the run
+   * @param[in] first number of iterations of the phase already
+   *   completed before resuming from a checkpoint
+   */
+  void begin(int start, int finish, int first) {
+    start_ = start;
+    finish_ = finish;
+    width_ = std::ceil(std::log10(static_cast<double>(finish)));
+    next_ = enabled() ? first + 1 : std::numeric_limits<int>::max();
+    stride_ = 1;
+    phase_m_ = first;
+    last_m_ = first;
+    phase_gradient_evals_ = -1;
+    phase_start_ = std::chrono::steady_clock::now();
+    last_ = phase_start_;
+  }
+
+  /**
+   * Return true if the reporter needs to run before the given
+   * iteration of the phase.
+   *
+   * @param[in] m iteration of the phase, starting at 1
+   * @return true if <code>operator()</code> needs to be called
+   */
+  bool due(int m) const { return m >= next_; }
+
+  /**
+   * Logs a message if one is due before iteration <code>m</code> of
+   * the phase and schedules the next call. Only called when
+   * <code>due(m)</code> is true.
+   *
+   * @param[in] m iteration of the phase, starting at 1
+   * @param[in] warmup true if the phase is warmup
+   * @param[in] sampler sampler, queried for the number of gradient
+   *   evaluations
+   * @return true if a message was logged
+   */
+  bool operator()(int m, bool warmup, stan::mcmc::base_mcmc& sampler) {
+    int iteration = start_ + m;
+    bool log = m == next_ && (m == phase_m_ + 1 || iteration == finish_
+                              || (refresh_ > 0 && m % refresh_ == 0));
+    auto now = std::chrono::steady_clock::now();
+    if (refresh_seconds_ > 0 && !log) {
+      std::chrono::duration<double> elapsed = now - last_;
+      log = elapsed.count() >= refresh_seconds_;
+      if (elapsed.count() > 0)
+        stride_ = std::max(
+            1, static_cast<int>((m - last_m_) * 0.1 * refresh_seconds_
+                                / elapsed.count()));
+    }
+    if (log) {
+      log_message(m, warmup, sampler, now);
+      last_ = now;
+      last_m_ = m;
+    }
+    schedule(m);
+    return log;
+  }
+
+ private:
+  void schedule(int m) {
+    int last = finish_ - start_;
+    int next = last;
+    if (refresh_ > 0)
+      next = std::min(next, (m / refresh_ + 1) * refresh_);
+    if (refresh_seconds_ > 0)
+      next = std::min(next, m + stride_);
+    next_ = next > m ? next : std::numeric_limits<int>::max();
+  }
+
+  void log_message(int m, bool warmup, stan::mcmc::base_mcmc& sampler,
+                   std::chrono::steady_clock::time_point now) {
+    int iteration = start_ + m;
+    std::stringstream message;
+    message << "Iteration: ";
+    message << std::setw(width_) << iteration << " / " << finish_;
+    message << " [" << std::setw(3)
+            << static_cast<int>((100.0 * iteration) / finish_) << "%] ";
+    message << (warmup ? " (Warmup)" : " (Sampling)");
+
+    stan::mcmc::performance_counters counters;
+    sampler.get_performance_counters(counters);
+    double gradient_evals = counters.num_gradient_evals;
+    std::chrono::duration<double> elapsed = now - phase_start_;
+    if (phase_gradient_evals_ < 0) {
+      phase_gradient_evals_ = gradient_evals;
+    } else if (elapsed.count() > 0) {
+      // the message is logged before iteration m, so m - 1 are done
+      double done = m - 1 - phase_m_;
+      double iterations_per_second = done / elapsed.count();
+      message << std::fixed << std::setprecision(1) << "  "
+              << iterations_per_second << " iter/s, "
+              << (gradient_evals - phase_gradient_evals_) / elapsed.count()
+              << " grad/s";
+      if (iterations_per_second > 0)
+        message << ", ETA " << std::setprecision(0)
+                << (finish_ - iteration + 1) / iterations_per_second << "s";
+    }
+    logger_.info(message);
+  }
+
+  callbacks::logger& logger_;
+  int refresh_;
+  double refresh_seconds_;
+  int start_;
+  int finish_;
+  int width_;
+  int next_;
+  int stride_;
+  int phase_m_;
+  double phase_gradient_evals_;
+  int last_m_;
+  std::chrono::steady_clock::time_point phase_start_;
+  std::chrono::steady_clock::time_point last_;
+};
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
@@ -2,8 +2,10 @@
 #define STAN_SERVICES_UTIL_RUN_SAMPLER_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <stan/services/util/checkpointer.hpp>
 #include <stan/services/util/generate_transitions.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
+#include <stan/services/util/progress_reporter.hpp>
 #include <chrono>
 #include <vector>
 
@@ -12,10 +14,16 @@ namespace services {
 namespace util {
 
 /**
- * Runs the sampler without adaptation.
+ * Runs the sampler without adaptation, writing draws through the
+ * mcmc writer and checkpoints through the checkpointer. If the
+ * checkpointer was constructed with a checkpoint to resume from, the
+ * initial values and the header are ignored and the run continues
+ * from the checkpoint.
  *
  * @tparam Model Type of model
  * @tparam RNG Type of random number generator
+ * @tparam MCMCWriter Type of mcmc writer, either <code>mcmc_writer</code>
+ *   or <code>async_mcmc_writer</code>
  * @param[in,out] sampler the mcmc sampler to use on the model
  * @param[in] model the model concept to use for computing log probability
  * @param[in] cont_vector initial parameter values
@@ -29,48 +37,149 @@ namespace util {
  * @param[in,out] rng random number generator
  * @param[in,out] interrupt interrupt callback
  * @param[in,out] logger logger for messages
- * @param[in,out] sample_writer writer for draws
- * @param[in,out] diagnostic_writer writer for diagnostic information
+ * @param[in,out] writer writer for draws and diagnostic information;
+ *   writes the performance counters at the end of warmup and sampling
+ *   if a performance writer has been set
+ * @param[in,out] checkpointer checkpointer
+ * @param[in] refresh_seconds if positive, progress messages are also
+ *   written every <code>refresh_seconds</code> seconds
  */
-template <class Model, class RNG>
+template <class Model, class RNG, class MCMCWriter>
 void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
                  std::vector<double>& cont_vector, int num_warmup,
                  int num_samples, int num_thin, int refresh, bool save_warmup,
                  RNG& rng, callbacks::interrupt& interrupt,
-                 callbacks::logger& logger, callbacks::writer& sample_writer,
-                 callbacks::writer& diagnostic_writer) {
+                 callbacks::logger& logger, MCMCWriter& writer,
+                 util::checkpointer& checkpointer,
+                 double refresh_seconds = 0) {
+  util::progress_reporter progress(logger, refresh, refresh_seconds);
   Eigen::Map<Eigen::VectorXd> cont_params(cont_vector.data(),
                                           cont_vector.size());
-  services::util::mcmc_writer writer(sample_writer, diagnostic_writer, logger);
   stan::mcmc::sample s(cont_params, 0, 0);
+  int iteration = 0;
+  bool warmup = true;
 
-  // Headers
-  writer.write_sample_names(s, sampler, model);
-  writer.write_diagnostic_names(s, sampler, model);
+  if (checkpointer.resuming()) {
+    try {
+      iteration = checkpointer.read(sampler, rng, s, writer, warmup);
+    } catch (const std::exception& e) {
+      logger.info("Exception reading checkpoint.");
+      logger.info(e.what());
+      return;
+    }
+    std::vector<std::string> names;
+    writer.get_sample_names(s, sampler, model, names);
+  } else {
+    // Headers
+    writer.write_sample_names(s, sampler, model);
+    writer.write_diagnostic_names(s, sampler, model);
+  }
 
-  auto start_warm = std::chrono::steady_clock::now();
-  util::generate_transitions(sampler, num_warmup, 0, num_warmup + num_samples,
-                             num_thin, refresh, save_warmup, true, writer, s,
-                             model, rng, interrupt, logger);
-  auto end_warm = std::chrono::steady_clock::now();
-  double warm_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            end_warm - start_warm)
-                            .count()
-                        / 1000.0;
-  writer.write_adapt_finish(sampler);
-  sampler.write_sampler_state(sample_writer);
+  double warm_delta_t = 0;
+  if (warmup) {
+    auto start_warm = std::chrono::steady_clock::now();
+    util::generate_transitions(sampler, num_warmup, 0,
+                               num_warmup + num_samples, num_thin, save_warmup,
+                               true, writer, s, model, rng, interrupt, logger,
+                               checkpointer, progress, iteration);
+    auto end_warm = std::chrono::steady_clock::now();
+    warm_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       end_warm - start_warm)
+                       .count()
+                   / 1000.0;
+    writer.write_performance("warmup", num_warmup, sampler);
+    writer.write_adapt_finish(sampler);
+    writer.write_sampler_state(sampler);
+  }
 
   auto start_sample = std::chrono::steady_clock::now();
   util::generate_transitions(sampler, num_samples, num_warmup,
-                             num_warmup + num_samples, num_thin, refresh, true,
-                             false, writer, s, model, rng, interrupt, logger);
+                             num_warmup + num_samples, num_thin, true, false,
+                             writer, s, model, rng, interrupt, logger,
+                             checkpointer, progress,
+                             warmup ? 0 : iteration - num_warmup);
   auto end_sample = std::chrono::steady_clock::now();
   double sample_delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(
                               end_sample - start_sample)
                               .count()
                           / 1000.0;
+  writer.write_performance("sampling", num_warmup + num_samples, sampler);
   writer.write_timing(warm_delta_t, sample_delta_t);
 }
+
+/**
+ * Runs the sampler without adaptation, writing checkpoints through
+ * the checkpointer. If the checkpointer was constructed with a
+ * checkpoint to resume from, the initial values and the header are
+ * ignored and the run continues from the checkpoint.
+ *
+ * @tparam Model Type of model
+ * @tparam RNG Type of random number generator
+ * @param[in,out] sampler the mcmc sampler to use on the model
+ * @param[in] model the model concept to use for computing log probability
+ * @param[in] cont_vector initial parameter values
+ * @param[in] num_warmup number of warmup draws
+ * @param[in] num_samples number of post warmup draws
+ * @param[in] num_thin number to thin the draws. Must be greater than or
+ *   equal to 1.
+ * @param[in] refresh controls output to the <code>logger</code>
+ * @param[in] save_warmup indicates whether the warmup draws should be
+ *   sent to the sample writer
+ * @param[in,out] rng random number generator
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger logger for messages
+ * @param[in,out] sample_writer writer for draws
+ * @param[in,out] diagnostic_writer writer for diagnostic information
+ * @param[in,out] checkpointer checkpointer
+ */
+template <class Model, class RNG>
+void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
+                 std::vector<double>& cont_vector, int num_warmup,
+                 int num_samples, int num_thin, int refresh, bool save_warmup,
+                 RNG& rng, callbacks::interrupt& interrupt,
+                 callbacks::logger& logger, callbacks::writer& sample_writer,
+                 callbacks::writer& diagnostic_writer,
+                 util::checkpointer& checkpointer) {
+  services::util::mcmc_writer writer(sample_writer, diagnostic_writer, logger);
+  run_sampler(sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+              refresh, save_warmup, rng, interrupt, logger, writer,
+              checkpointer);
+}
+
+/**
+ * Runs the sampler without adaptation.
+ *
+ * @tparam Model Type of model
+ * @tparam RNG Type of random number generator
+ * @param[in,out] sampler the mcmc sampler to use on the model
+ * @param[in] model the model concept to use for computing log probability
+ * @param[in] cont_vector initial parameter values
+ * @param[in] num_warmup number of warmup draws
+ * @param[in] num_samples number of post warmup draws
+ * @param[in] num_thin number to thin the draws. Must be greater than or
+ *   equal to 1.
+ * @param[in] refresh controls output to the <code>logger</code>
+ * @param[in] save_warmup indicates whether the warmup draws should be
+ *   sent to the sample writer
+ * @param[in,out] rng random number generator
+ * @param[in,out] interrupt interrupt callback
+ * @param[in,out] logger logger for messages
+ * @param[in,out] sample_writer writer for draws
+ * @param[in,out] diagnostic_writer writer for diagnostic information
+ */
+template <class Model, class RNG>
+void run_sampler(stan::mcmc::base_mcmc& sampler, Model& model,
+                 std::vector<double>& cont_vector, int num_warmup,
+                 int num_samples, int num_thin, int refresh, bool save_warmup,
+                 RNG& rng, callbacks::interrupt& interrupt,
+                 callbacks::logger& logger, callbacks::writer& sample_writer,
+                 callbacks::writer& diagnostic_writer) {
+  callbacks::writer checkpoint_writer;
+  util::checkpointer checkpointer(checkpoint_writer, 0, 0);
+  run_sampler(sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+              refresh, save_warmup, rng, interrupt, logger, sample_writer,
+              diagnostic_writer, checkpointer);
+}
 }  // namespace util
 }  // namespace services
 }  // namespace stan
@@ -0,0 +1,142 @@
+#ifndef STAN_SERVICES_UTIL_SPSC_QUEUE_HPP
+#define STAN_SERVICES_UTIL_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one
+ * consumer thread.
+ *
+ * Elements live in a ring buffer allocated on construction. The
+ * producer only writes the tail index and the consumer only writes
+ * the head index, so <code>try_push</code> and <code>try_pop</code>
+ * never lock. The blocking <code>push</code> and <code>pop</code>
+ * spin briefly and then back off by sleeping, so an idle consumer
+ * does not occupy a core.
+ *
+ * @tparam T type of element; must be default constructible and
+ *   move assignable
+ */
+template <typename T>
+class spsc_queue {
+ public:
+  /**
+   * Construct a queue holding at most <code>capacity</code> elements.
+   *
+   * @param[in] capacity maximum number of queued elements; must be
+   *   positive
+   */
+  explicit spsc_queue(size_t capacity)
+      : buffer_(capacity + 1), head_(0), tail_(0) {}
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  /**
+   * Return the maximum number of queued elements.
+   *
+   * @return capacity
+   */
+  size_t capacity() const { return buffer_.size() - 1; }
+
+  /**
+   * Return true if the queue holds no elements. Only exact when
+   * called from the producer or consumer thread with the other
+   * thread idle.
+   *
+   * @return true if empty
+   */
+  bool empty() const {
+    return head_.load(std::memory_order_acquire)
+           == tail_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Moves the element into the queue if there is room. Called only
+   * from the producer thread.
+   *
+   * @param[in,out] x element
+   * @return true if the element was queued
+   */
+  bool try_push(T& x) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t next = increment(tail);
+    if (next == head_.load(std::memory_order_acquire))
+      return false;
+    buffer_[tail] = std::move(x);
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Moves the oldest element out of the queue if there is one.
+   * Called only from the consumer thread.
+   *
+   * @param[out] x element
+   * @return true if an element was removed
+   */
+  bool try_pop(T& x) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+      return false;
+    x = std::move(buffer_[head]);
+    head_.store(increment(head), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Moves the element into the queue, waiting while it is full.
+   *
+   * @param[in,out] x element
+   */
+  void push(T& x) {
+    for (int n = 0; !try_push(x); ++n)
+      back_off(n);
+  }
+
+  /**
+   * Moves the oldest element out of the queue, waiting while it is
+   * empty.
+   *
+   * @param[out] x element
+   */
+  void pop(T& x) {
+    for (int n = 0; !try_pop(x); ++n)
+      back_off(n);
+  }
+
+  /**
+   * Yields for the first attempts and sleeps afterwards.
+   *
+   * @param[in] n number of failed attempts so far
+   */
+  static void back_off(int n) {
+    if (n < 64)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+
+ private:
+  size_t increment(size_t n) const {
+    return n + 1 == buffer_.size() ? 0 : n + 1;
+  }
+
+  std::vector<T> buffer_;
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+};
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
@@ -0,0 +1,51 @@
+#ifndef STAN_SERVICES_UTIL_WRITE_PROFILE_HPP
+#define STAN_SERVICES_UTIL_WRITE_PROFILE_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <stan/model/profile_statement.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Writes the cost of each profiled statement recorded so far by
+ * <code>stan::model::statement_profiler</code>, for models whose
+ * <code>log_prob</code> was generated with profiling. Call after
+ * sampling or optimization to find the statements that dominate the
+ * run time.
+ *
+ * <p>The names written are <code>line</code>, <code>count</code>,
+ * <code>forward_seconds</code> and <code>reverse_seconds</code>,
+ * followed by one row of values per statement in order of line
+ * number. The reverse pass time is zero for evaluations without
+ * gradients.
+ *
+ * @param[in,out] writer writer for the profile
+ */
+inline void write_profile(callbacks::writer& writer) {
+  std::vector<std::string> names;
+  names.push_back("line");
+  names.push_back("count");
+  names.push_back("forward_seconds");
+  names.push_back("reverse_seconds");
+  writer(names);
+  std::map<int, stan::model::statement_profile> profiles
+      = stan::model::statement_profiler::instance().profiles();
+  std::vector<double> values(names.size());
+  for (const auto& profile : profiles) {
+    values[0] = profile.first;
+    values[1] = profile.second.count;
+    values[2] = profile.second.forward_seconds;
+    values[3] = profile.second.reverse_seconds;
+    writer(values);
+  }
+}
+
+}  // namespace util
+}  // namespace services
+}  // namespace stan
+#endif
@@ -3,7 +3,7 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim.hpp>
-#include <stan/model/gradient.hpp>
+#include <stan/model/gradient_evaluator.hpp>
 #include <stan/variational/base_family.hpp>
 #include <algorithm>
 #include <ostream>
@@ -416,6 +416,7 @@ class normal_fullrank : public base_family {
     Eigen::VectorXd tmp_mu_grad = Eigen::VectorXd::Zero(dimension());
     Eigen::VectorXd eta = Eigen::VectorXd::Zero(dimension());
     Eigen::VectorXd zeta = Eigen::VectorXd::Zero(dimension());
+    stan::model::gradient_evaluator<M> model_gradient(m, dimension());
 
     // Naive Monte Carlo integration
     static const int n_retries = 10;
@@ -427,7 +428,7 @@ class normal_fullrank : public base_family {
       zeta = transform(eta);
       try {
         std::stringstream ss;
-        stan::model::gradient(m, zeta, tmp_lp, tmp_mu_grad, &ss);
+        model_gradient(zeta, tmp_lp, tmp_mu_grad, &ss);
         if (ss.str().length() > 0)
           logger.info(ss);
         stan::math::check_finite(function, "Gradient of mu", tmp_mu_grad);
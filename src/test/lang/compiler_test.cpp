@@ -26,3 +26,37 @@ TEST(LangCompiler, emptyProgram) {
   // can't test equivalence of "" and "model { }" because of the
   // recording of the positions in the file
 }
+
+TEST(LangCompiler, profile) {
+  std::string model_name = "m";
+  std::string model
+      = "parameters {\n"
+        "  real y;\n"
+        "}\n"
+        "transformed parameters {\n"
+        "  real z;\n"
+        "  z = 2 * y;\n"
+        "}\n"
+        "model {\n"
+        "  real t = 1;\n"
+        "  y ~ normal(0, t);\n"
+        "  {\n"
+        "    real u = 2;\n"
+        "    target += u * z;\n"
+        "  }\n"
+        "}\n";
+
+  std::stringstream msgs, stan_lang_in(model), cpp_out;
+  stan::lang::compile(&msgs, stan_lang_in, cpp_out, model_name);
+  EXPECT_EQ(0, count_matches("profile_statement", cpp_out.str()));
+
+  std::stringstream profile_msgs, profile_in(model), profile_out;
+  stan::lang::compile(&profile_msgs, profile_in, profile_out, model_name,
+                      false, "unknown file name", std::vector<std::string>(),
+                      true);
+  std::string cpp = profile_out.str();
+  EXPECT_EQ(3, count_matches("profile_statement<local_scalar_t__>", cpp));
+  EXPECT_EQ(1, count_matches("profile__(6);", cpp));
+  EXPECT_EQ(1, count_matches("profile__(10);", cpp));
+  EXPECT_EQ(1, count_matches("profile__(13);", cpp));
+}
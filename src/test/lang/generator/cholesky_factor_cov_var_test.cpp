@@ -47,7 +47,7 @@ TEST(lang, data_block_hpp_members) {
   std::string hpp = model_to_hpp("data_cholesky_cov_mat", m1);
 
   std::string expected(
-      "private:\n"
+      "struct data_cholesky_cov_mat_data__ {\n"
       "        matrix_d cfcov_54;\n"
       "        matrix_d cfcov_33;\n");
   EXPECT_EQ(1, count_matches(expected, hpp));
@@ -70,7 +70,7 @@ TEST(lang, data_block_hpp_ctor) {
       "\"cfcov_54\", \"matrix_d\", context__.to_vec(5,4));\n"
       "            cfcov_54 = Eigen::Matrix<double, Eigen::Dynamic, "
       "Eigen::Dynamic>(5, 4);\n"
-      "            vals_r__ = context__.vals_r(\"cfcov_54\");\n"
+      "            vals_r__ = context__.vals_r_view(\"cfcov_54\");\n"
       "            pos__ = 0;\n"
       "            size_t cfcov_54_j_2_max__ = 4;\n"
       "            size_t cfcov_54_j_1_max__ = 5;\n"
@@ -91,7 +91,7 @@ TEST(lang, data_block_hpp_ctor) {
       "\"cfcov_33\", \"matrix_d\", context__.to_vec(3,3));\n"
       "            cfcov_33 = Eigen::Matrix<double, Eigen::Dynamic, "
       "Eigen::Dynamic>(3, 3);\n"
-      "            vals_r__ = context__.vals_r(\"cfcov_33\");\n"
+      "            vals_r__ = context__.vals_r_view(\"cfcov_33\");\n"
       "            pos__ = 0;\n"
       "            size_t cfcov_33_j_2_max__ = 3;\n"
       "            size_t cfcov_33_j_1_max__ = 3;\n"
@@ -133,7 +133,7 @@ TEST(lang, transformed_data_block_hpp_members) {
   std::string hpp = model_to_hpp("data_cholesky_cov_mat", m1);
 
   std::string expected(
-      "private:\n"
+      "struct data_cholesky_cov_mat_data__ {\n"
       "        matrix_d cfcov_54;\n"
       "        matrix_d cfcov_33;\n");
   EXPECT_EQ(1, count_matches(expected, hpp));
@@ -229,7 +229,7 @@ TEST(lang, params_block_var_hpp_xform_inits) {
       "            "
       "stan::lang::rethrow_located(std::runtime_error(std::string(\"Variable "
       "cfcov_54 missing\")), current_statement_begin__, prog_reader__());\n"
-      "        vals_r__ = context__.vals_r(\"cfcov_54\");\n"
+      "        vals_r__ = context__.vals_r_view(\"cfcov_54\");\n"
       "        pos__ = 0U;\n"
       "        validate_non_negative_index(\"cfcov_54\", \"5\", 5);\n"
       "        validate_non_negative_index(\"cfcov_54\", \"4\", 4);\n"
@@ -261,7 +261,7 @@ TEST(lang, params_block_var_hpp_xform_inits) {
       "            "
       "stan::lang::rethrow_located(std::runtime_error(std::string(\"Variable "
       "cfcov_33 missing\")), current_statement_begin__, prog_reader__());\n"
-      "        vals_r__ = context__.vals_r(\"cfcov_33\");\n"
+      "        vals_r__ = context__.vals_r_view(\"cfcov_33\");\n"
       "        pos__ = 0U;\n"
       "        validate_non_negative_index(\"cfcov_33\", \"3\", 3);\n"
       "        validate_non_negative_index(\"cfcov_33\", \"3\", 3);\n"
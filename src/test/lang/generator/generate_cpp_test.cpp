@@ -34,8 +34,13 @@ TEST(lang, generate_cpp) {
   EXPECT_EQ(1, count_matches("public:", output_str))
       << "generate_public_decl()";
 
+  EXPECT_EQ(1, count_matches("struct " + model_name + "_data__ {", output_str))
+      << "generate_data_struct()";
+
   // FIXME(carpenter): change this again when the second ctor eliminated
-  EXPECT_EQ(2, count_matches(" " + model_name + "(", output_str))
+  EXPECT_EQ(3, count_matches("    " + model_name + "(", output_str))
+      << "generate_constructor()";
+  EXPECT_EQ(1, count_matches("clone_shared_data(", output_str))
       << "generate_constructor()";
 
   EXPECT_EQ(1, count_matches("~" + model_name + "(", output_str))
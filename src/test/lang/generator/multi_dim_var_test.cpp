@@ -58,7 +58,7 @@ TEST(lang, data_block_var_hpp) {
       "Eigen::Dynamic, Eigen::Dynamic> > >(4, "
       "std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> >(5, "
       "Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>(2, 3)));\n"
-      "            vals_r__ = context__.vals_r(\"ar_mat\");\n"
+      "            vals_r__ = context__.vals_r_view(\"ar_mat\");\n"
       "            pos__ = 0;\n"
       "            size_t ar_mat_j_2_max__ = 3;\n"
       "            size_t ar_mat_j_1_max__ = 2;\n"
@@ -170,7 +170,7 @@ TEST(lang, params_block_var_hpp_xform_inits) {
       "            "
       "stan::lang::rethrow_located(std::runtime_error(std::string(\"Variable "
       "ar_mat missing\")), current_statement_begin__, prog_reader__());\n"
-      "        vals_r__ = context__.vals_r(\"ar_mat\");\n"
+      "        vals_r__ = context__.vals_r_view(\"ar_mat\");\n"
       "        pos__ = 0U;\n"
       "        validate_non_negative_index(\"ar_mat\", \"2\", 2);\n"
       "        validate_non_negative_index(\"ar_mat\", \"3\", 3);\n"
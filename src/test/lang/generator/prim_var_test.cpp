@@ -58,13 +58,21 @@ TEST(lang, data_block_var_hpp_class_member_vars) {
   std::string hpp = model_to_hpp("data_prim", m1);
 
   std::string expected(
-      "private:\n"
+      "struct data_prim_data__ {\n"
       "        int p1;\n"
       "        double p2;\n"
       "        std::vector<int> ar_p1;\n"
       "        std::vector<double> ar_p2;\n");
 
   EXPECT_EQ(1, count_matches(expected, hpp));
+
+  std::string expected_refs(
+      "private:\n"
+      "    std::shared_ptr<const data_prim_data__> data__;\n"
+      "        const decltype(data_prim_data__::p1)& p1;\n"
+      "        const decltype(data_prim_data__::p2)& p2;\n");
+  EXPECT_EQ(1, count_matches(expected_refs, hpp));
+  EXPECT_EQ(1, count_matches("  p1(shared_data__->p1)", hpp));
 }
 
 TEST(lang, data_block_var_hpp_ctor) {
@@ -84,7 +92,7 @@ TEST(lang, data_block_var_hpp_ctor) {
       "            context__.validate_dims(\"data initialization\", \"p1\", "
       "\"int\", context__.to_vec());\n"
       "            p1 = int(0);\n"
-      "            vals_i__ = context__.vals_i(\"p1\");\n"
+      "            vals_i__ = context__.vals_i_view(\"p1\");\n"
       "            pos__ = 0;\n"
       "            p1 = vals_i__[pos__++];\n"
       "            check_greater_or_equal(function__, \"p1\", p1, 0);\n"
@@ -94,7 +102,7 @@ TEST(lang, data_block_var_hpp_ctor) {
       "            context__.validate_dims(\"data initialization\", \"p2\", "
       "\"double\", context__.to_vec());\n"
       "            p2 = double(0);\n"
-      "            vals_r__ = context__.vals_r(\"p2\");\n"
+      "            vals_r__ = context__.vals_r_view(\"p2\");\n"
       "            pos__ = 0;\n"
       "            p2 = vals_r__[pos__++];\n"
       "\n"
@@ -103,7 +111,7 @@ TEST(lang, data_block_var_hpp_ctor) {
       "            context__.validate_dims(\"data initialization\", \"ar_p1\", "
       "\"int\", context__.to_vec(3));\n"
       "            ar_p1 = std::vector<int>(3, int(0));\n"
-      "            vals_i__ = context__.vals_i(\"ar_p1\");\n"
+      "            vals_i__ = context__.vals_i_view(\"ar_p1\");\n"
       "            pos__ = 0;\n"
       "            size_t ar_p1_k_0_max__ = 3;\n"
       "            for (size_t k_0__ = 0; k_0__ < ar_p1_k_0_max__; ++k_0__) {\n"
@@ -115,7 +123,7 @@ TEST(lang, data_block_var_hpp_ctor) {
       "            context__.validate_dims(\"data initialization\", \"ar_p2\", "
       "\"double\", context__.to_vec(4));\n"
       "            ar_p2 = std::vector<double>(4, double(0));\n"
-      "            vals_r__ = context__.vals_r(\"ar_p2\");\n"
+      "            vals_r__ = context__.vals_r_view(\"ar_p2\");\n"
       "            pos__ = 0;\n"
       "            size_t ar_p2_k_0_max__ = 4;\n"
       "            for (size_t k_0__ = 0; k_0__ < ar_p2_k_0_max__; ++k_0__) {\n"
@@ -134,7 +142,7 @@ TEST(lang, data_block_var_hpp_ctor) {
       "            context__.validate_dims(\"data initialization\", \"ar_p3\", "
       "\"double\", context__.to_vec(5));\n"
       "            ar_p3 = std::vector<double>(5, double(0));\n"
-      "            vals_r__ = context__.vals_r(\"ar_p3\");\n"
+      "            vals_r__ = context__.vals_r_view(\"ar_p3\");\n"
       "            pos__ = 0;\n"
       "            size_t ar_p3_k_0_max__ = 5;\n"
       "            for (size_t k_0__ = 0; k_0__ < ar_p3_k_0_max__; ++k_0__) {\n"
@@ -271,7 +279,7 @@ TEST(lang, params_block_var_hpp_xform_inits) {
       "            "
       "stan::lang::rethrow_located(std::runtime_error(std::string(\"Variable "
       "p2 missing\")), current_statement_begin__, prog_reader__());\n"
-      "        vals_r__ = context__.vals_r(\"p2\");\n"
+      "        vals_r__ = context__.vals_r_view(\"p2\");\n"
       "        pos__ = 0U;\n"
       "        context__.validate_dims(\"parameter initialization\", \"p2\", "
       "\"double\", context__.to_vec());\n"
@@ -291,7 +299,7 @@ TEST(lang, params_block_var_hpp_xform_inits) {
       "            "
       "stan::lang::rethrow_located(std::runtime_error(std::string(\"Variable "
       "ar_p2 missing\")), current_statement_begin__, prog_reader__());\n"
-      "        vals_r__ = context__.vals_r(\"ar_p2\");\n"
+      "        vals_r__ = context__.vals_r_view(\"ar_p2\");\n"
       "        pos__ = 0U;\n"
       "        validate_non_negative_index(\"ar_p2\", \"4\", 4);\n"
       "        context__.validate_dims(\"parameter initialization\", "
@@ -318,7 +326,7 @@ TEST(lang, params_block_var_hpp_xform_inits) {
       "            "
       "stan::lang::rethrow_located(std::runtime_error(std::string(\"Variable "
       "ar_p3 missing\")), current_statement_begin__, prog_reader__());\n"
-      "        vals_r__ = context__.vals_r(\"ar_p3\");\n"
+      "        vals_r__ = context__.vals_r_view(\"ar_p3\");\n"
       "        pos__ = 0U;\n"
       "        validate_non_negative_index(\"ar_p3\", \"5\", 5);\n"
       "        context__.validate_dims(\"parameter initialization\", "
@@ -365,28 +373,19 @@ TEST(lang, params_block_var_hpp_log_prob) {
       "\n"
       "            current_statement_begin__ = 3;\n"
       "            std::vector<local_scalar_t__> ar_p2;\n"
-      "            size_t ar_p2_d_0_max__ = 4;\n"
-      "            ar_p2.reserve(ar_p2_d_0_max__);\n"
-      "            for (size_t d_0__ = 0; d_0__ < ar_p2_d_0_max__; ++d_0__) {\n"
-      "                if (jacobian__)\n"
-      "                    ar_p2.push_back(in__.scalar_lub_constrain(0, 1, "
-      "lp__));\n"
-      "                else\n"
-      "                    ar_p2.push_back(in__.scalar_lub_constrain(0, 1));\n"
-      "            }\n"
+      "            if (jacobian__)\n"
+      "                ar_p2 = in__.std_vector_lub_constrain(0, 1, 4, lp__);\n"
+      "            else\n"
+      "                ar_p2 = in__.std_vector_lub_constrain(0, 1, 4);\n"
       "\n"
       "            current_statement_begin__ = 4;\n"
       "            std::vector<local_scalar_t__> ar_p3;\n"
-      "            size_t ar_p3_d_0_max__ = 5;\n"
-      "            ar_p3.reserve(ar_p3_d_0_max__);\n"
-      "            for (size_t d_0__ = 0; d_0__ < ar_p3_d_0_max__; ++d_0__) {\n"
-      "                if (jacobian__)\n"
-      "                    "
-      "ar_p3.push_back(in__.scalar_offset_multiplier_constrain(1, 2, lp__));\n"
-      "                else\n"
-      "                    "
-      "ar_p3.push_back(in__.scalar_offset_multiplier_constrain(1, 2));\n"
-      "            }\n");
+      "            if (jacobian__)\n"
+      "                "
+      "ar_p3 = in__.std_vector_offset_multiplier_constrain(1, 2, 5, lp__);\n"
+      "            else\n"
+      "                "
+      "ar_p3 = in__.std_vector_offset_multiplier_constrain(1, 2, 5);\n");
   EXPECT_EQ(1, count_matches(expected, hpp));
 }
 
@@ -423,12 +422,8 @@ TEST(lang, params_block_var_hpp_write_array) {
       "        double p2 = in__.scalar_constrain();\n"
       "        vars__.push_back(p2);\n"
       "\n"
-      "        std::vector<double> ar_p2;\n"
-      "        size_t ar_p2_d_0_max__ = 4;\n"
-      "        ar_p2.reserve(ar_p2_d_0_max__);\n"
-      "        for (size_t d_0__ = 0; d_0__ < ar_p2_d_0_max__; ++d_0__) {\n"
-      "            ar_p2.push_back(in__.scalar_lub_constrain(0, 1));\n"
-      "        }\n"
+      "        std::vector<double> ar_p2 = "
+      "in__.std_vector_lub_constrain(0, 1, 4);\n"
       "        size_t ar_p2_k_0_max__ = 4;\n"
       "        for (size_t k_0__ = 0; k_0__ < ar_p2_k_0_max__; ++k_0__) {\n"
       "            vars__.push_back(ar_p2[k_0__]);\n"
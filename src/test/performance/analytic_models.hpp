@@ -0,0 +1,203 @@
+#ifndef TEST__PERFORMANCE__ANALYTIC_MODELS_HPP
+#define TEST__PERFORMANCE__ANALYTIC_MODELS_HPP
+
+#include <stan/math/rev.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <Eigen/Dense>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace stan {
+namespace test {
+namespace performance {
+
+/**
+ * Base class for models of analytic target densities written
+ * directly in C++, for measuring the cost of a sampler apart from the
+ * cost of a model.
+ *
+ * <p>The derived class defines
+ * <code>template &lt;typename T&gt; T log_density(const
+ * Eigen::Matrix&lt;T, -1, 1&gt;&amp; x) const</code>, which is used
+ * for scalars other than <code>stan::math::var</code>, and
+ * <code>double log_density_gradient(const Eigen::Ref&lt;const
+ * Eigen::VectorXd&gt;&amp; x, Eigen::Ref&lt;Eigen::VectorXd&gt; grad)
+ * const</code>, which
+ * returns the log density and writes its gradient. For
+ * <code>var</code> the log density is a single node on the autodiff
+ * stack whose reverse pass adds the gradient, so a gradient
+ * evaluation costs one call of <code>log_density_gradient</code>
+ * and a few arena allocations.
+ *
+ * @tparam Derived type of the derived model
+ */
+template <class Derived>
+class analytic_model : public stan::model::prob_grad {
+ public:
+  explicit analytic_model(size_t num_params)
+      : stan::model::prob_grad(num_params) {}
+
+  template <bool propto, bool jacobian_adjust_transform, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs = 0) const {
+    return static_cast<const Derived&>(*this).log_density(params_r);
+  }
+
+  template <bool propto, bool jacobian_adjust_transform>
+  stan::math::var log_prob(
+      Eigen::Matrix<stan::math::var, Eigen::Dynamic, 1>& params_r,
+      std::ostream* msgs = 0) const {
+    using stan::math::arena_t;
+    arena_t<Eigen::Matrix<stan::math::var, Eigen::Dynamic, 1>> x = params_r;
+    arena_t<Eigen::VectorXd> x_val(x.size());
+    for (int i = 0; i < x.size(); ++i)
+      x_val.coeffRef(i) = x.coeff(i).val();
+    arena_t<Eigen::VectorXd> grad(x.size());
+    double lp = static_cast<const Derived&>(*this).log_density_gradient(x_val,
+                                                                        grad);
+    return stan::math::make_callback_var(lp, [x, grad](auto& vi) mutable {
+      for (int i = 0; i < x.size(); ++i)
+        x.coeffRef(i).adj() += vi.adj() * grad.coeff(i);
+    });
+  }
+};
+
+/**
+ * Standard normal distribution in <code>D</code> dimensions.
+ */
+class isotropic_gaussian : public analytic_model<isotropic_gaussian> {
+ public:
+  explicit isotropic_gaussian(size_t D)
+      : analytic_model<isotropic_gaussian>(D) {}
+
+  std::string name() const { return "isotropic_gaussian"; }
+
+  template <typename T>
+  T log_density(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T lp = 0;
+    for (int i = 0; i < x.size(); ++i)
+      lp -= 0.5 * x(i) * x(i);
+    return lp;
+  }
+
+  double log_density_gradient(const Eigen::Ref<const Eigen::VectorXd>& x,
+                              Eigen::Ref<Eigen::VectorXd> grad) const {
+    grad = -x;
+    return -0.5 * x.squaredNorm();
+  }
+};
+
+/**
+ * Stationary autoregressive process of order one with unit marginal
+ * variance and correlation <code>rho</code> between neighbours,
+ * <code>x[1] ~ normal(0, 1)</code> and <code>x[i] ~ normal(rho *
+ * x[i - 1], sqrt(1 - rho^2))</code>. For <code>rho</code> near one
+ * the covariance is badly conditioned, with condition number about
+ * <code>((1 + rho) / (1 - rho))^2</code>, and a diagonal metric
+ * cannot correct it because all marginal variances are one.
+ */
+class ill_conditioned_gaussian
+    : public analytic_model<ill_conditioned_gaussian> {
+ public:
+  ill_conditioned_gaussian(size_t D, double rho)
+      : analytic_model<ill_conditioned_gaussian>(D),
+        rho_(rho),
+        inv_var_(1 / (1 - rho * rho)) {}
+
+  std::string name() const { return "ill_conditioned_gaussian"; }
+
+  template <typename T>
+  T log_density(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T lp = -0.5 * x(0) * x(0);
+    for (int i = 1; i < x.size(); ++i) {
+      T r = x(i) - rho_ * x(i - 1);
+      lp -= 0.5 * inv_var_ * r * r;
+    }
+    return lp;
+  }
+
+  double log_density_gradient(const Eigen::Ref<const Eigen::VectorXd>& x,
+                              Eigen::Ref<Eigen::VectorXd> grad) const {
+    double lp = -0.5 * x(0) * x(0);
+    grad(0) = -x(0);
+    for (int i = 1; i < x.size(); ++i) {
+      double r = inv_var_ * (x(i) - rho_ * x(i - 1));
+      lp -= 0.5 * r * (x(i) - rho_ * x(i - 1));
+      grad(i) = -r;
+      grad(i - 1) += rho_ * r;
+    }
+    return lp;
+  }
+
+ private:
+  double rho_;
+  double inv_var_;
+};
+
+/**
+ * Neal's funnel, <code>v ~ normal(0, 3)</code> and <code>x[i] ~
+ * normal(0, exp(v / 2))</code> for the <code>D - 1</code> other
+ * coordinates. The scale of <code>x</code> varies by orders of
+ * magnitude with <code>v</code>, so no single step size suits the
+ * whole target.
+ */
+class funnel : public analytic_model<funnel> {
+ public:
+  explicit funnel(size_t D) : analytic_model<funnel>(D) {}
+
+  std::string name() const { return "funnel"; }
+
+  template <typename T>
+  T log_density(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    using std::exp;
+    const T& v = x(0);
+    T sum_sq = 0;
+    for (int i = 1; i < x.size(); ++i)
+      sum_sq += x(i) * x(i);
+    return -v * v / 18 - 0.5 * exp(-v) * sum_sq - 0.5 * (x.size() - 1) * v;
+  }
+
+  double log_density_gradient(const Eigen::Ref<const Eigen::VectorXd>& x,
+                              Eigen::Ref<Eigen::VectorXd> grad) const {
+    const double v = x(0);
+    const double inv_scale_sq = std::exp(-v);
+    const double sum_sq = x.tail(x.size() - 1).squaredNorm();
+    grad(0) = -v / 9 + 0.5 * inv_scale_sq * sum_sq - 0.5 * (x.size() - 1);
+    grad.tail(x.size() - 1) = -inv_scale_sq * x.tail(x.size() - 1);
+    return -v * v / 18 - 0.5 * inv_scale_sq * sum_sq
+           - 0.5 * (x.size() - 1) * v;
+  }
+};
+
+/**
+ * Banana shaped density in two dimensions, <code>x[1] ~ normal(0,
+ * 1)</code> and <code>x[2] ~ normal(x[1]^2, 0.5)</code>, whose
+ * curvature changes along the ridge.
+ */
+class banana : public analytic_model<banana> {
+ public:
+  banana() : analytic_model<banana>(2) {}
+
+  std::string name() const { return "banana"; }
+
+  template <typename T>
+  T log_density(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T r = x(1) - x(0) * x(0);
+    return -0.5 * x(0) * x(0) - 2 * r * r;
+  }
+
+  double log_density_gradient(const Eigen::Ref<const Eigen::VectorXd>& x,
+                              Eigen::Ref<Eigen::VectorXd> grad) const {
+    double r = x(1) - x(0) * x(0);
+    grad(0) = -x(0) + 8 * x(0) * r;
+    grad(1) = -4 * r;
+    return -0.5 * x(0) * x(0) - 2 * r * r;
+  }
+};
+
+}  // namespace performance
+}  // namespace test
+}  // namespace stan
+#endif
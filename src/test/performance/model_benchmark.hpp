@@ -0,0 +1,186 @@
+#ifndef TEST__PERFORMANCE__MODEL_BENCHMARK_HPP
+#define TEST__PERFORMANCE__MODEL_BENCHMARK_HPP
+
+#include <stan/io/random_var_context.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/model/gradient_evaluator.hpp>
+#include <stan/model/log_prob_propto.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <Eigen/Dense>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace test {
+namespace performance {
+
+/**
+ * Time per call of one operation of a model.
+ */
+struct model_benchmark_result {
+  /** Name of the model. */
+  std::string model;
+  /** Name of the data, or "none" for models without data. */
+  std::string data;
+  /** Number of unconstrained parameters of the model. */
+  size_t num_params;
+  /** Name of the operation timed. */
+  std::string operation;
+  /** Number of calls timed. */
+  size_t calls;
+  /** Mean time per call in seconds. */
+  double seconds_per_call;
+};
+
+/**
+ * Calls <code>f</code> in batches of doubling size until a batch
+ * takes at least <code>min_seconds</code> and returns the mean time
+ * per call of that batch. One untimed call is made first so that
+ * the batches do not include first-call costs.
+ *
+ * @tparam F type of the callable
+ * @param[in] f callable with no arguments
+ * @param[in] min_seconds minimum time of the batch timed
+ * @param[out] calls number of calls in the batch timed
+ * @return mean seconds per call
+ */
+template <class F>
+double time_per_call(const F& f, double min_seconds, size_t& calls) {
+  f();
+  for (calls = 1;; calls *= 2) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < calls; ++n)
+      f();
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (seconds >= min_seconds || calls >= (size_t(1) << 30))
+      return seconds / calls;
+  }
+}
+
+/**
+ * Times the constructor, <code>transform_inits</code>,
+ * <code>log_prob</code> without and with a gradient and
+ * <code>write_array</code> of a model instantiated with the specified
+ * data. The log density without a gradient is timed on doubles with
+ * all constants, as <code>log_prob</code>, and dropping constants, as
+ * <code>log_prob_propto</code>, which evaluates the model with
+ * autodiff variables as the samplers do. The parameters are drawn
+ * uniformly from (-2, 2) on the unconstrained scale with a fixed
+ * seed, so the same values are used from run to run.
+ *
+ * @tparam M type of the model
+ * @param[in] model_name name of the model for the results
+ * @param[in] data_name name of the data for the results
+ * @param[in] data data for the model
+ * @param[in] min_seconds minimum time spent timing each operation
+ * @param[in,out] results results to which the timings are appended
+ * @throw std::exception if the model cannot be instantiated with the
+ *   data or its log density cannot be evaluated at the parameters
+ */
+template <class M>
+void benchmark_model(const std::string& model_name,
+                     const std::string& data_name, stan::io::var_context& data,
+                     double min_seconds,
+                     std::vector<model_benchmark_result>& results) {
+  std::stringstream msgs;
+  M model(data, 0, &msgs);
+  boost::ecuyer1988 rng(0);
+  stan::io::random_var_context inits(model, rng, 2, false);
+  std::vector<int> params_i;
+  std::vector<double> params_r;
+  model.transform_inits(inits, params_i, params_r, &msgs);
+  Eigen::VectorXd x = Eigen::Map<Eigen::VectorXd>(params_r.data(),
+                                                  params_r.size());
+  Eigen::VectorXd grad;
+  double lp = 0;
+  stan::model::gradient_evaluator<M> gradient(model, params_r.size());
+  std::vector<double> values;
+
+  auto add = [&](const std::string& operation, double seconds, size_t calls) {
+    model_benchmark_result result;
+    result.model = model_name;
+    result.data = data_name;
+    result.num_params = params_r.size();
+    result.operation = operation;
+    result.calls = calls;
+    result.seconds_per_call = seconds;
+    results.push_back(result);
+  };
+  size_t calls;
+  double seconds = time_per_call(
+      [&]() {
+        msgs.str("");
+        M m(data, 0, &msgs);
+      },
+      min_seconds, calls);
+  add("constructor", seconds, calls);
+  seconds = time_per_call(
+      [&]() {
+        msgs.str("");
+        model.transform_inits(inits, params_i, params_r, &msgs);
+      },
+      min_seconds, calls);
+  add("transform_inits", seconds, calls);
+  seconds = time_per_call(
+      [&]() {
+        msgs.str("");
+        lp += model.template log_prob<false, true>(params_r, params_i, &msgs);
+      },
+      min_seconds, calls);
+  add("log_prob", seconds, calls);
+  seconds = time_per_call(
+      [&]() {
+        msgs.str("");
+        lp += stan::model::log_prob_propto<true>(model, params_r, params_i,
+                                                 &msgs);
+      },
+      min_seconds, calls);
+  add("log_prob_propto", seconds, calls);
+  seconds = time_per_call(
+      [&]() {
+        msgs.str("");
+        gradient(x, lp, grad, &msgs);
+      },
+      min_seconds, calls);
+  add("gradient", seconds, calls);
+  seconds = time_per_call(
+      [&]() {
+        msgs.str("");
+        model.write_array(rng, params_r, params_i, values, true, true, &msgs);
+      },
+      min_seconds, calls);
+  add("write_array", seconds, calls);
+}
+
+/**
+ * Writes the benchmark results as comma separated values with a
+ * header line. Each row is keyed by the model, data and operation,
+ * so reports from different commits can be joined on those columns.
+ *
+ * @param[in,out] o stream for the report
+ * @param[in] git_hash hash of the commit benchmarked
+ * @param[in] date date of the run
+ * @param[in] results results to write
+ */
+inline void write_model_benchmark_report(
+    std::ostream& o, const std::string& git_hash, const std::string& date,
+    const std::vector<model_benchmark_result>& results) {
+  o << "git_hash,date,model,data,num_params,operation,calls,"
+    << "seconds_per_call,calls_per_second" << std::endl;
+  for (const model_benchmark_result& result : results)
+    o << git_hash << ",\"" << date << "\"," << result.model << ","
+      << result.data << "," << result.num_params << "," << result.operation
+      << "," << result.calls << "," << result.seconds_per_call << ","
+      << 1 / result.seconds_per_call << std::endl;
+}
+
+}  // namespace performance
+}  // namespace test
+}  // namespace stan
+#endif
@@ -0,0 +1,71 @@
+/**
+ * Performance benchmark: model evaluation.
+ *
+ * Compiled once per model with the generated model header included
+ * first (see the model benchmark targets in make/tests):
+ *
+ *   model_benchmark <model name> [<data file> ...]
+ *
+ * times the constructor, transform_inits, log_prob, log_prob_propto,
+ * gradient and write_array of the model with each of the data files
+ * in Stan's dump format, or without data if none are given. Pass data files of
+ * different sizes to see how each operation scales. The timings are
+ * written to standard output as comma separated values with the git
+ * hash and date (see write_model_benchmark_report). Data the model
+ * cannot be instantiated with is reported on standard error and
+ * skipped, so models that need data the corpus does not provide
+ * produce a report with a header only.
+ *
+ * The environment variable STAN_BENCHMARK_MIN_SECONDS sets the
+ * minimum time spent timing each operation (default 0.1).
+ */
+
+#include <stan/io/dump.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <test/performance/model_benchmark.hpp>
+#include <test/performance/utility.hpp>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <model name> [<data file> ...]"
+              << std::endl;
+    return 1;
+  }
+  double min_seconds = 0.1;
+  if (const char* env = std::getenv("STAN_BENCHMARK_MIN_SECONDS"))
+    min_seconds = std::atof(env);
+
+  std::string model_name = argv[1];
+  std::vector<stan::test::performance::model_benchmark_result> results;
+  for (int n = 2; n < argc || n == 2; ++n) {
+    std::string data_name = n < argc ? argv[n] : "none";
+    try {
+      if (n < argc) {
+        std::ifstream data_stream(argv[n]);
+        if (!data_stream)
+          throw std::domain_error("cannot open data file");
+        stan::io::dump data(data_stream);
+        stan::test::performance::benchmark_model<stan_model>(
+            model_name, data_name, data, min_seconds, results);
+      } else {
+        stan::io::empty_var_context data;
+        stan::test::performance::benchmark_model<stan_model>(
+            model_name, data_name, data, min_seconds, results);
+      }
+    } catch (const std::exception& e) {
+      std::cerr << model_name << " skipped with data " << data_name << ": "
+                << e.what() << std::endl;
+    }
+  }
+  stan::test::performance::write_model_benchmark_report(
+      std::cout, stan::test::performance::get_git_hash(),
+      stan::test::performance::get_date(), results);
+  return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * Performance test: samplers.
+ *
+ * Runs NUTS (base_nuts), XHMC (base_xhmc), static HMC
+ * (base_static_hmc) and classic NUTS (base_nuts_classic), each with
+ * a diagonal metric adapted during warmup as by the services,
+ * against the analytic targets in analytic_models.hpp: a standard
+ * normal and an ill-conditioned normal in 100 dimensions, Neal's
+ * funnel in 10 dimensions and a banana in 2 dimensions. The targets'
+ * gradients are computed in closed form, so the time spent outside
+ * the log density is the cost of the sampler itself.
+ *
+ * For each sampler and target, 4 chains of 1000 warmup and 1000
+ * sampling iterations are run and one comma separated row is written
+ * to standard output with, over the sampling iterations,
+ *   1. sampler and target names and number of parameters,
+ *   2. smallest effective sample size (ESS) of the parameters,
+ *   3. ESS per gradient evaluation and ESS per second,
+ *   4. seconds per leapfrog step spent outside the log density and
+ *      its gradient, from the sampler's performance counters,
+ *   5. heap allocations per transition, counted by replacing the
+ *      global operator new in this test.
+ */
+
+#include <gtest/gtest.h>
+#include <stan/analyze/mcmc/compute_effective_sample_size.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts_classic/adapt_diag_e_nuts_classic.hpp>
+#include <stan/mcmc/hmc/static/adapt_diag_e_static_hmc.hpp>
+#include <stan/mcmc/hmc/xhmc/adapt_diag_e_xhmc.hpp>
+#include <stan/mcmc/performance_counters.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <stan/model/gradient_evaluator.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <test/performance/analytic_models.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> num_allocations(0);
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++num_allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+typedef boost::ecuyer1988 rng_t;
+
+const int num_chains = 4;
+const int num_warmup = 1000;
+const int num_samples = 1000;
+
+template <class Sampler, class Model, class Configure>
+void benchmark_sampler(const std::string& sampler_name, const Model& model,
+                       const Configure& configure) {
+  const size_t D = model.num_params_r();
+  std::vector<std::vector<double> > draws(
+      D, std::vector<double>(num_chains * num_samples));
+  stan::callbacks::logger logger;
+  size_t gradients = 0;
+  size_t leapfrogs = 0;
+  size_t allocations = 0;
+  double seconds = 0;
+  double log_prob_seconds = 0;
+  for (int chain = 0; chain < num_chains; ++chain) {
+    rng_t rng = stan::services::util::create_rng(0, chain + 1);
+    Sampler sampler(model, rng);
+    configure(sampler);
+    sampler.set_performance_timing(true);
+    sampler.get_stepsize_adaptation().set_mu(std::log(10.0));
+    sampler.get_stepsize_adaptation().set_delta(0.8);
+    sampler.get_stepsize_adaptation().set_gamma(0.05);
+    sampler.get_stepsize_adaptation().set_kappa(0.75);
+    sampler.get_stepsize_adaptation().set_t0(10);
+    sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+
+    boost::random::uniform_real_distribution<double> init(-2, 2);
+    Eigen::VectorXd q(D);
+    for (size_t d = 0; d < D; ++d)
+      q(d) = init(rng);
+    stan::mcmc::sample s(q, 0, 0);
+    sampler.engage_adaptation();
+    sampler.z().q = q;
+    sampler.init_stepsize(logger);
+    for (int n = 0; n < num_warmup; ++n)
+      s = sampler.transition(s, logger);
+    sampler.disengage_adaptation();
+
+    stan::mcmc::performance_counters start_counters;
+    sampler.get_performance_counters(start_counters);
+    size_t start_allocations = num_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < num_samples; ++n) {
+      s = sampler.transition(s, logger);
+      for (size_t d = 0; d < D; ++d)
+        draws[d][chain * num_samples + n] = s.cont_params(d);
+    }
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                             - start)
+                   .count();
+    allocations += num_allocations - start_allocations;
+    stan::mcmc::performance_counters counters;
+    sampler.get_performance_counters(counters);
+    gradients += counters.num_gradient_evals
+                 - start_counters.num_gradient_evals;
+    leapfrogs += counters.num_leapfrog_steps
+                 - start_counters.num_leapfrog_steps;
+    log_prob_seconds += counters.log_prob_seconds
+                        - start_counters.log_prob_seconds;
+  }
+
+  double min_ess = num_chains * num_samples;
+  for (size_t d = 0; d < D; ++d) {
+    std::vector<const double*> chains;
+    for (int chain = 0; chain < num_chains; ++chain)
+      chains.push_back(&draws[d][chain * num_samples]);
+    min_ess = std::min(min_ess, stan::analyze::compute_effective_sample_size(
+                                    chains, num_samples));
+  }
+  EXPECT_GT(min_ess, 0) << sampler_name << ", " << model.name();
+  EXPECT_GT(gradients, 0U) << sampler_name << ", " << model.name();
+  EXPECT_GT(leapfrogs, 0U) << sampler_name << ", " << model.name();
+
+  std::cout << sampler_name << "," << model.name() << "," << D << ","
+            << min_ess << "," << min_ess / gradients << ","
+            << min_ess / seconds << ","
+            << (seconds - log_prob_seconds) / leapfrogs << ","
+            << static_cast<double>(allocations) / (num_chains * num_samples)
+            << std::endl;
+}
+
+template <template <class, class> class Sampler, class Configure>
+void benchmark_targets(const std::string& sampler_name,
+                       const Configure& configure) {
+  std::cout << "sampler,target,num_params,min_ess,ess_per_gradient,"
+            << "ess_per_second,overhead_seconds_per_leapfrog,"
+            << "allocations_per_transition" << std::endl;
+  stan::test::performance::isotropic_gaussian isotropic(100);
+  benchmark_sampler<Sampler<stan::test::performance::isotropic_gaussian,
+                            rng_t> >(sampler_name, isotropic, configure);
+  stan::test::performance::ill_conditioned_gaussian ill_conditioned(100, 0.99);
+  benchmark_sampler<
+      Sampler<stan::test::performance::ill_conditioned_gaussian, rng_t> >(
+      sampler_name, ill_conditioned, configure);
+  stan::test::performance::funnel funnel(10);
+  benchmark_sampler<Sampler<stan::test::performance::funnel, rng_t> >(
+      sampler_name, funnel, configure);
+  stan::test::performance::banana banana;
+  benchmark_sampler<Sampler<stan::test::performance::banana, rng_t> >(
+      sampler_name, banana, configure);
+}
+
+template <class Model>
+void expect_gradient(const Model& model) {
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(model.num_params_r(), -1, 1);
+  Eigen::VectorXd grad;
+  double lp;
+  stan::model::gradient_evaluator<Model> gradient(model, x.size());
+  gradient(x, lp, grad);
+  EXPECT_FLOAT_EQ(model.log_density(x), lp) << model.name();
+  for (int i = 0; i < x.size(); ++i) {
+    Eigen::VectorXd x_hi = x;
+    Eigen::VectorXd x_lo = x;
+    x_hi(i) += 1e-6;
+    x_lo(i) -= 1e-6;
+    EXPECT_NEAR((model.log_density(x_hi) - model.log_density(x_lo)) / 2e-6,
+                grad(i), 1e-5)
+        << model.name() << ", " << i;
+  }
+}
+
+}  // namespace
+
+TEST(performance, analytic_model_gradients) {
+  expect_gradient(stan::test::performance::isotropic_gaussian(5));
+  expect_gradient(stan::test::performance::ill_conditioned_gaussian(5, 0.99));
+  expect_gradient(stan::test::performance::funnel(5));
+  expect_gradient(stan::test::performance::banana());
+}
+
+TEST(performance, sampler_nuts) {
+  benchmark_targets<stan::mcmc::adapt_diag_e_nuts>(
+      "nuts", [](auto& sampler) { sampler.set_max_depth(10); });
+}
+
+TEST(performance, sampler_xhmc) {
+  benchmark_targets<stan::mcmc::adapt_diag_e_xhmc>(
+      "xhmc", [](auto& sampler) {
+        sampler.set_max_depth(10);
+        sampler.set_x_delta(0.1);
+      });
+}
+
+TEST(performance, sampler_static_hmc) {
+  benchmark_targets<stan::mcmc::adapt_diag_e_static_hmc>(
+      "static_hmc",
+      [](auto& sampler) { sampler.set_nominal_stepsize_and_T(1, 2); });
+}
+
+TEST(performance, sampler_nuts_classic) {
+  benchmark_targets<stan::mcmc::adapt_diag_e_nuts_classic>(
+      "nuts_classic", [](auto& sampler) { sampler.set_max_depth(10); });
+}
@@ -0,0 +1,148 @@
+/**
+ * Performance test: var_context lookups.
+ *
+ * Builds <code>dump</code> and <code>array_var_context</code> objects
+ * holding 10 to 10,000 scalar variables and times their construction
+ * and one <code>contains_r</code> and <code>vals_r</code> lookup of
+ * every variable. The lookups should take about constant time per
+ * variable, so the time per lookup should not grow with the number of
+ * variables.
+ *
+ * The same contexts, holding the data or initial values of the
+ * logistic performance model besides the extra variables, are then
+ * used to construct the model, to draw initial values through
+ * <code>random_var_context</code> and to initialize the model with
+ * <code>services::util::initialize</code>. The model reads a fixed
+ * number of variables, so these times should not grow with the number
+ * of variables in the context either.
+ */
+
+#include <gtest/gtest.h>
+#include <test/test-models/performance/logistic.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/array_var_context.hpp>
+#include <stan/io/dump.hpp>
+#include <stan/io/random_var_context.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/services/util/initialize.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - start)
+      .count();
+}
+
+template <class Context>
+double lookup_all(const Context& context,
+                  const std::vector<std::string>& names) {
+  double sum = 0;
+  for (const std::string& name : names)
+    if (context.contains_r(name))
+      sum += context.vals_r(name)[0];
+  return sum;
+}
+
+void report(const std::string& context, size_t num_vars, double build,
+            double lookup) {
+  std::cout << context << ": " << num_vars << " variables, build " << build
+            << " s, lookup " << 1e9 * lookup / num_vars << " ns per variable"
+            << std::endl;
+}
+
+void report_model(const std::string& operation, size_t num_vars,
+                  double seconds) {
+  std::cout << operation << ": " << num_vars << " other variables, "
+            << 1e6 * seconds << " us" << std::endl;
+}
+
+/**
+ * Return data for the logistic model with <code>N</code> outcomes and
+ * two predictors in dump format.
+ */
+std::string logistic_data(size_t N) {
+  std::stringstream data;
+  data << "N <- " << N << "\nM <- 2\ny <- c(";
+  for (size_t n = 0; n < N; ++n)
+    data << (n > 0 ? ", " : "") << n % 2;
+  data << ")\nx <- structure(c(";
+  for (size_t n = 0; n < 2 * N; ++n)
+    data << (n > 0 ? ", " : "") << (n < N ? 1.0 : 0.1 * (n - N));
+  data << "), .Dim = c(" << N << ", 2))\n";
+  return data.str();
+}
+
+}  // namespace
+
+TEST(performance, var_context_lookup) {
+  for (size_t num_vars : {10, 100, 1000, 10000}) {
+    std::vector<std::string> names;
+    std::vector<double> values;
+    std::vector<std::vector<size_t> > dims(num_vars);
+    std::stringstream dump_text;
+    for (size_t n = 0; n < num_vars; ++n) {
+      names.push_back("theta_" + std::to_string(n));
+      values.push_back(n + 0.5);
+      dump_text << names.back() << " <- " << values.back() << "\n";
+    }
+    double expected = 0;
+    for (double x : values)
+      expected += x;
+
+    auto start = std::chrono::steady_clock::now();
+    stan::io::dump dump(dump_text);
+    double build = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    EXPECT_FLOAT_EQ(expected, lookup_all(dump, names));
+    report("dump", num_vars, build, seconds_since(start));
+
+    start = std::chrono::steady_clock::now();
+    stan::io::array_var_context array(names, values, dims);
+    build = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    EXPECT_FLOAT_EQ(expected, lookup_all(array, names));
+    report("array_var_context", num_vars, build, seconds_since(start));
+  }
+}
+
+TEST(performance, var_context_model) {
+  typedef boost::ecuyer1988 rng_t;
+  stan::callbacks::logger logger;
+  stan::callbacks::writer init_writer;
+  for (size_t num_vars : {10, 100, 1000, 10000}) {
+    std::stringstream extra;
+    for (size_t n = 0; n < num_vars; ++n)
+      extra << "theta_" << n << " <- " << n + 0.5 << "\n";
+    std::stringstream data_text(logistic_data(100) + extra.str());
+    std::stringstream init_text("beta <- c(0.5, -0.5)\n" + extra.str());
+    stan::io::dump data(data_text);
+    stan::io::dump init(init_text);
+
+    auto start = std::chrono::steady_clock::now();
+    logistic_model_namespace::logistic_model model(data, 0, &std::cout);
+    report_model("model constructor", num_vars, seconds_since(start));
+
+    rng_t rng = stan::services::util::create_rng(0, 1);
+    start = std::chrono::steady_clock::now();
+    std::vector<double> params = stan::services::util::initialize(
+        model, init, rng, 2, false, logger, init_writer);
+    report_model("initialize", num_vars, seconds_since(start));
+    ASSERT_EQ(2U, params.size());
+    EXPECT_FLOAT_EQ(0.5, params[0]);
+
+    start = std::chrono::steady_clock::now();
+    stan::io::random_var_context random_init(model, rng, 2, false);
+    params = stan::services::util::initialize(model, random_init, rng, 2,
+                                              false, logger, init_writer);
+    report_model("random_var_context and initialize", num_vars,
+                 seconds_since(start));
+    EXPECT_EQ(2U, params.size());
+  }
+}
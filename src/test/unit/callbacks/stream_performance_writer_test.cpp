@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <stan/callbacks/stream_performance_writer.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(StanInterfaceCallbacksStreamPerformanceWriter, json_line) {
+  std::stringstream ss;
+  stan::callbacks::stream_performance_writer writer(ss);
+  std::vector<std::string> names{"num_gradient_evals", "log_prob_seconds"};
+  std::vector<double> values{1234, 0.5};
+
+  EXPECT_NO_THROW(writer("warmup", 100, names, values));
+  EXPECT_EQ(
+      "{\"phase\": \"warmup\", \"iteration\": 100, "
+      "\"num_gradient_evals\": 1234, \"log_prob_seconds\": 0.5}\n",
+      ss.str());
+}
+
+TEST(StanInterfaceCallbacksStreamPerformanceWriter, one_line_per_call) {
+  std::stringstream ss;
+  stan::callbacks::stream_performance_writer writer(ss);
+  std::vector<std::string> names;
+  std::vector<double> values;
+
+  writer("warmup", 0, names, values);
+  writer("sampling", 10, names, values);
+  EXPECT_EQ(
+      "{\"phase\": \"warmup\", \"iteration\": 0}\n"
+      "{\"phase\": \"sampling\", \"iteration\": 10}\n",
+      ss.str());
+}
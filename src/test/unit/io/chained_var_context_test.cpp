@@ -52,4 +52,9 @@ TEST(chained_var_context, ctor) {
 
   std::vector<double> alpha(1, 0);
   EXPECT_EQ(alpha, vcc.vals_r("alpha"));
+
+  EXPECT_EQ(avc.vals_r_view("alpha").data(), vcc.vals_r_view("alpha").data());
+  EXPECT_EQ(avc2.vals_r_view("d").data(), vcc.vals_r_view("d").data());
+  ASSERT_EQ(2U, vcc.dims_r_view("c").size());
+  EXPECT_EQ(7U, vcc.dims_r_view("c")[1]);
 }
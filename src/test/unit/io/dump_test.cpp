@@ -683,3 +683,91 @@ TEST(io_dump, too_large_zero_array) {
   test_exception(
       "a <- structure(double(999918446744073709551616L), .Dim = c(2,3))");
 }
+
+TEST(io_dump, views) {
+  std::stringstream in(
+      "a <- c(1.5, 2.5, 3.5)\n"
+      "b <- structure(1:6, .Dim = c(2, 3))\n");
+  stan::io::dump dump(in);
+
+  stan::io::array_view<double> a = dump.vals_r_view("a");
+  ASSERT_EQ(3U, a.size());
+  EXPECT_FLOAT_EQ(1.5, a[0]);
+  EXPECT_FLOAT_EQ(3.5, a[2]);
+  EXPECT_EQ(a.data(), dump.vals_r_view("a").data());
+  ASSERT_EQ(1U, dump.dims_r_view("a").size());
+  EXPECT_EQ(3U, dump.dims_r_view("a")[0]);
+
+  stan::io::array_view<int> b = dump.vals_i_view("b");
+  ASSERT_EQ(6U, b.size());
+  EXPECT_EQ(1, b[0]);
+  EXPECT_EQ(6, b[5]);
+  EXPECT_EQ(b.data(), dump.vals_i_view("b").data());
+  ASSERT_EQ(2U, dump.dims_i_view("b").size());
+  EXPECT_EQ(3U, dump.dims_r_view("b")[1]);
+
+  stan::io::array_view<double> b_r;
+  {
+    stan::io::array_view<double> converted = dump.vals_r_view("b");
+    b_r = converted;
+  }
+  ASSERT_EQ(6U, b_r.size());
+  EXPECT_FLOAT_EQ(1.0, b_r[0]);
+  EXPECT_FLOAT_EQ(6.0, b_r[5]);
+
+  EXPECT_TRUE(dump.vals_r_view("c").empty());
+  EXPECT_TRUE(dump.vals_i_view("a").empty());
+  EXPECT_TRUE(dump.dims_i_view("c").empty());
+}
+
+TEST(io_dump, values_across_blocks) {
+  // longer than the blocks the reader scans, with numbers, names and
+  // keywords split between blocks
+  std::stringstream s;
+  const int n = 100000;
+  s << "a <- c(";
+  for (int i = 0; i < n; ++i)
+    s << (i == 0 ? "" : ", ") << i;
+  s << ")\n";
+  s << "b <- structure(c(";
+  for (int i = 0; i < n; ++i)
+    s << (i == 0 ? "" : ",") << (i % 1000) * 0.25 << "e-1";
+  s << "), .Dim = c(" << n / 4 << ", 4))\n";
+  for (int i = 0; i < 5000; ++i)
+    s << "x" << i << " <- structure(integer(2), .Dim = c(1, 2))\n";
+  s << "c <- 1.5\n";
+
+  stan::io::dump dump(s);
+  std::vector<int> a = dump.vals_i("a");
+  ASSERT_EQ(n, a.size());
+  for (int i = 0; i < n; ++i)
+    EXPECT_EQ(i, a[i]);
+  std::vector<double> b = dump.vals_r("b");
+  ASSERT_EQ(n, b.size());
+  for (int i = 0; i < n; ++i)
+    EXPECT_FLOAT_EQ((i % 1000) * 0.025, b[i]);
+  EXPECT_EQ(2U, dump.dims_r("b").size());
+  for (int i = 0; i < 5000; ++i)
+    EXPECT_TRUE(dump.contains_i("x" + std::to_string(i)));
+  EXPECT_FLOAT_EQ(1.5, dump.vals_r("c")[0]);
+}
+
+TEST(io_dump, whitespace_across_blocks) {
+  // a failed keyword match backs up over a whitespace run longer than
+  // the characters kept when the block is refilled
+  std::stringstream s;
+  s << "a <- c(1, 2)\n";
+  s << std::string(65536 - 5000 - s.str().size(), ' ');
+  s << "b <- Inf" << std::string(10000, ' ') << "\nc <- 5\n";
+  s << "d <- c(-Inf," << std::string(10000, ' ') << "2.5)\n";
+
+  stan::io::dump dump(s);
+  EXPECT_EQ(2U, dump.vals_i("a").size());
+  ASSERT_EQ(1U, dump.vals_r("b").size());
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), dump.vals_r("b")[0]);
+  ASSERT_EQ(1U, dump.vals_i("c").size());
+  EXPECT_EQ(5, dump.vals_i("c")[0]);
+  std::vector<double> d = dump.vals_r("d");
+  ASSERT_EQ(2U, d.size());
+  EXPECT_FLOAT_EQ(2.5, d[1]);
+}
@@ -0,0 +1,141 @@
+#include <stan/io/json_var_context.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+stan::io::json_var_context read_json(const std::string& text) {
+  std::stringstream in(text);
+  return stan::io::json_var_context(in);
+}
+
+void expect_invalid(const std::string& text) {
+  std::stringstream in(text);
+  EXPECT_THROW(stan::io::json_var_context context(in), std::invalid_argument)
+      << text;
+}
+}  // namespace
+
+TEST(ioJsonVarContext, scalars) {
+  stan::io::json_var_context context = read_json(
+      "{\"N\": 3, \"x\": -1.5e2, \"big\": 3000000000,"
+      " \"y\": \"NaN\", \"z\": -Infinity}");
+  EXPECT_TRUE(context.contains_i("N"));
+  EXPECT_TRUE(context.contains_r("N"));
+  EXPECT_EQ(std::vector<int>{3}, context.vals_i("N"));
+  EXPECT_EQ(0U, context.dims_i("N").size());
+  EXPECT_FALSE(context.contains_i("x"));
+  EXPECT_EQ(std::vector<double>{-150}, context.vals_r("x"));
+  EXPECT_FALSE(context.contains_i("big"));
+  EXPECT_EQ(std::vector<double>{3e9}, context.vals_r("big"));
+  EXPECT_TRUE(std::isnan(context.vals_r("y")[0]));
+  EXPECT_EQ(-INFINITY, context.vals_r("z")[0]);
+  EXPECT_FALSE(context.contains_r("w"));
+
+  std::vector<std::string> names;
+  context.names_i(names);
+  EXPECT_EQ(std::vector<std::string>{"N"}, names);
+  context.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"big", "x", "y", "z"}), names);
+}
+
+TEST(ioJsonVarContext, arrays) {
+  stan::io::json_var_context context = read_json(
+      "{\"a\": [1, 2, 3],\n"
+      " \"b\": [[1, 2, 3], [4, 5.5, 6]],\n"
+      " \"c\": [[[1, 2], [3, 4]], [[5, 6], [7, 8]], [[9, 10], [11, 12]]],\n"
+      " \"e\": [], \"f\": [[], []]}");
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), context.vals_i("a"));
+  EXPECT_EQ(std::vector<size_t>{3}, context.dims_i("a"));
+
+  // values are stored in column-major order
+  EXPECT_EQ((std::vector<double>{1, 4, 2, 5.5, 3, 6}), context.vals_r("b"));
+  EXPECT_EQ((std::vector<size_t>{2, 3}), context.dims_r("b"));
+
+  EXPECT_EQ((std::vector<size_t>{3, 2, 2}), context.dims_i("c"));
+  EXPECT_EQ((std::vector<int>{1, 5, 9, 3, 7, 11, 2, 6, 10, 4, 8, 12}),
+            context.vals_i("c"));
+
+  // the first real after the first outer element converts the
+  // integers already placed
+  stan::io::json_var_context mixed
+      = read_json("{\"d\": [[1, 2], [3, 4], [5, 6.5], [7, 8], [9, 10]]}");
+  EXPECT_EQ((std::vector<double>{1, 3, 5, 7, 9, 2, 4, 6.5, 8, 10}),
+            mixed.vals_r("d"));
+  EXPECT_EQ((std::vector<size_t>{5, 2}), mixed.dims_r("d"));
+
+  EXPECT_EQ(std::vector<size_t>{0}, context.dims_i("e"));
+  EXPECT_EQ(0U, context.vals_i("e").size());
+  EXPECT_EQ((std::vector<size_t>{2, 0}), context.dims_r("f"));
+
+  stan::io::array_view<double> b = context.vals_r_view("b");
+  EXPECT_EQ(6U, b.size());
+  EXPECT_EQ(5.5, b[3]);
+  EXPECT_EQ(12U, context.vals_r_view("c").size());
+  EXPECT_EQ(3U, context.dims_i_view("c").size());
+
+  EXPECT_TRUE(context.remove("a"));
+  EXPECT_FALSE(context.contains_r("a"));
+  EXPECT_FALSE(context.remove("a"));
+}
+
+TEST(ioJsonVarContext, validateDims) {
+  stan::io::json_var_context context
+      = read_json("{\"x\": [[1.5, 2], [3, 4]]}");
+  EXPECT_NO_THROW(context.validate_dims("data", "x", "vector", {2, 2}));
+  EXPECT_THROW(context.validate_dims("data", "x", "vector", {2, 3}),
+               std::exception);
+}
+
+TEST(ioJsonVarContext, strings) {
+  stan::io::json_var_context context
+      = read_json("{\"\\u00e9\\n\": 1, \"x\\\"y\": [\"Inf\", 2]}");
+  EXPECT_TRUE(context.contains_i("\xc3\xa9\n"));
+  EXPECT_EQ((std::vector<double>{INFINITY, 2}), context.vals_r("x\"y"));
+}
+
+TEST(ioJsonVarContext, largeInput) {
+  std::stringstream text;
+  text << "{\"x\": [";
+  for (int n = 0; n < 100000; ++n)
+    text << (n > 0 ? ", " : "") << "[" << n << ", " << n % 1000 + 0.25 << "]";
+  text << "]}";
+  stan::io::json_var_context context = read_json(text.str());
+  std::vector<double> x = context.vals_r("x");
+  ASSERT_EQ(200000U, x.size());
+  EXPECT_EQ(0, x[0]);
+  EXPECT_EQ(99999, x[99999]);
+  EXPECT_EQ(0.25, x[100000]);
+  EXPECT_EQ(999.25, x[199999]);
+}
+
+TEST(ioJsonVarContext, errors) {
+  expect_invalid("");
+  expect_invalid("[1, 2]");
+  expect_invalid("{\"x\": 1");
+  expect_invalid("{\"x\": 1,}");
+  expect_invalid("{\"x\": 1} 2");
+  expect_invalid("{\"x\": [1, 2}");
+  expect_invalid("{\"x\": 01}");
+  expect_invalid("{\"x\": 1.5.2}");
+  expect_invalid("{\"x\": 1.}");
+  expect_invalid("{\"x\": 1.e5}");
+  expect_invalid("{\"x\": 1e}");
+  expect_invalid("{\"x\": 1e+}");
+  expect_invalid("{\"x\": 1-2}");
+  expect_invalid("{\"x\": -}");
+  expect_invalid("{\"x\": true}");
+  expect_invalid("{\"x\": null}");
+  expect_invalid("{\"x\": \"abc\"}");
+  expect_invalid("{\"x\": {\"y\": 1}}");
+  expect_invalid("{\"x\": 1, \"x\": 2}");
+  expect_invalid("{\"x\": [[1, 2], [3]]}");
+  expect_invalid("{\"x\": [[1, 2], 3]}");
+  expect_invalid("{\"x\": [1, [2, 3]]}");
+  expect_invalid("{\"x\": [[], [1]]}");
+  expect_invalid("{\"x\": [[1, 2], [3, 4, 5]]}");
+  expect_invalid("{\"x\": [[[1], [2]], [[3], [4], [5]]]}");
+}
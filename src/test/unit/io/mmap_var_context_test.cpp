@@ -0,0 +1,148 @@
+#include <stan/io/dump_to_mmap_var_context.hpp>
+#include <stan/io/mmap_var_context.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class io_mmap_var_context : public testing::Test {
+ public:
+  io_mmap_var_context() : path("mmap_var_context_test.bin") {}
+
+  void write(const std::string& dump_data) {
+    std::stringstream in(dump_data);
+    std::ofstream out(path, std::ios::binary);
+    stan::io::dump_to_mmap_var_context(in, out);
+  }
+
+  void TearDown() { std::remove(path.c_str()); }
+
+  std::string path;
+};
+
+TEST_F(io_mmap_var_context, round_trip) {
+  write(
+      "N <- 3L\n"
+      "y <- c(1.5, -2.25, 1e300)\n"
+      "x <- structure(c(1.5, 2, 3, 4, 5, 6), .Dim = c(2, 3))\n"
+      "k <- structure(1:6, .Dim = c(3, 2))\n"
+      "empty <- integer(0)\n");
+  stan::io::mmap_var_context context(path);
+
+  EXPECT_TRUE(context.contains_i("N"));
+  EXPECT_TRUE(context.contains_r("N"));
+  EXPECT_FALSE(context.contains_i("y"));
+  EXPECT_TRUE(context.contains_r("y"));
+  EXPECT_FALSE(context.contains_r("z"));
+
+  EXPECT_EQ(std::vector<int>(1, 3), context.vals_i("N"));
+  EXPECT_EQ(std::vector<double>(1, 3.0), context.vals_r("N"));
+  EXPECT_TRUE(context.dims_i("N").empty());
+
+  std::vector<double> y = {1.5, -2.25, 1e300};
+  EXPECT_EQ(y, context.vals_r("y"));
+  EXPECT_EQ(std::vector<size_t>(1, 3), context.dims_r("y"));
+
+  std::vector<double> x = {1.5, 2, 3, 4, 5, 6};
+  EXPECT_EQ(x, context.vals_r("x"));
+  std::vector<size_t> x_dims = {2, 3};
+  EXPECT_EQ(x_dims, context.dims_r("x"));
+
+  std::vector<int> k = {1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(k, context.vals_i("k"));
+  std::vector<size_t> k_dims = {3, 2};
+  EXPECT_EQ(k_dims, context.dims_i("k"));
+  EXPECT_EQ(k_dims, context.dims_r("k"));
+
+  EXPECT_TRUE(context.contains_r("empty"));
+  EXPECT_TRUE(context.vals_r("empty").empty());
+  EXPECT_EQ(std::vector<size_t>(1, 0), context.dims_r("empty"));
+
+  std::vector<std::string> names;
+  context.names_i(names);
+  EXPECT_EQ((std::vector<std::string>{"N", "empty", "k"}), names);
+  context.names_r(names);
+  EXPECT_EQ((std::vector<std::string>{"x", "y"}), names);
+}
+
+TEST_F(io_mmap_var_context, views) {
+  write(
+      "y <- c(1.5, -2.25, 3)\n"
+      "k <- c(4L, 5L)\n");
+  stan::io::mmap_var_context context(path);
+
+  stan::io::array_view<double> y = context.vals_r_view("y");
+  ASSERT_EQ(3U, y.size());
+  EXPECT_FLOAT_EQ(-2.25, y[1]);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(y.data()) % 64);
+  EXPECT_EQ(y.data(), context.vals_r_view("y").data());
+
+  stan::io::array_view<int> k = context.vals_i_view("k");
+  ASSERT_EQ(2U, k.size());
+  EXPECT_EQ(5, k[1]);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(k.data()) % 64);
+
+  stan::io::array_view<double> k_r = context.vals_r_view("k");
+  ASSERT_EQ(2U, k_r.size());
+  EXPECT_FLOAT_EQ(4.0, k_r[0]);
+
+  EXPECT_TRUE(context.vals_i_view("y").empty());
+  EXPECT_TRUE(context.vals_r_view("z").empty());
+  EXPECT_EQ(3U, context.dims_r_view("y")[0]);
+}
+
+TEST_F(io_mmap_var_context, validate_dims) {
+  write("y <- c(1.5, -2.25, 3)\n");
+  stan::io::mmap_var_context context(path);
+  std::vector<size_t> dims = {3};
+  EXPECT_NO_THROW(context.validate_dims("data", "y", "vector", dims));
+  dims[0] = 4;
+  EXPECT_THROW(context.validate_dims("data", "y", "vector", dims),
+               std::exception);
+}
+
+TEST_F(io_mmap_var_context, bad_files) {
+  EXPECT_THROW(stan::io::mmap_var_context("no_such_file.bin"),
+               std::runtime_error);
+
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "y <- c(1.5, -2.25, 3)\n";
+  }
+  EXPECT_THROW(stan::io::mmap_var_context context(path), std::runtime_error);
+
+  write("y <- c(1.5, -2.25, 3)\n");
+  std::string contents;
+  {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buf;
+    buf << in.rdbuf();
+    contents = buf.str();
+  }
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << contents.substr(0, contents.size() - 8);
+  }
+  EXPECT_THROW(stan::io::mmap_var_context context(path), std::runtime_error);
+
+  // header, then name size, type, number of dimensions, offset and
+  // number of values of the first variable
+  const size_t name_size_pos = 4 * sizeof(uint64_t);
+  const size_t num_values_pos = 8 * sizeof(uint64_t);
+  auto write_field = [&](size_t pos, uint64_t value) {
+    std::string corrupt = contents;
+    corrupt.replace(pos, sizeof(value), reinterpret_cast<const char*>(&value),
+                    sizeof(value));
+    std::ofstream out(path, std::ios::binary);
+    out << corrupt;
+  };
+  write_field(num_values_pos, 2);
+  EXPECT_THROW(stan::io::mmap_var_context context(path), std::runtime_error);
+  write_field(name_size_pos, contents.size() - 1);
+  EXPECT_THROW(stan::io::mmap_var_context context(path), std::runtime_error);
+  write_field(name_size_pos, 1);
+  EXPECT_NO_THROW(stan::io::mmap_var_context context(path));
+}
@@ -0,0 +1,42 @@
+#include <stan/io/name_index.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(ioNameIndex, empty) {
+  stan::io::name_index<int> index;
+  EXPECT_EQ(0U, index.size());
+  EXPECT_EQ(nullptr, index.find("a"));
+  EXPECT_EQ(nullptr, index.find(""));
+}
+
+TEST(ioNameIndex, insertFind) {
+  stan::io::name_index<int> index;
+  EXPECT_TRUE(index.insert("a", 1));
+  EXPECT_TRUE(index.insert("b", 2));
+  EXPECT_FALSE(index.insert("a", 3));
+  EXPECT_EQ(2U, index.size());
+  ASSERT_NE(nullptr, index.find("a"));
+  EXPECT_EQ(1, *index.find("a"));
+  ASSERT_NE(nullptr, index.find("b"));
+  EXPECT_EQ(2, *index.find("b"));
+  EXPECT_EQ(nullptr, index.find("c"));
+
+  index.clear();
+  EXPECT_EQ(0U, index.size());
+  EXPECT_EQ(nullptr, index.find("a"));
+}
+
+TEST(ioNameIndex, grow) {
+  stan::io::name_index<int> index;
+  index.reserve(10);
+  for (int n = 0; n < 5000; ++n)
+    EXPECT_TRUE(index.insert("x" + std::to_string(n), n));
+  EXPECT_EQ(5000U, index.size());
+  for (int n = 0; n < 5000; ++n) {
+    const int* value = index.find("x" + std::to_string(n));
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(n, *value);
+  }
+  EXPECT_EQ(nullptr, index.find("x5000"));
+  EXPECT_EQ(nullptr, index.find("y0"));
+}
@@ -0,0 +1,54 @@
+#include <stan/io/parse_double.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+double parse(const std::string& s, size_t expected_length) {
+  double x = -99;
+  const char* end = stan::io::parse_double(s.data(), s.data() + s.size(), x);
+  EXPECT_EQ(expected_length, static_cast<size_t>(end - s.data())) << s;
+  return x;
+}
+
+TEST(io_parse_double, decimal) {
+  EXPECT_EQ(0.0, parse("0", 1));
+  EXPECT_EQ(1.5, parse("1.5", 3));
+  EXPECT_EQ(-2.25, parse("-2.25", 5));
+  EXPECT_EQ(0.5, parse("+.5", 3));
+  EXPECT_EQ(3.0, parse("3.", 2));
+  EXPECT_EQ(1e-300, parse("1e-300", 6));
+  EXPECT_EQ(-1.25e10, parse("-1.25E+10", 9));
+  EXPECT_EQ(12.0, parse("12e", 2));
+  EXPECT_EQ(1.5, parse("1.5,2", 3));
+  EXPECT_TRUE(std::signbit(parse("-0", 2)));
+}
+
+TEST(io_parse_double, correctly_rounded) {
+  const char* values[]
+      = {"0.1",     "0.30000000000000004",    "2.2250738585072014e-308",
+         "4.9e-324", "1.7976931348623157e308", "123456789012345678901234",
+         "9007199254740993", "0.000000000000000000000000000123456789"};
+  for (const char* value : values)
+    EXPECT_EQ(std::strtod(value, nullptr),
+              parse(value, std::string(value).size()))
+        << value;
+}
+
+TEST(io_parse_double, special_values) {
+  EXPECT_TRUE(std::isnan(parse("nan", 3)));
+  EXPECT_TRUE(std::isnan(parse("-NaN", 4)));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), parse("inf", 3));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), parse("-Inf", 4));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), parse("Infinity", 8));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), parse("1e400", 5));
+}
+
+TEST(io_parse_double, no_number) {
+  EXPECT_EQ(-99, parse("", 0));
+  EXPECT_EQ(-99, parse("-", 0));
+  EXPECT_EQ(-99, parse(".", 0));
+  EXPECT_EQ(-99, parse("abc", 0));
+  EXPECT_EQ(-99, parse(" 1", 0));
+}
@@ -486,6 +486,46 @@ TEST(io_reader, std_vector) {
   EXPECT_FLOAT_EQ(30.0, a);
 }
 
+TEST(io_reader, std_vector_constrain_matches_scalar) {
+  std::vector<int> theta_i;
+  std::vector<double> theta;
+  for (int i = 0; i < 12; ++i)
+    theta.push_back(0.3 * i - 1.5);
+  stan::io::reader<double> block_reader(theta, theta_i);
+  stan::io::reader<double> scalar_reader(theta, theta_i);
+  double lp_block = 0;
+  double lp_scalar = 0;
+
+  std::vector<double> x = block_reader.std_vector_constrain(3, lp_block);
+  std::vector<double> y
+      = block_reader.std_vector_lb_constrain(1.0, 3, lp_block);
+  std::vector<double> z
+      = block_reader.std_vector_ub_constrain(2.0, 2, lp_block);
+  std::vector<double> w
+      = block_reader.std_vector_lub_constrain(-1.0, 3.0, 2, lp_block);
+  std::vector<double> v = block_reader.std_vector_offset_multiplier_constrain(
+      1.0, 2.0, 2, lp_block);
+  EXPECT_EQ(0U, block_reader.available());
+
+  for (size_t n = 0; n < x.size(); ++n)
+    EXPECT_FLOAT_EQ(scalar_reader.scalar_constrain(lp_scalar), x[n]);
+  for (size_t n = 0; n < y.size(); ++n)
+    EXPECT_FLOAT_EQ(scalar_reader.scalar_lb_constrain(1.0, lp_scalar), y[n]);
+  for (size_t n = 0; n < z.size(); ++n)
+    EXPECT_FLOAT_EQ(scalar_reader.scalar_ub_constrain(2.0, lp_scalar), z[n]);
+  for (size_t n = 0; n < w.size(); ++n)
+    EXPECT_FLOAT_EQ(scalar_reader.scalar_lub_constrain(-1.0, 3.0, lp_scalar),
+                    w[n]);
+  for (size_t n = 0; n < v.size(); ++n)
+    EXPECT_FLOAT_EQ(
+        scalar_reader.scalar_offset_multiplier_constrain(1.0, 2.0, lp_scalar),
+        v[n]);
+  EXPECT_FLOAT_EQ(lp_scalar, lp_block);
+
+  stan::io::reader<double> empty_reader(theta, theta_i);
+  EXPECT_EQ(0U, empty_reader.std_vector_lb_constrain(0.0, 0).size());
+}
+
 TEST(io_reader, vector) {
   std::vector<int> theta_i;
   std::vector<double> theta;
@@ -500,3 +500,161 @@ TEST_F(StanIoStanCsvReader, ParseEightSchools) {
 
   EXPECT_EQ("", out.str());
 }
+
+TEST_F(StanIoStanCsvReader, read_samples_formatting) {
+  std::stringstream in(
+      "1.5, -2 ,nan\r\n"
+      "\n"
+      "# Elapsed Time: 0.25 seconds (Warm-up)\n"
+      "inf,1e-3,\n"
+      "3,4,5");
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, 0));
+  ASSERT_EQ(3, samples.rows());
+  ASSERT_EQ(3, samples.cols());
+  EXPECT_FLOAT_EQ(1.5, samples(0, 0));
+  EXPECT_FLOAT_EQ(-2, samples(0, 1));
+  EXPECT_TRUE(std::isnan(samples(0, 2)));
+  EXPECT_TRUE(std::isinf(samples(1, 0)));
+  EXPECT_FLOAT_EQ(1e-3, samples(1, 1));
+  EXPECT_FLOAT_EQ(0, samples(1, 2));
+  EXPECT_FLOAT_EQ(5, samples(2, 2));
+  EXPECT_FLOAT_EQ(0.25, timing.warmup);
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_many_rows) {
+  std::stringstream in;
+  const int rows = 20000;
+  for (int row = 0; row < rows; ++row)
+    in << row << "," << row * 0.5 << "," << -row << "e-2\n";
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, 0));
+  ASSERT_EQ(rows, samples.rows());
+  for (int row = 0; row < rows; ++row) {
+    EXPECT_EQ(row, samples(row, 0));
+    EXPECT_EQ(row * 0.5, samples(row, 1));
+    EXPECT_FLOAT_EQ(-row * 0.01, samples(row, 2));
+  }
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_bad_columns) {
+  std::stringstream in("1,2,3\n4,5\n");
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  std::stringstream out;
+  EXPECT_FALSE(
+      stan::io::stan_csv_reader::read_samples(in, samples, timing, &out));
+  EXPECT_EQ("Error: expected 3 columns, but found 2 instead for row 2\n",
+            out.str());
+}
+
+TEST_F(StanIoStanCsvReader, parse_columns) {
+  std::stringstream out;
+  stan::io::stan_csv full
+      = stan::io::stan_csv_reader::parse(blocker0_stream, &out);
+  blocker0_stream.clear();
+  blocker0_stream.seekg(0);
+  std::vector<std::string> columns = {"d", "lp__", "mu[2]"};
+  stan::io::stan_csv projected
+      = stan::io::stan_csv_reader::parse(blocker0_stream, columns, &out);
+  EXPECT_EQ(columns, projected.header);
+  ASSERT_EQ(full.samples.rows(), projected.samples.rows());
+  ASSERT_EQ(3, projected.samples.cols());
+  std::vector<int> indices
+      = stan::io::stan_csv_reader::column_indices(full.header, columns);
+  for (int col = 0; col < 3; ++col)
+    EXPECT_MATRIX_EQ(full.samples.col(indices[col]),
+                     projected.samples.col(col));
+  EXPECT_FLOAT_EQ(full.timing.sampling, projected.timing.sampling);
+
+  blocker0_stream.clear();
+  blocker0_stream.seekg(0);
+  stan::io::stan_csv all = stan::io::stan_csv_reader::parse(
+      blocker0_stream, std::vector<std::string>(), &out);
+  EXPECT_EQ(full.header, all.header) << "an empty selection reads all";
+  EXPECT_MATRIX_EQ(full.samples, all.samples);
+
+  std::vector<std::string> missing = {"lp__", "no_such_column"};
+  EXPECT_THROW(stan::io::stan_csv_reader::column_indices(full.header, missing),
+               std::invalid_argument);
+  std::vector<std::string> twice = {"lp__", "lp__"};
+  EXPECT_THROW(stan::io::stan_csv_reader::column_indices(full.header, twice),
+               std::invalid_argument);
+}
+
+TEST_F(StanIoStanCsvReader, parse_chunks) {
+  std::stringstream out;
+  stan::io::stan_csv full
+      = stan::io::stan_csv_reader::parse(blocker0_stream, &out);
+  blocker0_stream.clear();
+  blocker0_stream.seekg(0);
+  std::vector<std::string> columns = {"mu[2]", "lp__"};
+  std::vector<int> chunk_sizes;
+  Eigen::MatrixXd samples(0, 2);
+  auto callback = [&](const Eigen::MatrixXd& chunk) {
+    chunk_sizes.push_back(chunk.rows());
+    Eigen::MatrixXd appended(samples.rows() + chunk.rows(), 2);
+    appended << samples, chunk;
+    samples = appended;
+  };
+  stan::io::stan_csv streamed = stan::io::stan_csv_reader::parse(
+      blocker0_stream, columns, 300, callback, &out);
+  EXPECT_EQ(columns, streamed.header);
+  EXPECT_EQ(0, streamed.samples.size());
+  ASSERT_EQ(full.samples.rows(), samples.rows());
+  ASSERT_EQ(4U, chunk_sizes.size());
+  EXPECT_EQ(300, chunk_sizes[0]);
+  EXPECT_EQ(100, chunk_sizes[3]);
+  std::vector<int> indices
+      = stan::io::stan_csv_reader::column_indices(full.header, columns);
+  EXPECT_MATRIX_EQ(full.samples.col(indices[0]), samples.col(0));
+  EXPECT_MATRIX_EQ(full.samples.col(indices[1]), samples.col(1));
+  EXPECT_FLOAT_EQ(full.timing.warmup, streamed.timing.warmup);
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_chunks_split_lines) {
+  // rows longer than the block size of reading still parse
+  std::stringstream in;
+  const int cols = 100000;
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < cols; ++col)
+      in << (col == 0 ? "" : ",") << row + col * 1e-5;
+    in << "\n";
+  }
+  std::vector<int> columns = {cols - 1, 0};
+  Eigen::MatrixXd samples(0, 2);
+  stan::io::stan_csv_timing timing;
+  auto callback = [&](const Eigen::MatrixXd& chunk) {
+    Eigen::MatrixXd appended(samples.rows() + chunk.rows(), 2);
+    appended << samples, chunk;
+    samples = appended;
+  };
+  EXPECT_TRUE(stan::io::stan_csv_reader::read_samples(in, columns, 2, callback,
+                                                      timing, 0));
+  ASSERT_EQ(3, samples.rows());
+  EXPECT_FLOAT_EQ(2 + (cols - 1) * 1e-5, samples(2, 0));
+  EXPECT_FLOAT_EQ(1, samples(1, 1));
+}
+
+TEST_F(StanIoStanCsvReader, read_samples_negative_columns) {
+  stan::io::stan_csv_timing timing;
+  for (std::vector<int> columns :
+       {std::vector<int>{-5}, std::vector<int>{1, -1}, std::vector<int>{3}}) {
+    std::stringstream in("1,2,3\n4,5,6\n");
+    Eigen::MatrixXd samples;
+    std::stringstream out;
+    EXPECT_FALSE(stan::io::stan_csv_reader::read_samples(in, columns, samples,
+                                                         timing, &out));
+    EXPECT_NE(std::string::npos, out.str().find("out of range"));
+
+    in.clear();
+    in.str("1,2,3\n4,5,6\n");
+    auto callback = [](const Eigen::MatrixXd& chunk) {};
+    EXPECT_FALSE(stan::io::stan_csv_reader::read_samples(in, columns, 2,
+                                                         callback, timing, 0));
+  }
+}
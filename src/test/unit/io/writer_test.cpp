@@ -57,6 +57,22 @@ TEST(io_writer, integer) {
 
   EXPECT_EQ(integer, writer.data_i()[0]);
 }
+TEST(io_writer, reserve) {
+  std::vector<int> theta_i;
+  std::vector<double> theta;
+  stan::io::writer<double> writer(theta, theta_i);
+  writer.reserve(10, 2);
+  EXPECT_LE(10U, writer.data_r().capacity());
+  EXPECT_LE(2U, writer.data_i().capacity());
+  const double* data = writer.data_r().data();
+  for (int n = 0; n < 10; ++n) {
+    double y = n;
+    writer.scalar_unconstrain(y);
+  }
+  EXPECT_EQ(data, writer.data_r().data());
+  EXPECT_EQ(10U, writer.data_r().size());
+}
+
 TEST(io_writer, row_vector_unconstrain) {
   std::vector<int> theta_i;
   std::vector<double> theta;
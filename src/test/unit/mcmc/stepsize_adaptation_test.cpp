@@ -1,5 +1,7 @@
 #include <stan/mcmc/stepsize_adaptation.hpp>
 #include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
 
 TEST(McmcStepsizeAdaptation, set_mu) {
   stan::mcmc::stepsize_adaptation adaptation;
@@ -141,3 +143,30 @@ TEST(McmcStepsizeAdaptation, learn_stepsize_3) {
   EXPECT_NEAR(0.75, adaptation.kappa(), 1e-14);
   EXPECT_NEAR(10, adaptation.t0(), 1e-14);
 }
+
+TEST(McmcStepsizeAdaptation, checkpoint) {
+  stan::mcmc::stepsize_adaptation adaptation;
+  adaptation.set_mu(0.3);
+
+  double epsilon = 1;
+  adaptation.learn_stepsize(epsilon, 0.9);
+  adaptation.learn_stepsize(epsilon, 0.1);
+
+  std::stringstream checkpoint;
+  checkpoint.precision(std::numeric_limits<double>::max_digits10);
+  adaptation.write_checkpoint(checkpoint);
+
+  stan::mcmc::stepsize_adaptation restored;
+  restored.read_checkpoint(checkpoint);
+  EXPECT_EQ(adaptation.get_mu(), restored.get_mu());
+
+  double epsilon_1 = epsilon;
+  double epsilon_2 = epsilon;
+  adaptation.learn_stepsize(epsilon_1, 0.7);
+  restored.learn_stepsize(epsilon_2, 0.7);
+  EXPECT_EQ(epsilon_1, epsilon_2);
+
+  adaptation.complete_adaptation(epsilon_1);
+  restored.complete_adaptation(epsilon_2);
+  EXPECT_EQ(epsilon_1, epsilon_2);
+}
@@ -1,6 +1,8 @@
 #include <stan/mcmc/var_adaptation.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
 #include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
 
 TEST(McmcVarAdaptation, learn_variance) {
   stan::test::unit::instrumented_logger logger;
@@ -25,3 +27,35 @@ TEST(McmcVarAdaptation, learn_variance) {
 
   EXPECT_EQ(0, logger.call_count());
 }
+
+TEST(McmcVarAdaptation, checkpoint) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 3;
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd q(n);
+
+  stan::mcmc::var_adaptation adapter(n);
+  adapter.set_window_params(50, 0, 0, 10, logger);
+  for (int i = 0; i < 5; ++i) {
+    q << i, 0.5 * i * i, -1.0 / (i + 1);
+    adapter.learn_variance(var, q);
+  }
+
+  std::stringstream checkpoint;
+  checkpoint.precision(std::numeric_limits<double>::max_digits10);
+  adapter.write_checkpoint(checkpoint);
+
+  stan::mcmc::var_adaptation restored(n);
+  restored.read_checkpoint(checkpoint);
+
+  Eigen::VectorXd var_1(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd var_2(Eigen::VectorXd::Zero(n));
+  for (int i = 5; i < 10; ++i) {
+    q << i, 0.5 * i * i, -1.0 / (i + 1);
+    EXPECT_EQ(adapter.learn_variance(var_1, q),
+              restored.learn_variance(var_2, q));
+  }
+  for (int i = 0; i < n; ++i)
+    EXPECT_EQ(var_1(i), var_2(i));
+}
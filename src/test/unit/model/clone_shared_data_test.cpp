@@ -0,0 +1,67 @@
+#include <stan/io/dump.hpp>
+#include <test/test-models/good/model/shared_data.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/additive_combine.hpp>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+class ModelCloneSharedData : public testing::Test {
+ public:
+  void SetUp() {
+    std::stringstream data_stream("N <- 4\ny <- c(1.5, -0.5, 2, 0.25)\n");
+    stan::io::dump data_var_context(data_stream);
+    model.reset(new stan_model(data_var_context, 0, &msgs));
+    params_r.resize(2);
+    params_r << 0.3, -0.7;
+  }
+
+  std::stringstream msgs;
+  std::unique_ptr<stan_model> model;
+  Eigen::VectorXd params_r;
+};
+
+TEST_F(ModelCloneSharedData, shares_data) {
+  std::unique_ptr<stan::model::model_base> clone
+      = model->clone_shared_data(&msgs);
+  ASSERT_TRUE(clone != nullptr);
+  stan_model* cloned_model = dynamic_cast<stan_model*>(clone.get());
+  ASSERT_TRUE(cloned_model != nullptr);
+  EXPECT_NE(model.get(), cloned_model);
+  EXPECT_EQ(model->shared_data().get(), cloned_model->shared_data().get());
+}
+
+TEST_F(ModelCloneSharedData, same_log_prob_and_write_array) {
+  std::unique_ptr<stan::model::model_base> clone
+      = model->clone_shared_data(&msgs);
+  stan::model::model_base& original = *model;
+
+  EXPECT_EQ(original.log_prob(params_r, &msgs),
+            clone->log_prob(params_r, &msgs));
+
+  boost::ecuyer1988 rng_original(1234);
+  boost::ecuyer1988 rng_clone(1234);
+  Eigen::VectorXd draw_original;
+  Eigen::VectorXd draw_clone;
+  original.write_array(rng_original, params_r, draw_original, true, true,
+                       &msgs);
+  clone->write_array(rng_clone, params_r, draw_clone, true, true, &msgs);
+  ASSERT_EQ(3, draw_original.size());
+  ASSERT_EQ(draw_original.size(), draw_clone.size());
+  for (int i = 0; i < draw_original.size(); ++i)
+    EXPECT_EQ(draw_original(i), draw_clone(i));
+}
+
+TEST_F(ModelCloneSharedData, outlives_original) {
+  stan::model::model_base& original = *model;
+  double lp = original.log_prob(params_r, &msgs);
+  std::unique_ptr<stan::model::model_base> clone
+      = model->clone_shared_data(&msgs);
+  model.reset();
+
+  EXPECT_EQ(lp, clone->log_prob(params_r, &msgs));
+  boost::ecuyer1988 rng(1234);
+  Eigen::VectorXd draw;
+  clone->write_array(rng, params_r, draw, true, true, &msgs);
+  EXPECT_EQ(3, draw.size());
+}
@@ -128,3 +128,30 @@ TEST(ModelUtil, streams) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(ModelUtil, finite_diff_grad_richardson) {
+  TestModel_uniform_01 model;
+  std::vector<double> params_r(1);
+  std::vector<int> params_i(0);
+  std::vector<size_t> indices(1, 0);
+  std::vector<double> gradient;
+  std::vector<std::vector<double> > directions(1, std::vector<double>(1, -1));
+  std::vector<double> derivatives;
+  stan::callbacks::interrupt interrupt;
+
+  for (int i = 0; i < 10; i++) {
+    double x = (i - 5.0) * 2;
+    params_r[0] = x;
+
+    stan::model::finite_diff_grad<false, true>(
+        model, interrupt, params_r, params_i, indices, gradient, 1e-3, 2);
+    ASSERT_EQ(1U, gradient.size());
+    EXPECT_NEAR(-std::tanh(0.5 * x), gradient[0], 1e-10);
+
+    stan::model::finite_diff_directional_derivatives<false, true>(
+        model, interrupt, params_r, params_i, directions, derivatives, 1e-3,
+        2);
+    ASSERT_EQ(1U, derivatives.size());
+    EXPECT_NEAR(std::tanh(0.5 * x), derivatives[0], 1e-10);
+  }
+}
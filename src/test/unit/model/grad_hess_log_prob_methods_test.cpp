@@ -0,0 +1,47 @@
+#include <stan/model/grad_hess_log_prob.hpp>
+#include <stan/io/dump.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+
+TEST(ModelUtil, grad_hess_log_prob_methods) {
+  std::stringstream data_stream("");
+  stan::io::dump data_var_context(data_stream);
+  rosenbrock_model_namespace::rosenbrock_model model(data_var_context);
+  std::vector<double> params_r = {0.5, 1.0};
+  std::vector<int> params_i;
+
+  // Hessian of -((1 - x)^2 + 100 * (y - x^2)^2) at (0.5, 1)
+  std::vector<double> expected_hessian = {98, 200, 200, -200};
+
+  std::vector<double> gradient;
+  std::vector<double> hessian;
+  double lp = stan::model::grad_hess_log_prob<true, true>(
+      model, params_r, params_i, gradient, hessian);
+  ASSERT_EQ(4U, hessian.size());
+  for (size_t i = 0; i < hessian.size(); ++i)
+    EXPECT_NEAR(expected_hessian[i], hessian[i], 1e-4);
+
+  std::vector<double> threads_gradient;
+  std::vector<double> threads_hessian;
+  double threads_lp = stan::model::grad_hess_log_prob<true, true>(
+      model, params_r, params_i, threads_gradient, threads_hessian,
+      stan::model::hessian_method::finite_diff, 4);
+  EXPECT_FLOAT_EQ(lp, threads_lp);
+  EXPECT_EQ(gradient, threads_gradient);
+  EXPECT_EQ(hessian, threads_hessian);
+
+  std::vector<double> ad_gradient;
+  std::vector<double> ad_hessian;
+  double ad_lp = stan::model::grad_hess_log_prob<true, true>(
+      model, params_r, params_i, ad_gradient, ad_hessian,
+      stan::model::hessian_method::autodiff);
+  EXPECT_FLOAT_EQ(lp, ad_lp);
+  ASSERT_EQ(gradient.size(), ad_gradient.size());
+  for (size_t i = 0; i < gradient.size(); ++i)
+    EXPECT_FLOAT_EQ(gradient[i], ad_gradient[i]);
+  ASSERT_EQ(4U, ad_hessian.size());
+  for (size_t i = 0; i < ad_hessian.size(); ++i)
+    EXPECT_FLOAT_EQ(expected_hessian[i], ad_hessian[i]);
+}
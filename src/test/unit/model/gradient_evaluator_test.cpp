@@ -0,0 +1,100 @@
+#include <stan/model/gradient_evaluator.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// log density -0.5 * sum(x .* x .* scale), printing when print is set
+struct quadratic_model {
+  std::vector<double> scale;
+  bool print;
+
+  template <bool propto, bool jacobian_adjust_transform, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* msgs = 0) const {
+    if (params_r.size() > static_cast<int>(scale.size()))
+      throw std::domain_error("too many parameters");
+    if (print && msgs)
+      *msgs << "evaluated";
+    T lp(0.0);
+    for (int n = 0; n < params_r.size(); ++n)
+      lp += -0.5 * scale[n] * params_r(n) * params_r(n);
+    return lp;
+  }
+};
+
+}  // namespace
+
+TEST(ModelUtil, gradient_evaluator_repeated_calls) {
+  quadratic_model model{{1, 2, 3}, false};
+  stan::model::gradient_evaluator<quadratic_model> gradient(model, 3);
+  EXPECT_EQ(3U, gradient.num_params());
+
+  Eigen::VectorXd x(3);
+  Eigen::VectorXd g;
+  double f;
+  for (int k = 0; k < 3; ++k) {
+    x << k, 1 + k, -2 * k;
+    gradient(x, f, g);
+    ASSERT_EQ(3, g.size());
+    EXPECT_FLOAT_EQ(-0.5 * (x(0) * x(0) + 2 * x(1) * x(1) + 3 * x(2) * x(2)),
+                    f);
+    for (int n = 0; n < 3; ++n)
+      EXPECT_FLOAT_EQ(-(n + 1) * x(n), g(n));
+  }
+
+  std::vector<double> y{1, 2};
+  std::vector<double> h;
+  EXPECT_FLOAT_EQ(-4.5, gradient(y, h));
+  EXPECT_EQ(2U, gradient.num_params());
+  ASSERT_EQ(2U, h.size());
+  EXPECT_FLOAT_EQ(-1, h[0]);
+  EXPECT_FLOAT_EQ(-4, h[1]);
+}
+
+TEST(ModelUtil, gradient_evaluator_nested) {
+  quadratic_model model{{1, 1}, false};
+  stan::model::gradient_evaluator<quadratic_model> gradient(model, 2);
+
+  stan::math::var a = 3.0;
+  stan::math::var b = a * a;
+
+  Eigen::VectorXd x(2);
+  x << 1, -1;
+  Eigen::VectorXd g;
+  double f;
+  gradient(x, f, g);
+  EXPECT_FLOAT_EQ(-1, f);
+  EXPECT_FLOAT_EQ(-1, g(0));
+  EXPECT_FLOAT_EQ(1, g(1));
+
+  b.grad();
+  EXPECT_FLOAT_EQ(6, a.adj());
+  stan::math::recover_memory();
+}
+
+TEST(ModelUtil, gradient_evaluator_logger) {
+  quadratic_model model{{1}, true};
+  stan::model::gradient_evaluator<quadratic_model> gradient(model, 1);
+  stan::test::unit::instrumented_logger logger;
+
+  Eigen::VectorXd x(1);
+  x << 2;
+  Eigen::VectorXd g;
+  double f;
+  gradient(x, f, g, logger);
+  EXPECT_FLOAT_EQ(-2, f);
+  EXPECT_FLOAT_EQ(-2, g(0));
+  EXPECT_EQ(1U, logger.call_count_info());
+  EXPECT_EQ(1U, logger.find_info("evaluated"));
+
+  Eigen::VectorXd z(2);
+  z << 1, 2;
+  EXPECT_THROW(gradient(z, f, g, logger), std::domain_error);
+  EXPECT_EQ(1U, logger.call_count_info());
+
+  gradient(x, f, g);
+  EXPECT_FLOAT_EQ(-2, f);
+}
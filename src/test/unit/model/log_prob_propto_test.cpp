@@ -1,3 +1,4 @@
+#include <stan/model/log_prob_grad.hpp>
 #include <stan/model/log_prob_propto.hpp>
 #include <test/test-models/good/model/valid.hpp>
 #include <test/unit/util.hpp>
@@ -48,3 +49,30 @@ TEST(ModelUtil, streams) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(ModelUtil, log_prob_propto_matches_var) {
+  std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+  stan::io::dump data_var_context(data_stream);
+  data_stream.close();
+
+  stan_model model(data_var_context, 0, static_cast<std::stringstream*>(0));
+  std::vector<double> params_r(1, 1.5);
+  std::vector<int> params_i(0);
+  std::vector<double> gradient;
+  double lp_var = stan::model::log_prob_grad<true, true>(model, params_r,
+                                                         params_i, gradient);
+  EXPECT_FLOAT_EQ(-1.125, lp_var);
+  EXPECT_FLOAT_EQ(lp_var, stan::model::log_prob_propto<true>(
+                              model, params_r, params_i));
+  EXPECT_FLOAT_EQ(lp_var, stan::model::log_prob_propto_fvar<true>(
+                              model, params_r, params_i));
+
+  Eigen::VectorXd p(1);
+  p << 1.5;
+  EXPECT_FLOAT_EQ(lp_var, stan::model::log_prob_propto<true>(model, p));
+  EXPECT_FLOAT_EQ(lp_var, stan::model::log_prob_propto_fvar<true>(model, p));
+  const stan::model::model_base& base_model = model;
+  EXPECT_FLOAT_EQ(lp_var, stan::model::log_prob_propto<true>(base_model, p));
+  EXPECT_FLOAT_EQ(lp_var,
+                  stan::model::log_prob_propto_fvar<true>(base_model, p));
+}
@@ -186,3 +186,47 @@ TEST(model, modelTemplateLogProb) {
   double v8 = bm.template log_prob<true, true>(params_r_v, msgs).val();
   EXPECT_FLOAT_EQ(8, v8);
 }
+
+TEST(model, modelLogProbBatch) {
+  mock_model m(2);
+  stan::model::model_base& bm = m;
+  Eigen::MatrixXd params_r(3, 2);
+  params_r << 1, 2, 3, 4, 5, 6;
+  Eigen::VectorXd log_probs;
+  Eigen::MatrixXd gradients;
+
+  // double overloads without propto, var overloads otherwise
+  bm.log_prob_batch(params_r, log_probs, false, false);
+  EXPECT_EQ(3, log_probs.size());
+  EXPECT_FLOAT_EQ(1, log_probs(2));
+  bm.log_prob_batch(params_r, log_probs, false, true, 2);
+  EXPECT_FLOAT_EQ(3, log_probs(0));
+  bm.log_prob_batch(params_r, log_probs, true, false, 4);
+  EXPECT_FLOAT_EQ(6, log_probs(1));
+  bm.log_prob_batch(params_r, log_probs, true, true);
+  EXPECT_FLOAT_EQ(8, log_probs(2));
+
+  bm.log_prob_grad_batch(params_r, log_probs, gradients, false, true, 2);
+  EXPECT_EQ(3, log_probs.size());
+  EXPECT_FLOAT_EQ(4, log_probs(1));
+  EXPECT_EQ(3, gradients.rows());
+  EXPECT_EQ(2, gradients.cols());
+  EXPECT_FLOAT_EQ(0, gradients.cwiseAbs().maxCoeff());
+}
+
+TEST(model, modelLogProbProptoValue) {
+  mock_model m(2);
+  stan::model::model_base& bm = m;
+  Eigen::VectorXd params_r(2);
+  std::vector<double> params_r_vec(2);
+  std::vector<int> params_i;
+
+  // defaults evaluate the var overloads
+  EXPECT_FLOAT_EQ(6, bm.log_prob_propto_value(params_r, 0));
+  EXPECT_FLOAT_EQ(8, bm.log_prob_propto_jacobian_value(params_r, 0));
+  double v1 = stan::model::log_prob_propto_fvar<false>(bm, params_r);
+  EXPECT_FLOAT_EQ(6, v1);
+  double v2
+      = stan::model::log_prob_propto_fvar<true>(bm, params_r_vec, params_i);
+  EXPECT_FLOAT_EQ(8, v2);
+}
@@ -0,0 +1,56 @@
+#include <stan/model/profile_statement.hpp>
+#include <gtest/gtest.h>
+#include <map>
+
+TEST(ModelUtil, profile_statement_double) {
+  stan::model::statement_profiler& profiler
+      = stan::model::statement_profiler::instance();
+  profiler.reset();
+  for (int n = 0; n < 3; ++n) {
+    stan::model::profile_statement<double> profile(7);
+  }
+  { stan::model::profile_statement<double> profile(2); }
+
+  std::map<int, stan::model::statement_profile> profiles
+      = profiler.profiles();
+  ASSERT_EQ(2U, profiles.size());
+  EXPECT_EQ(2, profiles.begin()->first);
+  EXPECT_EQ(1U, profiles[2].count);
+  EXPECT_EQ(3U, profiles[7].count);
+  EXPECT_LE(0, profiles[7].forward_seconds);
+  EXPECT_EQ(0, profiles[7].reverse_seconds);
+
+  profiler.reset();
+  EXPECT_EQ(0U, profiler.profiles().size());
+}
+
+TEST(ModelUtil, profile_statement_var) {
+  using stan::math::var;
+  stan::model::statement_profiler& profiler
+      = stan::model::statement_profiler::instance();
+  profiler.reset();
+
+  var x = 2;
+  var y = 0;
+  {
+    stan::model::profile_statement<var> profile(4);
+    y = x * x;
+  }
+  {
+    stan::model::profile_statement<var> profile(5);
+    y = y * x;
+  }
+  EXPECT_EQ(0, profiler.profiles()[4].reverse_seconds);
+  y.grad();
+  EXPECT_FLOAT_EQ(12, x.adj());
+
+  std::map<int, stan::model::statement_profile> profiles
+      = profiler.profiles();
+  ASSERT_EQ(2U, profiles.size());
+  EXPECT_EQ(1U, profiles[4].count);
+  EXPECT_EQ(1U, profiles[5].count);
+  EXPECT_LE(0, profiles[4].reverse_seconds);
+  EXPECT_LE(0, profiles[5].reverse_seconds);
+  stan::math::recover_memory();
+  profiler.reset();
+}
@@ -2,6 +2,7 @@
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/model/test_gradients.hpp>
 #include <test/test-models/good/model/valid.hpp>
+#include <test/unit/model/test_model.hpp>
 #include <test/unit/util.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
 #include <gtest/gtest.h>
@@ -64,3 +65,77 @@ TEST(ModelUtil, streams) {
   EXPECT_EQ("", stan::test::cout_ss.str());
   EXPECT_EQ("", stan::test::cerr_ss.str());
 }
+
+TEST(ModelUtil, test_gradients_sampled) {
+  std::fstream data_stream(std::string("").c_str(), std::fstream::in);
+  stan::io::dump data_var_context(data_stream);
+  data_stream.close();
+
+  stan_model model(data_var_context, 0, static_cast<std::stringstream*>(0));
+  std::vector<double> params_r(1, 0.5);
+  std::vector<int> params_i(0);
+  stan::callbacks::interrupt interrupt;
+  boost::ecuyer1988 rng(1234);
+  std::stringstream out;
+  stan::callbacks::stream_writer writer(out);
+  stan::test::unit::instrumented_logger logger;
+
+  int num_failed = stan::model::test_gradients<true, true>(
+      model, params_r, params_i, 1e-3, 1e-8, 1, 3, 2, rng, interrupt, logger,
+      writer);
+  EXPECT_EQ(0, num_failed);
+  EXPECT_EQ(1, logger.find_info("param idx"));
+  EXPECT_EQ(1, logger.find_info("direction"));
+  EXPECT_EQ(1, count_matches("direction", out.str()));
+}
+
+TEST(ModelUtil, test_gradients_sampled_wrong_coordinate) {
+  TestModel_wrong_gradient model;
+  std::vector<double> params_r = {0.5, -1, 1.5, 2};
+  std::vector<int> params_i(0);
+  stan::callbacks::interrupt interrupt;
+  boost::ecuyer1988 rng(1234);
+  stan::test::unit::instrumented_logger logger;
+  std::stringstream out;
+  stan::callbacks::stream_writer writer(out);
+  // start of the coordinate table line of the wrong coordinate
+  const std::string wrong_line = "         2             1.5";
+
+  int num_drawn = 0;
+  int num_missed = 0;
+  for (int n = 0; n < 20; ++n) {
+    out.str("");
+    int num_failed = stan::model::test_gradients<true, true>(
+        model, params_r, params_i, 1e-3, 1e-6, 1, 0, 1, rng, interrupt,
+        logger, writer);
+    bool drawn = out.str().find(wrong_line) != std::string::npos;
+    EXPECT_EQ(drawn ? 1 : 0, num_failed) << out.str();
+    if (drawn)
+      ++num_drawn;
+    else
+      ++num_missed;
+  }
+  EXPECT_GT(num_drawn, 0);
+  EXPECT_GT(num_missed, 0);
+
+  // every direction has a component along the wrong coordinate
+  for (int n = 0; n < 5; ++n) {
+    out.str("");
+    int num_failed = stan::model::test_gradients<true, true>(
+        model, params_r, params_i, 1e-3, 1e-6, 1, 4, 2, rng, interrupt,
+        logger, writer);
+    bool drawn = out.str().find(wrong_line) != std::string::npos;
+    EXPECT_EQ(drawn ? 5 : 4, num_failed) << out.str();
+  }
+
+  // zero coordinates checks all of them
+  out.str("");
+  int num_failed = stan::model::test_gradients<true, true>(
+      model, params_r, params_i, 1e-3, 1e-6, 0, 0, 1, rng, interrupt, logger,
+      writer);
+  EXPECT_EQ(1, num_failed);
+  EXPECT_EQ(1, count_matches("         0             0.5", out.str()));
+  EXPECT_EQ(1, count_matches("         1              -1", out.str()));
+  EXPECT_EQ(1, count_matches(wrong_line, out.str()));
+  EXPECT_EQ(1, count_matches("         3               2", out.str()));
+}
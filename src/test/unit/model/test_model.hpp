@@ -28,4 +28,25 @@ class TestModel_uniform_01 {
   }
 };
 
+// The gradient of log_prob with respect to params_r__[2] is half the
+// correct value because that coordinate enters its term through its
+// value, which automatic differentiation treats as a constant.
+class TestModel_wrong_gradient {
+ public:
+  size_t num_params_r() const { return 4; }
+
+  template <bool propto__, bool jacobian__, typename T__>
+  T__ log_prob(std::vector<T__>& params_r__, std::vector<int>& params_i__,
+               std::ostream* pstream__ = 0) const {
+    T__ lp__(0.0);
+    for (size_t n = 0; n < params_r__.size(); ++n) {
+      if (n == 2)
+        lp__ -= 0.5 * params_r__[n] * stan::math::value_of(params_r__[n]);
+      else
+        lp__ -= 0.5 * params_r__[n] * params_r__[n];
+    }
+    return lp__;
+  }
+};
+
 #endif
@@ -0,0 +1,119 @@
+#include <stan/services/optimize/laplace.hpp>
+#include <gtest/gtest.h>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <cmath>
+
+class ServicesOptimizeLaplace : public testing::Test {
+ public:
+  ServicesOptimizeLaplace() : model(context, 0, &model_ss) {}
+
+  std::stringstream model_ss;
+  stan::test::unit::instrumented_logger logger;
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::test::unit::instrumented_writer sample;
+  stan::io::empty_var_context context;
+  stan_model model;
+};
+
+TEST_F(ServicesOptimizeLaplace, rosenbrock) {
+  Eigen::VectorXd mode(2);
+  mode << 1, 1;
+  int draws = 10000;
+  int return_code = stan::services::optimize::laplace_sample<false>(
+      model, mode, draws, 0, stan::model::hessian_method::finite_diff, 1,
+      interrupt, logger, sample);
+  EXPECT_EQ(stan::services::error_codes::OK, return_code);
+  EXPECT_EQ(0, logger.call_count_error());
+  EXPECT_EQ(draws, interrupt.call_count());
+
+  std::vector<std::vector<std::string>> names = sample.vector_string_values();
+  ASSERT_EQ(1, names.size());
+  ASSERT_EQ(4, names[0].size());
+  EXPECT_EQ("log_p__", names[0][0]);
+  EXPECT_EQ("log_g__", names[0][1]);
+  EXPECT_EQ("x", names[0][2]);
+  EXPECT_EQ("y", names[0][3]);
+
+  // the inverse of the negative Hessian at (1, 1) is
+  // [0.5, 1; 1, 2.005]
+  std::vector<std::vector<double>> values = sample.vector_double_values();
+  ASSERT_EQ(draws, values.size());
+  Eigen::MatrixXd xy(draws, 2);
+  for (int n = 0; n < draws; ++n) {
+    ASSERT_EQ(4, values[n].size());
+    EXPECT_GE(0, values[n][1]);
+    xy(n, 0) = values[n][2];
+    xy(n, 1) = values[n][3];
+  }
+  Eigen::RowVectorXd mean = xy.colwise().mean();
+  Eigen::MatrixXd centered = xy.rowwise() - mean;
+  Eigen::MatrixXd covariance = centered.transpose() * centered / (draws - 1);
+  EXPECT_NEAR(1, mean(0), 0.05);
+  EXPECT_NEAR(1, mean(1), 0.05);
+  EXPECT_NEAR(0.5, covariance(0, 0), 0.05);
+  EXPECT_NEAR(1, covariance(0, 1), 0.1);
+  EXPECT_NEAR(2.005, covariance(1, 1), 0.2);
+}
+
+TEST_F(ServicesOptimizeLaplace, threads_and_hessian_methods) {
+  Eigen::VectorXd mode(2);
+  mode << 1, 1;
+  stan::test::unit::instrumented_writer sample_threads;
+  stan::test::unit::instrumented_writer sample_autodiff;
+  EXPECT_EQ(stan::services::error_codes::OK,
+            stan::services::optimize::laplace_sample<false>(
+                model, mode, 200, 3, stan::model::hessian_method::finite_diff,
+                1, interrupt, logger, sample));
+  EXPECT_EQ(stan::services::error_codes::OK,
+            stan::services::optimize::laplace_sample<false>(
+                model, mode, 200, 3, stan::model::hessian_method::finite_diff,
+                4, interrupt, logger, sample_threads));
+  EXPECT_EQ(stan::services::error_codes::OK,
+            stan::services::optimize::laplace_sample<false>(
+                model, mode, 200, 3, stan::model::hessian_method::autodiff, 1,
+                interrupt, logger, sample_autodiff));
+
+  std::vector<std::vector<double>> values = sample.vector_double_values();
+  std::vector<std::vector<double>> values_threads
+      = sample_threads.vector_double_values();
+  std::vector<std::vector<double>> values_autodiff
+      = sample_autodiff.vector_double_values();
+  ASSERT_EQ(200, values.size());
+  ASSERT_EQ(200, values_threads.size());
+  ASSERT_EQ(200, values_autodiff.size());
+  for (size_t n = 0; n < values.size(); ++n)
+    for (size_t i = 0; i < values[n].size(); ++i) {
+      EXPECT_FLOAT_EQ(values[n][i], values_threads[n][i]);
+      EXPECT_NEAR(values[n][i], values_autodiff[n][i],
+                  1e-4 * (1 + std::fabs(values[n][i])));
+    }
+}
+
+TEST_F(ServicesOptimizeLaplace, errors) {
+  Eigen::VectorXd mode(2);
+  mode << 0, 1;
+  EXPECT_EQ(stan::services::error_codes::DATAERR,
+            stan::services::optimize::laplace_sample<false>(
+                model, mode, 10, 0, stan::model::hessian_method::finite_diff,
+                1, interrupt, logger, sample));
+  EXPECT_EQ(1, logger.find_error("not negative definite"));
+  EXPECT_EQ(0, sample.vector_double_values().size());
+
+  Eigen::VectorXd short_mode(1);
+  short_mode << 1;
+  EXPECT_EQ(stan::services::error_codes::DATAERR,
+            stan::services::optimize::laplace_sample<false>(
+                model, short_mode, 10, 0,
+                stan::model::hessian_method::finite_diff, 1, interrupt,
+                logger, sample));
+  EXPECT_EQ(stan::services::error_codes::CONFIG,
+            stan::services::optimize::laplace_sample<false>(
+                model, mode, -1, 0, stan::model::hessian_method::finite_diff,
+                1, interrupt, logger, sample));
+  EXPECT_EQ(stan::services::error_codes::CONFIG,
+            stan::services::optimize::laplace_sample<false>(
+                model, mode, 10, 0, stan::model::hessian_method::finite_diff,
+                0, interrupt, logger, sample));
+}
@@ -194,3 +194,84 @@ TEST_F(ServicesSampleHmcNutsDiagEAdapt, output_regression) {
   EXPECT_EQ(1, logger.find_info("seconds (Total)"));
   EXPECT_EQ(0, logger.call_count_error());
 }
+
+TEST_F(ServicesSampleHmcNutsDiagEAdapt, async_output) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::test::unit::instrumented_writer async_init, async_parameter,
+      async_diagnostic;
+
+  int return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+      model, context, random_seed, chain, init_radius, num_warmup, num_samples,
+      num_thin, save_warmup, refresh, stepsize, stepsize_jitter, max_depth,
+      delta, gamma, kappa, t0, init_buffer, term_buffer, window, interrupt,
+      logger, init, parameter, diagnostic);
+  EXPECT_EQ(0, return_code);
+  return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+      model, context, random_seed, chain, init_radius, num_warmup, num_samples,
+      num_thin, save_warmup, refresh, stepsize, stepsize_jitter, max_depth,
+      delta, gamma, kappa, t0, init_buffer, term_buffer, window, interrupt,
+      logger, async_init, async_parameter, async_diagnostic, true);
+  EXPECT_EQ(0, return_code);
+
+  // the model has no random generated quantities, so the draws match
+  EXPECT_EQ(parameter.vector_string_values(),
+            async_parameter.vector_string_values());
+  EXPECT_EQ(parameter.vector_double_values(),
+            async_parameter.vector_double_values());
+  EXPECT_EQ(diagnostic.vector_double_values(),
+            async_diagnostic.vector_double_values());
+}
+
+TEST_F(ServicesSampleHmcNutsDiagEAdapt, pathfinder_init) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 2;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  stan::test::unit::instrumented_interrupt interrupt;
+
+  int return_code = stan::services::sample::hmc_nuts_diag_e_adapt(
+      model, context, random_seed, chain, init_radius, num_warmup, num_samples,
+      num_thin, save_warmup, refresh, stepsize, stepsize_jitter, max_depth,
+      delta, gamma, kappa, t0, init_buffer, term_buffer, window, interrupt,
+      logger, init, parameter, diagnostic, false, 4, 2);
+
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(4, logger.find_info("Pathfinder path"));
+  EXPECT_EQ(1, logger.find_info("effective sample size"));
+  ASSERT_EQ(1, init.vector_double_values().size());
+  EXPECT_EQ(model.num_params_r(), init.vector_double_values()[0].size());
+  int num_output_lines = (num_warmup + num_samples) / num_thin;
+  EXPECT_EQ(num_output_lines, parameter.call_count("vector_double"));
+}
@@ -87,3 +87,104 @@ TEST_F(ServicesStandaloneGQ, genDraws_bad) {
   EXPECT_EQ(count_matches("Wrong number of parameter values", logger_ss.str()),
             1);
 }
+
+TEST_F(ServicesStandaloneGQ, genDraws_stream_bernoulli) {
+  std::stringstream out;
+  std::ifstream csv_stream(
+      "src/test/test-models/good/services/bernoulli_fit.csv");
+  stan::io::stan_csv bern_csv
+      = stan::io::stan_csv_reader::parse(csv_stream, &out);
+  csv_stream.close();
+  std::stringstream sample_ss;
+  stan::callbacks::stream_writer sample_writer(sample_ss, "");
+  int return_code = stan::services::standalone_generate(
+      *model, bern_csv.samples.middleCols<1>(7), 12345, interrupt, logger,
+      sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::OK);
+
+  std::stringstream stream_sample_ss;
+  stan::callbacks::stream_writer stream_sample_writer(stream_sample_ss, "");
+  csv_stream.open("src/test/test-models/good/services/bernoulli_fit.csv");
+  return_code = stan::services::standalone_generate(
+      *model, csv_stream, 300, 12345, interrupt, logger, stream_sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::OK);
+  EXPECT_EQ(sample_ss.str(), stream_sample_ss.str());
+}
+
+TEST_F(ServicesStandaloneGQ, genDraws_stream_missing_column) {
+  std::stringstream csv("lp__,mu\n1,2\n");
+  std::stringstream sample_ss;
+  stan::callbacks::stream_writer sample_writer(sample_ss, "");
+  int return_code = stan::services::standalone_generate(
+      *model, csv, 100, 12345, interrupt, logger, sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::DATAERR);
+  EXPECT_EQ(count_matches("theta not found", logger_ss.str()), 1);
+}
+
+TEST_F(ServicesStandaloneGQ, genDraws_stream_truncated_row) {
+  std::stringstream csv("lp__,theta\n1,0.2\n2,0.3\n3\n4,0.4\n");
+  std::stringstream sample_ss;
+  stan::callbacks::stream_writer sample_writer(sample_ss, "");
+  int return_code = stan::services::standalone_generate(
+      *model, csv, 1, 12345, interrupt, logger, sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::DATAERR);
+  EXPECT_EQ(count_matches("expected 2 columns, but found 1", logger_ss.str()),
+            1);
+  EXPECT_EQ(count_matches("\n", sample_ss.str()), 3)
+      << "the draws before the truncated row are generated";
+
+  csv.clear();
+  csv.str("lp__,theta\n1,0.2\n2\n");
+  logger_ss.str("");
+  return_code = stan::services::standalone_generate(
+      *model, csv, 100, 12345, 2, interrupt, logger, sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::DATAERR);
+  EXPECT_EQ(count_matches("expected 2 columns, but found 1", logger_ss.str()),
+            1);
+  EXPECT_EQ(count_matches("Empty set of draws", logger_ss.str()), 0);
+}
+
+TEST_F(ServicesStandaloneGQ, genDraws_parallel_bernoulli) {
+  std::stringstream out;
+  std::ifstream csv_stream(
+      "src/test/test-models/good/services/bernoulli_fit.csv");
+  stan::io::stan_csv bern_csv
+      = stan::io::stan_csv_reader::parse(csv_stream, &out);
+  csv_stream.close();
+  std::stringstream sample_ss;
+  stan::callbacks::stream_writer sample_writer(sample_ss, "");
+  int return_code = stan::services::standalone_generate(
+      *model, bern_csv.samples.middleCols<1>(7), 12345, 1, interrupt, logger,
+      sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::OK);
+  EXPECT_EQ(count_matches("y_rep", sample_ss.str()), 10);
+  EXPECT_EQ(count_matches("\n", sample_ss.str()), 1001);
+  match_csv_columns(bern_csv.samples, sample_ss.str(), 1000, 1, 8);
+
+  std::stringstream threads_sample_ss;
+  stan::callbacks::stream_writer threads_sample_writer(threads_sample_ss, "");
+  return_code = stan::services::standalone_generate(
+      *model, bern_csv.samples.middleCols<1>(7), 12345, 4, interrupt, logger,
+      threads_sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::OK);
+  EXPECT_EQ(sample_ss.str(), threads_sample_ss.str());
+
+  std::stringstream stream_sample_ss;
+  stan::callbacks::stream_writer stream_sample_writer(stream_sample_ss, "");
+  csv_stream.open("src/test/test-models/good/services/bernoulli_fit.csv");
+  return_code = stan::services::standalone_generate(
+      *model, csv_stream, 300, 12345, 3, interrupt, logger,
+      stream_sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::OK);
+  EXPECT_EQ(sample_ss.str(), stream_sample_ss.str());
+}
+
+TEST_F(ServicesStandaloneGQ, genDraws_parallel_bad_num_threads) {
+  Eigen::MatrixXd draws(2, 1);
+  std::stringstream sample_ss;
+  stan::callbacks::stream_writer sample_writer(sample_ss, "");
+  int return_code = stan::services::standalone_generate(
+      *model, draws, 12345, 0, interrupt, logger, sample_writer);
+  EXPECT_EQ(return_code, stan::services::error_codes::CONFIG);
+  EXPECT_EQ(count_matches("Number of threads", logger_ss.str()), 1);
+}
@@ -0,0 +1,120 @@
+#include <stan/services/util/async_mcmc_writer.hpp>
+#include <stan/services/util/run_adaptive_sampler.hpp>
+#include <gtest/gtest.h>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <stdexcept>
+#include <vector>
+
+class ServicesUtilAsyncMcmcWriter : public testing::Test {
+ public:
+  ServicesUtilAsyncMcmcWriter() : model(context, 0, &model_log) {}
+
+  std::stringstream model_log;
+  stan::io::empty_var_context context;
+  stan_model model;
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::test::unit::instrumented_logger logger;
+};
+
+TEST_F(ServicesUtilAsyncMcmcWriter, matches_mcmc_writer) {
+  stan::test::unit::instrumented_writer sample_writer, diagnostic_writer;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model,
+                                                                         rng);
+    sampler.set_window_params(100, 15, 10, 25, logger);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, 100, 100, 1, 0, true, rng, interrupt,
+        logger, sample_writer, diagnostic_writer);
+  }
+
+  stan::test::unit::instrumented_writer async_sample_writer,
+      async_diagnostic_writer, checkpoint_writer;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    boost::ecuyer1988 output_rng = stan::services::util::create_rng(0, 2);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model,
+                                                                         rng);
+    sampler.set_window_params(100, 15, 10, 25, logger);
+    stan::services::util::async_mcmc_writer<stan_model, boost::ecuyer1988>
+        writer(async_sample_writer, async_diagnostic_writer, logger, model,
+               output_rng, 8);
+    stan::services::util::checkpointer checkpointer(checkpoint_writer, 0, 0);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, 100, 100, 1, 0, true, rng, interrupt,
+        logger, writer, checkpointer);
+    EXPECT_EQ(200, writer.num_draws_);
+  }
+
+  EXPECT_EQ(sample_writer.call_count(), async_sample_writer.call_count());
+  EXPECT_EQ(sample_writer.call_count("vector_double"),
+            async_sample_writer.call_count("vector_double"));
+  EXPECT_EQ(sample_writer.vector_double_values(),
+            async_sample_writer.vector_double_values());
+  EXPECT_EQ(diagnostic_writer.vector_double_values(),
+            async_diagnostic_writer.vector_double_values());
+
+  std::vector<std::string> strings = sample_writer.string_values();
+  std::vector<std::string> async_strings = async_sample_writer.string_values();
+  ASSERT_EQ(strings.size(), async_strings.size());
+  for (size_t n = 0; n < 3; ++n)
+    EXPECT_EQ(strings[n], async_strings[n])
+        << "adaptation info is written after the warmup draws";
+}
+
+TEST_F(ServicesUtilAsyncMcmcWriter, flush) {
+  stan::test::unit::instrumented_writer sample_writer, diagnostic_writer;
+  boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+  stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model,
+                                                                       rng);
+  stan::services::util::async_mcmc_writer<stan_model, boost::ecuyer1988>
+      writer(sample_writer, diagnostic_writer, logger, model, rng, 4);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(2);
+  stan::mcmc::sample s(q, 0, 0);
+  writer.write_sample_names(s, sampler, model);
+  for (int n = 0; n < 20; ++n) {
+    writer.write_sample_params(rng, s, sampler, model);
+    writer.write_diagnostic_params(s, sampler);
+  }
+  writer.flush();
+  EXPECT_EQ(20, sample_writer.call_count("vector_double"));
+  EXPECT_EQ(20, diagnostic_writer.call_count("vector_double"));
+  EXPECT_EQ(20, writer.num_draws_);
+}
+
+class throwing_writer : public stan::callbacks::writer {
+ public:
+  using stan::callbacks::writer::operator();
+  void operator()(const std::vector<double>& state) {
+    throw std::runtime_error("cannot write draw");
+  }
+};
+
+TEST_F(ServicesUtilAsyncMcmcWriter, writer_exception) {
+  throwing_writer sample_writer;
+  stan::test::unit::instrumented_writer diagnostic_writer;
+  boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+  stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model,
+                                                                       rng);
+  stan::services::util::async_mcmc_writer<stan_model, boost::ecuyer1988>
+      writer(sample_writer, diagnostic_writer, logger, model, rng, 4);
+
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(2);
+  stan::mcmc::sample s(q, 0, 0);
+  EXPECT_THROW(
+      {
+        writer.write_sample_params(rng, s, sampler, model);
+        writer.flush();
+      },
+      std::runtime_error);
+  writer.write_diagnostic_params(s, sampler);
+  EXPECT_NO_THROW(writer.flush());
+  EXPECT_EQ(1, diagnostic_writer.call_count("vector_double"));
+}
@@ -0,0 +1,290 @@
+#include <stan/services/util/run_adaptive_sampler.hpp>
+#include <stan/services/util/run_sampler.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <gtest/gtest.h>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/mcmc/hmc/nuts/diag_e_nuts.hpp>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class ServicesUtilCheckpointer : public testing::Test {
+ public:
+  ServicesUtilCheckpointer()
+      : model(context, 0, &model_log),
+        num_warmup(200),
+        num_samples(100),
+        num_thin(1),
+        refresh(0),
+        save_warmup(true) {}
+
+  std::stringstream model_log;
+  stan::io::empty_var_context context;
+  stan_model model;
+  stan::test::unit::instrumented_interrupt interrupt;
+  stan::test::unit::instrumented_logger logger;
+  int num_warmup, num_samples, num_thin, refresh;
+  bool save_warmup;
+};
+
+TEST_F(ServicesUtilCheckpointer, checkpoint_every_n_iterations) {
+  std::vector<double> cont_vector(2, 0);
+  boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+  stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model,
+                                                                       rng);
+  sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+
+  stan::test::unit::instrumented_writer sample_writer, diagnostic_writer,
+      checkpoint_writer;
+  stan::services::util::checkpointer checkpointer(checkpoint_writer, 50, 0);
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, num_samples, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer,
+      checkpointer);
+
+  std::vector<std::string> checkpoints = checkpoint_writer.string_values();
+  ASSERT_EQ(6, checkpoints.size());
+  for (size_t n = 0; n < checkpoints.size(); ++n) {
+    std::stringstream checkpoint(checkpoints[n]);
+    std::string magic;
+    int version;
+    int iteration;
+    checkpoint >> magic >> version >> iteration;
+    EXPECT_EQ("stan_checkpoint", magic);
+    EXPECT_EQ(stan::services::util::checkpointer::version(), version);
+    EXPECT_EQ(50 * static_cast<int>(n + 1), iteration);
+  }
+}
+
+TEST_F(ServicesUtilCheckpointer, adaptive_resume_is_exact) {
+  stan::test::unit::instrumented_writer full_writer, full_diagnostic;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(
+        model, rng);
+    sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, full_writer,
+        full_diagnostic);
+  }
+  std::vector<std::vector<double> > full_draws
+      = full_writer.vector_double_values();
+
+  std::vector<std::string> checkpoints;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(
+        model, rng);
+    sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+    stan::test::unit::instrumented_writer sample_writer, diagnostic_writer,
+        checkpoint_writer;
+    stan::services::util::checkpointer checkpointer(checkpoint_writer, 60, 0);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, sample_writer,
+        diagnostic_writer, checkpointer);
+    checkpoints = checkpoint_writer.string_values();
+  }
+  ASSERT_EQ(5, checkpoints.size());
+
+  // resume once during warmup and once during sampling
+  for (size_t n : {1, 3}) {
+    std::stringstream header(checkpoints[n]);
+    std::string magic;
+    int version, iteration;
+    bool warmup;
+    size_t num_draws;
+    header >> magic >> version >> iteration >> warmup >> num_draws;
+    EXPECT_EQ(n < 3, warmup);
+
+    std::vector<double> cont_vector(2, 5);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(1234, 1);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(
+        model, rng);
+    sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+    stan::test::unit::instrumented_writer sample_writer, diagnostic_writer,
+        checkpoint_writer;
+    std::stringstream resume(checkpoints[n]);
+    stan::services::util::checkpointer checkpointer(checkpoint_writer, 0, 0,
+                                                    resume);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, sample_writer,
+        diagnostic_writer, checkpointer);
+
+    EXPECT_EQ(0, sample_writer.call_count("vector_string"))
+        << "header is not rewritten";
+    std::vector<std::vector<double> > draws
+        = sample_writer.vector_double_values();
+    ASSERT_EQ(full_draws.size(), num_draws + draws.size());
+    for (size_t m = 0; m < draws.size(); ++m)
+      for (size_t k = 0; k < draws[m].size(); ++k)
+        EXPECT_EQ(full_draws[num_draws + m][k], draws[m][k]);
+  }
+}
+
+namespace {
+
+std::vector<std::string> csv_lines(const std::string& csv, bool comments) {
+  std::vector<std::string> lines;
+  std::stringstream in(csv);
+  std::string line;
+  while (std::getline(in, line))
+    if ((line.compare(0, 1, "#") == 0) == comments)
+      lines.push_back(line);
+  return lines;
+}
+
+}  // namespace
+
+TEST_F(ServicesUtilCheckpointer, restore_output_counts_draw_rows) {
+  std::stringstream full_csv;
+  std::vector<std::string> checkpoints;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(
+        model, rng);
+    sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+    stan::callbacks::stream_writer sample_writer(full_csv, "# ");
+    stan::test::unit::instrumented_writer diagnostic_writer,
+        checkpoint_writer;
+    stan::services::util::mcmc_writer writer(sample_writer, diagnostic_writer,
+                                             logger);
+    stan::services::util::checkpointer checkpointer(checkpoint_writer, 60, 0);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, writer, checkpointer);
+    checkpoints = checkpoint_writer.string_values();
+  }
+  ASSERT_EQ(5, checkpoints.size());
+  std::vector<std::string> full_rows = csv_lines(full_csv.str(), false);
+  ASSERT_EQ(1 + num_warmup + num_samples, full_rows.size());
+
+  // stop twice during warmup, during sampling and after the last draw
+  for (size_t n : {1, 2, 3, 4}) {
+    size_t num_draws
+        = stan::services::util::checkpointer::num_draws(checkpoints[n]);
+    EXPECT_EQ(60 * (n + 1), num_draws);
+    std::stringstream stopped_csv(full_csv.str());
+    std::stringstream resumed_csv;
+    EXPECT_EQ(num_draws, stan::services::util::checkpointer::restore_output(
+                             stopped_csv, resumed_csv, num_draws));
+    EXPECT_EQ(num_draws + 1, csv_lines(resumed_csv.str(), false).size());
+
+    std::vector<double> cont_vector(2, 5);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(1234, 1);
+    stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(
+        model, rng);
+    sampler.set_window_params(num_warmup, 75, 50, 25, logger);
+    stan::callbacks::stream_writer sample_writer(resumed_csv, "# ");
+    stan::test::unit::instrumented_writer diagnostic_writer,
+        checkpoint_writer;
+    stan::services::util::mcmc_writer writer(sample_writer, diagnostic_writer,
+                                             logger);
+    std::stringstream resume(checkpoints[n]);
+    stan::services::util::checkpointer checkpointer(checkpoint_writer, 0, 0,
+                                                    resume);
+    stan::services::util::run_adaptive_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, writer, checkpointer);
+
+    std::vector<std::string> rows = csv_lines(resumed_csv.str(), false);
+    EXPECT_EQ(writer.num_draws_ + 1, rows.size()) << n;
+    EXPECT_EQ(full_rows, rows) << n;
+    std::vector<std::string> comments = csv_lines(resumed_csv.str(), true);
+    EXPECT_EQ(1, std::count(comments.begin(), comments.end(),
+                            "# Adaptation terminated"))
+        << n;
+  }
+}
+
+TEST_F(ServicesUtilCheckpointer, restore_output_truncated) {
+  std::stringstream stopped_csv("# config\nlp__,x\n1,2\n# note\n3,4\n");
+  std::stringstream restored;
+  EXPECT_EQ(1, stan::services::util::checkpointer::restore_output(
+                   stopped_csv, restored, 1));
+  EXPECT_EQ("# config\nlp__,x\n1,2\n", restored.str());
+  stopped_csv.clear();
+  stopped_csv.str("lp__,x\n1,2\n# note\n3,4\n# timing\n");
+  restored.str("");
+  EXPECT_EQ(2, stan::services::util::checkpointer::restore_output(
+                   stopped_csv, restored, 5));
+  EXPECT_EQ("lp__,x\n1,2\n# note\n3,4\n# timing\n", restored.str());
+}
+
+TEST_F(ServicesUtilCheckpointer, resume_is_exact) {
+  num_warmup = 0;
+  stan::test::unit::instrumented_writer full_writer, full_diagnostic;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    stan::mcmc::diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model, rng);
+    stan::services::util::run_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, full_writer,
+        full_diagnostic);
+  }
+
+  std::stringstream resume;
+  {
+    std::vector<double> cont_vector(2, 0);
+    boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+    stan::mcmc::diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model, rng);
+    stan::test::unit::instrumented_writer sample_writer, diagnostic_writer,
+        checkpoint_writer;
+    stan::services::util::checkpointer checkpointer(checkpoint_writer, 40, 0);
+    stan::services::util::run_sampler(
+        sampler, model, cont_vector, num_warmup, num_samples, num_thin,
+        refresh, save_warmup, rng, interrupt, logger, sample_writer,
+        diagnostic_writer, checkpointer);
+    resume.str(checkpoint_writer.string_values()[0]);
+  }
+
+  std::vector<double> cont_vector(2, 0);
+  boost::ecuyer1988 rng = stan::services::util::create_rng(1234, 1);
+  stan::mcmc::diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model, rng);
+  stan::test::unit::instrumented_writer sample_writer, diagnostic_writer,
+      checkpoint_writer;
+  stan::services::util::checkpointer checkpointer(checkpoint_writer, 0, 0,
+                                                  resume);
+  stan::services::util::run_sampler(sampler, model, cont_vector, num_warmup,
+                                    num_samples, num_thin, refresh,
+                                    save_warmup, rng, interrupt, logger,
+                                    sample_writer, diagnostic_writer,
+                                    checkpointer);
+
+  std::vector<std::vector<double> > full_draws
+      = full_writer.vector_double_values();
+  std::vector<std::vector<double> > draws
+      = sample_writer.vector_double_values();
+  ASSERT_EQ(60, draws.size());
+  for (size_t m = 0; m < draws.size(); ++m)
+    EXPECT_EQ(full_draws[40 + m], draws[m]);
+}
+
+TEST_F(ServicesUtilCheckpointer, malformed_checkpoint) {
+  std::vector<double> cont_vector(2, 0);
+  boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
+  stan::mcmc::adapt_diag_e_nuts<stan_model, boost::ecuyer1988> sampler(model,
+                                                                       rng);
+  stan::test::unit::instrumented_writer sample_writer, diagnostic_writer,
+      checkpoint_writer;
+  std::stringstream resume("not a checkpoint");
+  stan::services::util::checkpointer checkpointer(checkpoint_writer, 0, 0,
+                                                  resume);
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, num_samples, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, sample_writer, diagnostic_writer,
+      checkpointer);
+  EXPECT_EQ(0, sample_writer.call_count());
+  EXPECT_EQ(1, logger.find_info("Exception reading checkpoint."));
+}
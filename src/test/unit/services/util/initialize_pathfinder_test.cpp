@@ -0,0 +1,64 @@
+#include <stan/services/util/initialize_pathfinder.hpp>
+#include <gtest/gtest.h>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <sstream>
+
+class ServicesUtilInitializePathfinder : public testing::Test {
+ public:
+  ServicesUtilInitializePathfinder()
+      : model(empty_context, 12345, &model_ss),
+        rng(stan::services::util::create_rng(0, 1)) {}
+
+  stan_model model;
+  stan::io::empty_var_context empty_context;
+  std::stringstream model_ss;
+  stan::test::unit::instrumented_logger logger;
+  stan::test::unit::instrumented_writer init;
+  boost::ecuyer1988 rng;
+};
+
+TEST_F(ServicesUtilInitializePathfinder, inits_and_inv_metric) {
+  Eigen::VectorXd inv_metric;
+  std::vector<double> params = stan::services::util::initialize_pathfinder(
+      model, empty_context, rng, 2, 4, 100, 25, 100, 4, false, logger, init,
+      inv_metric);
+
+  ASSERT_EQ(model.num_params_r(), params.size());
+  // y ~ normal(0, 1) with y = -10 + 20 * inv_logit(u) gives u close
+  // to normal(0, 0.2)
+  EXPECT_NEAR(0, params[0], 1);
+  EXPECT_NEAR(0, params[1], 1);
+  ASSERT_EQ(2, inv_metric.size());
+  EXPECT_NEAR(0.04, inv_metric(0), 0.03);
+  EXPECT_NEAR(0.04, inv_metric(1), 0.03);
+
+  EXPECT_EQ(4, logger.find_info("Pathfinder path"));
+  EXPECT_EQ(1, logger.find_info("effective sample size"));
+  ASSERT_EQ(1, init.vector_double_values().size());
+  EXPECT_EQ(params, init.vector_double_values()[0]);
+}
+
+TEST_F(ServicesUtilInitializePathfinder, reproducible) {
+  Eigen::VectorXd inv_metric1, inv_metric2;
+  boost::ecuyer1988 rng2 = rng;
+  std::vector<double> params1 = stan::services::util::initialize_pathfinder(
+      model, empty_context, rng, 2, 3, 100, 10, 50, 3, false, logger, init,
+      inv_metric1);
+  std::vector<double> params2 = stan::services::util::initialize_pathfinder(
+      model, empty_context, rng2, 2, 3, 100, 10, 50, 1, false, logger, init,
+      inv_metric2);
+  EXPECT_EQ(params1, params2);
+  EXPECT_EQ(inv_metric1, inv_metric2);
+}
+
+TEST_F(ServicesUtilInitializePathfinder, no_paths) {
+  std::vector<double> params = stan::services::util::initialize_pathfinder(
+      model, empty_context, rng, 0, 0, 100, 25, 100, 1, false, logger, init);
+  ASSERT_EQ(model.num_params_r(), params.size());
+  EXPECT_FLOAT_EQ(0, params[0]);
+  EXPECT_FLOAT_EQ(0, params[1]);
+  EXPECT_EQ(0, logger.find_info("Pathfinder"));
+}
@@ -0,0 +1,114 @@
+#include <stan/services/util/progress_reporter.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+class counting_sampler : public stan::mcmc::base_mcmc {
+ public:
+  counting_sampler() : num_gradient_evals(0) {}
+
+  stan::mcmc::sample transition(stan::mcmc::sample& init_sample,
+                                stan::callbacks::logger& logger) {
+    num_gradient_evals += 10;
+    return init_sample;
+  }
+
+  void get_performance_counters(stan::mcmc::performance_counters& counters) {
+    counters.num_gradient_evals = num_gradient_evals;
+  }
+
+  size_t num_gradient_evals;
+};
+
+int run(stan::services::util::progress_reporter& progress,
+        counting_sampler& sampler, int num_iterations, int start, int finish,
+        bool warmup, int first = 0, int sleep_microseconds = 0) {
+  int num_calls = 0;
+  Eigen::VectorXd q(1);
+  stan::mcmc::sample s(q, 0, 0);
+  stan::test::unit::instrumented_logger logger;
+  progress.begin(start, finish, first);
+  for (int m = first; m < num_iterations; ++m) {
+    if (progress.due(m + 1)) {
+      ++num_calls;
+      progress(m + 1, warmup, sampler);
+    }
+    s = sampler.transition(s, logger);
+    if (sleep_microseconds > 0)
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(sleep_microseconds));
+  }
+  return num_calls;
+}
+
+}  // namespace
+
+TEST(progress_reporter, refresh_iterations) {
+  stan::test::unit::instrumented_logger logger;
+  counting_sampler sampler;
+  stan::services::util::progress_reporter progress(logger, 10);
+  EXPECT_EQ(500 / 10 + 1, run(progress, sampler, 500, 0, 1000, true))
+      << "the reporter only runs when a message is due";
+  EXPECT_EQ(500 / 10 + 1, logger.call_count_info());
+  EXPECT_EQ(1, logger.find_info("Iteration:   1 / 1000 [  0%]  (Warmup)"));
+  EXPECT_EQ(1, logger.find_info("Iteration: 500 / 1000 [ 50%]  (Warmup)"));
+
+  run(progress, sampler, 500, 500, 1000, false);
+  EXPECT_EQ(2 * (500 / 10 + 1), logger.call_count_info());
+  EXPECT_EQ(1, logger.find_info("Iteration: 1000 / 1000 [100%]  (Sampling)"));
+  EXPECT_EQ(1, logger.find_info("Iteration: 1000 / 1000 [100%]  (Sampling)  "));
+  EXPECT_EQ(2 * 50, logger.find_info("iter/s"))
+      << "rates follow the first message of each phase";
+  EXPECT_EQ(2 * 50, logger.find_info("grad/s"));
+  EXPECT_EQ(2 * 50, logger.find_info("ETA"));
+}
+
+TEST(progress_reporter, last_warmup_iteration) {
+  stan::test::unit::instrumented_logger logger;
+  counting_sampler sampler;
+  stan::services::util::progress_reporter progress(logger, 7);
+  run(progress, sampler, 500, 0, 1000, true);
+  run(progress, sampler, 500, 500, 1000, false);
+  EXPECT_EQ(1, logger.find_info("Iteration: 497 / 1000 [ 49%]  (Warmup)"));
+  EXPECT_EQ(0, logger.find_info("Iteration: 500 / 1000 [ 50%]  (Warmup)"))
+      << "only the last iteration of the run is always logged";
+  EXPECT_EQ(1, logger.find_info("Iteration: 501 / 1000 [ 50%]  (Sampling)"));
+  EXPECT_EQ(1, logger.find_info("Iteration: 1000 / 1000 [100%]  (Sampling)"));
+}
+
+TEST(progress_reporter, resume) {
+  stan::test::unit::instrumented_logger logger;
+  counting_sampler sampler;
+  stan::services::util::progress_reporter progress(logger, 100);
+  run(progress, sampler, 500, 0, 500, false, 250);
+  EXPECT_EQ(1 + 3, logger.call_count_info());
+  EXPECT_EQ(1, logger.find_info("Iteration: 251 / 500"));
+  EXPECT_EQ(1, logger.find_info("Iteration: 300 / 500"));
+  EXPECT_EQ(1, logger.find_info("Iteration: 500 / 500"));
+}
+
+TEST(progress_reporter, disabled) {
+  stan::test::unit::instrumented_logger logger;
+  counting_sampler sampler;
+  stan::services::util::progress_reporter progress(logger, 0);
+  EXPECT_FALSE(progress.enabled());
+  EXPECT_EQ(0, run(progress, sampler, 100, 0, 100, false));
+  EXPECT_EQ(0, logger.call_count());
+}
+
+TEST(progress_reporter, refresh_seconds) {
+  stan::test::unit::instrumented_logger logger;
+  counting_sampler sampler;
+  stan::services::util::progress_reporter progress(logger, 0, 0.05);
+  EXPECT_TRUE(progress.enabled());
+  int num_calls = run(progress, sampler, 200, 0, 200, false, 0, 500);
+  EXPECT_LT(num_calls, 200) << "the clock is not read every iteration";
+  EXPECT_GE(logger.call_count_info(), 3);
+  EXPECT_LT(logger.call_count_info(), 50);
+  EXPECT_EQ(1, logger.find_info("Iteration:   1 / 200"));
+  EXPECT_EQ(1, logger.find_info("Iteration: 200 / 200"));
+  EXPECT_EQ(logger.call_count_info() - 1, logger.find_info("grad/s"));
+}
@@ -1,4 +1,5 @@
 #include <stan/services/util/run_adaptive_sampler.hpp>
+#include <stan/callbacks/performance_writer.hpp>
 #include <gtest/gtest.h>
 #include <test/test-models/good/services/test_lp.hpp>
 #include <stan/io/empty_var_context.hpp>
@@ -197,3 +198,65 @@ TEST_F(ServicesUtil, num_warmup_num_samples_refresh) {
   EXPECT_EQ(num_samples, diagnostic_writer.call_count("vector_double"))
       << "draws";
 }
+
+class recording_performance_writer
+    : public stan::callbacks::performance_writer {
+ public:
+  void operator()(const std::string& phase, int iteration,
+                  const std::vector<std::string>& names,
+                  const std::vector<double>& values) {
+    phases.push_back(phase);
+    iterations.push_back(iteration);
+    this->names = names;
+    this->values.push_back(values);
+  }
+
+  double last(const std::string& name) const {
+    for (size_t n = 0; n < names.size(); ++n)
+      if (names[n] == name)
+        return values.back()[n];
+    ADD_FAILURE() << "no counter named " << name;
+    return 0;
+  }
+
+  std::vector<std::string> phases;
+  std::vector<int> iterations;
+  std::vector<std::string> names;
+  std::vector<std::vector<double>> values;
+};
+
+TEST_F(ServicesUtil, performance_counters) {
+  num_warmup = 200;
+  num_samples = 200;
+  refresh = 100;
+  recording_performance_writer performance;
+  stan::services::util::mcmc_writer writer(sample_writer, diagnostic_writer,
+                                           logger);
+  writer.set_performance_writer(performance, true);
+  stan::callbacks::writer checkpoint_writer;
+  stan::services::util::checkpointer checkpointer(checkpoint_writer, 0, 0);
+  stan::services::util::run_adaptive_sampler(
+      sampler, model, cont_vector, num_warmup, num_samples, num_thin, refresh,
+      save_warmup, rng, interrupt, logger, writer, checkpointer);
+
+  ASSERT_EQ((num_warmup + num_samples) / refresh + 2 + 2,
+            performance.phases.size())
+      << "one snapshot per progress message and one per phase";
+  EXPECT_EQ("warmup", performance.phases.front());
+  EXPECT_EQ(0, performance.iterations.front());
+  EXPECT_EQ("sampling", performance.phases.back());
+  EXPECT_EQ(num_warmup + num_samples, performance.iterations.back());
+
+  EXPECT_EQ(num_samples, performance.last("num_draws"));
+  EXPECT_GT(performance.last("num_leapfrog_steps"), num_warmup + num_samples);
+  EXPECT_GE(performance.last("num_gradient_evals"),
+            performance.last("num_leapfrog_steps"));
+  EXPECT_GE(performance.last("transition_seconds"),
+            performance.last("log_prob_seconds"));
+  EXPECT_GT(performance.last("ad_arena_bytes"), 0);
+  for (size_t n = 1; n < performance.values.size(); ++n)
+    for (size_t i = 0; i < performance.names.size(); ++i)
+      if (performance.names[i] != "integrator_seconds")
+        EXPECT_LE(performance.values[n - 1][i], performance.values[n][i])
+            << performance.names[i] << " is cumulative";
+}
@@ -0,0 +1,51 @@
+#include <stan/services/util/spsc_queue.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(ServicesUtilSpscQueue, bounded) {
+  stan::services::util::spsc_queue<int> queue(2);
+  EXPECT_EQ(2, queue.capacity());
+  EXPECT_TRUE(queue.empty());
+
+  int x = 1;
+  EXPECT_TRUE(queue.try_push(x));
+  x = 2;
+  EXPECT_TRUE(queue.try_push(x));
+  x = 3;
+  EXPECT_FALSE(queue.try_push(x));
+  EXPECT_FALSE(queue.empty());
+
+  int y = 0;
+  EXPECT_TRUE(queue.try_pop(y));
+  EXPECT_EQ(1, y);
+  EXPECT_TRUE(queue.try_push(x));
+  EXPECT_TRUE(queue.try_pop(y));
+  EXPECT_EQ(2, y);
+  EXPECT_TRUE(queue.try_pop(y));
+  EXPECT_EQ(3, y);
+  EXPECT_FALSE(queue.try_pop(y));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(ServicesUtilSpscQueue, producer_consumer_order) {
+  const int N = 100000;
+  stan::services::util::spsc_queue<std::vector<int> > queue(16);
+  std::vector<int> received;
+  std::thread consumer([&]() {
+    std::vector<int> x;
+    for (int n = 0; n < N; ++n) {
+      queue.pop(x);
+      received.push_back(x[0]);
+    }
+  });
+  for (int n = 0; n < N; ++n) {
+    std::vector<int> x(1, n);
+    queue.push(x);
+  }
+  consumer.join();
+
+  ASSERT_EQ(N, received.size());
+  for (int n = 0; n < N; ++n)
+    EXPECT_EQ(n, received[n]);
+}
@@ -0,0 +1,33 @@
+#include <stan/services/util/write_profile.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(ServicesUtil, write_profile) {
+  stan::model::statement_profiler& profiler
+      = stan::model::statement_profiler::instance();
+  profiler.reset();
+  profiler.add_forward(12, 0.5);
+  profiler.add_forward(3, 0.25);
+  profiler.add_forward(12, 0.5);
+  profiler.add_reverse(12, 2);
+
+  stan::test::unit::instrumented_writer writer;
+  stan::services::util::write_profile(writer);
+
+  std::vector<std::vector<std::string>> names = writer.vector_string_values();
+  ASSERT_EQ(1U, names.size());
+  ASSERT_EQ(4U, names[0].size());
+  EXPECT_EQ("line", names[0][0]);
+  EXPECT_EQ("count", names[0][1]);
+  EXPECT_EQ("forward_seconds", names[0][2]);
+  EXPECT_EQ("reverse_seconds", names[0][3]);
+
+  std::vector<std::vector<double>> values = writer.vector_double_values();
+  ASSERT_EQ(2U, values.size());
+  EXPECT_EQ(std::vector<double>({3, 1, 0.25, 0}), values[0]);
+  EXPECT_EQ(std::vector<double>({12, 2, 1, 2}), values[1]);
+  profiler.reset();
+}